@@ -0,0 +1,35 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+
+/* Results are printed as CSV:
+ * benchmark,variant,element_bytes,elements,ns_per_op */
+
+static void bench_header(void)
+{
+	(void)printf("benchmark,variant,element_bytes,elements,ns_per_op\n");
+}
+
+static void bench_report_seconds(const char *benchmark, const char *variant,
+				 size_t element_bytes, size_t elements,
+				 double seconds, size_t ops)
+{
+	(void)printf("%s,%s,%lu,%lu,%.3f\n", benchmark, variant,
+		     (unsigned long)element_bytes, (unsigned long)elements,
+		     seconds * 1e9 / (double)ops);
+}
+
+/* Same as bench_report_seconds, for a measure taken with clock(3) */
+#define bench_report(Benchmark_, Variant_, Element_Bytes_, Elements_, Start_, \
+		     Stop_, Ops_)                                             \
+	bench_report_seconds((Benchmark_), (Variant_), (Element_Bytes_),      \
+			     (Elements_),                                     \
+			     (double)((Stop_) - (Start_)) / CLOCKS_PER_SEC,   \
+			     (Ops_))
+
+/* Prevents the optimizer from discarding a computed result */
+static volatile long bench_sink;
+
+#endif /* BENCH_H */
@@ -0,0 +1,114 @@
+#include "bench.h"
+#include "vector_generated.h"
+
+#if defined(BENCH_INLINE)
+#define MODE "inline"
+#elif VECTOR_NO_CHECKS
+#define MODE "no_checks"
+#else
+#define MODE "checks"
+#endif
+
+enum { ELEMENTS = 1 << 20, ROUNDS = 64 };
+
+static void bench_get(Vector *vec)
+{
+	clock_t start = 0;
+	size_t round = 0;
+	size_t idx = 0;
+	long sum = 0;
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (idx = 0; idx < VECTOR_SIZE(vec); idx++) {
+			sum += vector_get(vec, idx);
+		}
+	}
+	bench_report("get", MODE, sizeof(int), ELEMENTS, start, clock(),
+		     (size_t)ELEMENTS * ROUNDS);
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (idx = 0; idx < VECTOR_SIZE(vec); idx++) {
+			sum += vector_get_unchecked(vec, idx);
+		}
+	}
+	bench_report("get", MODE "_unchecked", sizeof(int), ELEMENTS,
+		     start, clock(), (size_t)ELEMENTS * ROUNDS);
+
+	bench_sink = sum;
+}
+
+static void bench_set(Vector *vec)
+{
+	clock_t start = 0;
+	size_t round = 0;
+	size_t idx = 0;
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (idx = 0; idx < VECTOR_SIZE(vec); idx++) {
+			vector_set(vec, idx, (int)(idx + round));
+		}
+	}
+	bench_report("set", MODE, sizeof(int), ELEMENTS, start, clock(),
+		     (size_t)ELEMENTS * ROUNDS);
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		for (idx = 0; idx < VECTOR_SIZE(vec); idx++) {
+			vector_set_unchecked(vec, idx, (int)(idx + round));
+		}
+	}
+	bench_report("set", MODE "_unchecked", sizeof(int), ELEMENTS,
+		     start, clock(), (size_t)ELEMENTS * ROUNDS);
+
+	bench_sink = vec->begin[ELEMENTS / 2];
+}
+
+static void bench_push(void)
+{
+	Vector vec = { 0 };
+	clock_t start = 0;
+	size_t round = 0;
+	int idx = 0;
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		vector_clear(&vec);
+		for (idx = 0; idx < ELEMENTS; idx++) {
+			vector_push(&vec, idx);
+		}
+	}
+	bench_report("push", MODE, sizeof(int), ELEMENTS, start, clock(),
+		     (size_t)ELEMENTS * ROUNDS);
+
+	start = clock();
+	for (round = 0; round < ROUNDS; round++) {
+		vector_clear(&vec);
+		for (idx = 0; idx < ELEMENTS; idx++) {
+			vector_push_unchecked(&vec, idx);
+		}
+	}
+	bench_report("push", MODE "_unchecked", sizeof(int), ELEMENTS,
+		     start, clock(), (size_t)ELEMENTS * ROUNDS);
+
+	bench_sink = vec.end[-1];
+	vector_free(&vec);
+}
+
+int main(void)
+{
+	Vector vec = { 0 };
+
+	vector_resize(&vec, ELEMENTS);
+	memset(vec.begin, 0, ELEMENTS * sizeof(int));
+
+	bench_header();
+	bench_get(&vec);
+	bench_set(&vec);
+	bench_push();
+
+	vector_free(&vec);
+	return 0;
+}
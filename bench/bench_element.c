@@ -0,0 +1,3 @@
+#include "bench_element.h"
+
+VECTOR_DEFINE(ElementVector, element_vector, Element)
@@ -0,0 +1,17 @@
+#ifndef BENCH_ELEMENT_H
+#define BENCH_ELEMENT_H
+
+#include "vector.h"
+
+/* Element of BENCH_ELEMENT_WORDS longs, words[0] being its key */
+#ifndef BENCH_ELEMENT_WORDS
+#define BENCH_ELEMENT_WORDS 1
+#endif
+
+typedef struct Element {
+	long words[BENCH_ELEMENT_WORDS];
+} Element;
+
+VECTOR_DECLARE(ElementVector, element_vector, Element)
+
+#endif /* BENCH_ELEMENT_H */
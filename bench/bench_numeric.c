@@ -0,0 +1,143 @@
+#include "bench.h"
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_NUMERIC(Vector, vector, int)
+VECTOR_DECLARE(DoubleVector, double_vector, double)
+VECTOR_DECLARE_NUMERIC(DoubleVector, double_vector, double)
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_NUMERIC(Vector, vector, int, VECTOR_I32)
+VECTOR_DEFINE(DoubleVector, double_vector, double)
+VECTOR_DEFINE_NUMERIC(DoubleVector, double_vector, double, VECTOR_F64)
+
+/* Every size scans about as many elements in total */
+enum { SCANNED = 1 << 28 };
+
+static const char *const variants[] = { "simd_level_0", "simd_level_1",
+					"simd_level_2" };
+
+/* Hand-written loops, as in user code */
+static void bench_loops(const Vector *ints, const DoubleVector *doubles)
+{
+	size_t elements = VECTOR_SIZE(ints);
+	size_t rounds = SCANNED / elements;
+	size_t round = 0;
+	const int *i = NULL;
+	const double *d = NULL;
+	const double *e = NULL;
+	size_t count = 0;
+	double sum = 0;
+	clock_t start = 0;
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		i = ints->begin;
+		while (i < ints->end && *i != -1) {
+			i++;
+		}
+		count += (size_t)(i - ints->begin);
+	}
+	bench_report("find", "loop", sizeof(int), elements, start, clock(),
+		     rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (i = ints->begin; i < ints->end; i++) {
+			count += *i == 7;
+		}
+	}
+	bench_report("count", "loop", sizeof(int), elements, start, clock(),
+		     rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (d = doubles->begin; d < doubles->end; d++) {
+			sum += *d;
+		}
+	}
+	bench_report("sum", "loop", sizeof(double), elements, start, clock(),
+		     rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (d = doubles->begin, e = doubles->begin; d < doubles->end;
+		     d++, e++) {
+			sum += *d * *e;
+		}
+	}
+	bench_report("dot", "loop", sizeof(double), elements, start, clock(),
+		     rounds * elements);
+	bench_sink = (long)count + (long)sum;
+}
+
+static void bench_kernels(const Vector *ints, const DoubleVector *doubles,
+			  int level)
+{
+	size_t elements = VECTOR_SIZE(ints);
+	size_t rounds = SCANNED / elements;
+	size_t round = 0;
+	size_t count = 0;
+	double sum = 0;
+	clock_t start = 0;
+
+	vector_core_simd_level = level;
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		count += vector_find(ints, -1);
+	}
+	bench_report("find", variants[level], sizeof(int), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		count += vector_count(ints, 7);
+	}
+	bench_report("count", variants[level], sizeof(int), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		sum += double_vector_sum(doubles);
+	}
+	bench_report("sum", variants[level], sizeof(double), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		sum += double_vector_dot(doubles, doubles);
+	}
+	bench_report("dot", variants[level], sizeof(double), elements, start,
+		     clock(), rounds * elements);
+	bench_sink = (long)count + (long)sum;
+}
+
+int main(void)
+{
+	static const size_t sizes[] = { 1024, 65536, 1048576 };
+	Vector ints = { 0 };
+	DoubleVector doubles = { 0 };
+	size_t size = 0;
+	size_t idx = 0;
+	int level = 0;
+
+	bench_header();
+	for (size = 0; size < sizeof(sizes) / sizeof(sizes[0]); size++) {
+		vector_resize(&ints, sizes[size]);
+		double_vector_resize(&doubles, sizes[size]);
+		for (idx = 0; idx < sizes[size]; idx++) {
+			ints.begin[idx] = (int)(idx % 1000);
+			doubles.begin[idx] = (double)(idx % 1000) * 0.5;
+		}
+
+		bench_loops(&ints, &doubles);
+		for (level = 0; level <= 2; level++) {
+			bench_kernels(&ints, &doubles, level);
+		}
+	}
+
+	vector_free(&ints);
+	double_vector_free(&doubles);
+	return 0;
+}
@@ -0,0 +1,307 @@
+#include "bench.h"
+#include "bench_element.h"
+
+#ifdef BENCH_STB_DS
+#define STB_DS_IMPLEMENTATION
+#include "stb_ds.h"
+#endif
+
+/* Every benchmark runs about TOTAL_OPS element operations, whatever the
+ * vector length, except insertions and deletions at the front which run
+ * between MIN_EDITS and TOTAL_OPS / elements of them */
+enum { TOTAL_OPS = 1 << 22, MIN_EDITS = 4 };
+
+static const size_t lengths[] = { 1 << 10, 1 << 16, 1 << 20 };
+
+static size_t rounds_for(size_t elements)
+{
+	return elements >= TOTAL_OPS ? 1 : TOTAL_OPS / elements;
+}
+
+static size_t edits_for(size_t elements)
+{
+	return elements >= TOTAL_OPS / MIN_EDITS ? MIN_EDITS
+						 : TOTAL_OPS / elements;
+}
+
+static Element make_element(size_t idx)
+{
+	Element element;
+
+	memset(&element, 0, sizeof(element));
+	element.words[0] = (long)idx;
+	return element;
+}
+
+/* Same pseudo-random sequence for every variant */
+static size_t *random_indices(size_t elements)
+{
+	size_t *indices = malloc(elements * sizeof(size_t));
+	unsigned long state = 12345;
+	size_t idx = 0;
+
+	if (indices == NULL) {
+		abort();
+	}
+
+	for (idx = 0; idx < elements; idx++) {
+		state = state * 1103515245UL + 12345UL;
+		indices[idx] = (size_t)((state >> 8) % elements);
+	}
+	return indices;
+}
+
+static void bench_vector(size_t elements, const size_t *indices)
+{
+	ElementVector vec = { 0 };
+	ElementVector copy = { 0 };
+	size_t rounds = rounds_for(elements);
+	size_t edits = edits_for(elements);
+	clock_t start = 0;
+	size_t round = 0;
+	size_t idx = 0;
+	long sum = 0;
+	Element *ptr = NULL;
+	Element element;
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		element_vector_free(&vec);
+		for (idx = 0; idx < elements; idx++) {
+			element_vector_push(&vec, make_element(idx));
+		}
+	}
+	bench_report("push", "vector_h", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (idx = 0; idx < elements; idx++) {
+			element = element_vector_get(&vec, indices[idx]);
+			sum += element.words[0];
+		}
+	}
+	bench_report("random_get", "vector_h", sizeof(Element), elements,
+		     start, clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (ptr = vec.begin; ptr < vec.end; ptr++) {
+			sum += ptr->words[0];
+		}
+	}
+	bench_report("iterate", "vector_h", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		element_vector_duplicate(&copy, &vec);
+		sum += copy.begin[0].words[0];
+		element_vector_free(&copy);
+	}
+	bench_report("duplicate", "vector_h", sizeof(Element), elements,
+		     start, clock(), rounds * elements);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		element_vector_insert(&vec, 0, make_element(idx));
+	}
+	bench_report("insert_front", "vector_h", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		element_vector_delete(&vec, 0);
+	}
+	bench_report("delete_front", "vector_h", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	bench_sink = sum;
+	element_vector_free(&vec);
+}
+
+/* Hand-written growable array, the baseline every library is compared to */
+static Element *array_push(Element *array, size_t *size, size_t *capacity,
+			   Element element)
+{
+	if (*size == *capacity) {
+		*capacity = *capacity ? *capacity * 2 : 8;
+		array = realloc(array, *capacity * sizeof(Element));
+		if (array == NULL) {
+			abort();
+		}
+	}
+	array[(*size)++] = element;
+	return array;
+}
+
+static void bench_array(size_t elements, const size_t *indices)
+{
+	Element *array = NULL;
+	Element *copy = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
+	size_t rounds = rounds_for(elements);
+	size_t edits = edits_for(elements);
+	clock_t start = 0;
+	size_t round = 0;
+	size_t idx = 0;
+	long sum = 0;
+	Element *ptr = NULL;
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		free(array);
+		array = NULL;
+		size = 0;
+		capacity = 0;
+		for (idx = 0; idx < elements; idx++) {
+			array = array_push(array, &size, &capacity,
+					   make_element(idx));
+		}
+	}
+	bench_report("push", "array", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (idx = 0; idx < elements; idx++) {
+			sum += array[indices[idx]].words[0];
+		}
+	}
+	bench_report("random_get", "array", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (ptr = array; ptr < array + size; ptr++) {
+			sum += ptr->words[0];
+		}
+	}
+	bench_report("iterate", "array", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		copy = malloc(capacity * sizeof(Element));
+		if (copy == NULL) {
+			abort();
+		}
+		memcpy(copy, array, size * sizeof(Element));
+		sum += copy[0].words[0];
+		free(copy);
+	}
+	bench_report("duplicate", "array", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		array = array_push(array, &size, &capacity, make_element(idx));
+		memmove(array + 1, array, (size - 1) * sizeof(Element));
+		array[0] = make_element(idx);
+	}
+	bench_report("insert_front", "array", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		size--;
+		memmove(array, array + 1, size * sizeof(Element));
+	}
+	bench_report("delete_front", "array", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	bench_sink = sum;
+	free(array);
+}
+
+#ifdef BENCH_STB_DS
+static void bench_stb_ds(size_t elements, const size_t *indices)
+{
+	Element *array = NULL;
+	Element *copy = NULL;
+	size_t rounds = rounds_for(elements);
+	size_t edits = edits_for(elements);
+	clock_t start = 0;
+	size_t round = 0;
+	size_t idx = 0;
+	long sum = 0;
+	Element *ptr = NULL;
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		arrfree(array);
+		for (idx = 0; idx < elements; idx++) {
+			arrput(array, make_element(idx));
+		}
+	}
+	bench_report("push", "stb_ds", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (idx = 0; idx < elements; idx++) {
+			sum += array[indices[idx]].words[0];
+		}
+	}
+	bench_report("random_get", "stb_ds", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		for (ptr = array; ptr < array + arrlen(array); ptr++) {
+			sum += ptr->words[0];
+		}
+	}
+	bench_report("iterate", "stb_ds", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (round = 0; round < rounds; round++) {
+		arrsetcap(copy, arrcap(array));
+		arrsetlen(copy, arrlen(array));
+		memcpy(copy, array, arrlen(array) * sizeof(Element));
+		sum += copy[0].words[0];
+		arrfree(copy);
+	}
+	bench_report("duplicate", "stb_ds", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		arrins(array, 0, make_element(idx));
+	}
+	bench_report("insert_front", "stb_ds", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	start = clock();
+	for (idx = 0; idx < edits; idx++) {
+		arrdel(array, 0);
+	}
+	bench_report("delete_front", "stb_ds", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	bench_sink = sum;
+	arrfree(array);
+}
+#endif
+
+int main(void)
+{
+	size_t *indices = NULL;
+	size_t length = 0;
+
+	bench_header();
+	for (length = 0; length < sizeof(lengths) / sizeof(lengths[0]);
+	     length++) {
+		indices = random_indices(lengths[length]);
+		bench_vector(lengths[length], indices);
+		bench_array(lengths[length], indices);
+#ifdef BENCH_STB_DS
+		bench_stb_ds(lengths[length], indices);
+#endif
+		free(indices);
+	}
+
+	return 0;
+}
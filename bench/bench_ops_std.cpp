@@ -0,0 +1,122 @@
+#include <vector>
+
+#include "bench.h"
+
+/* Same element as bench_element.h, without generating a C vector */
+#ifndef BENCH_ELEMENT_WORDS
+#define BENCH_ELEMENT_WORDS 1
+#endif
+
+struct Element {
+	long words[BENCH_ELEMENT_WORDS];
+};
+
+/* Mirrors bench_ops.c, see there for the operation counts */
+enum { TOTAL_OPS = 1 << 22, MIN_EDITS = 4 };
+
+static const size_t lengths[] = { 1 << 10, 1 << 16, 1 << 20 };
+
+static size_t rounds_for(size_t elements)
+{
+	return elements >= TOTAL_OPS ? 1 : TOTAL_OPS / elements;
+}
+
+static size_t edits_for(size_t elements)
+{
+	return elements >= TOTAL_OPS / MIN_EDITS ? MIN_EDITS
+						 : TOTAL_OPS / elements;
+}
+
+static Element make_element(size_t idx)
+{
+	Element element = Element();
+
+	element.words[0] = (long)idx;
+	return element;
+}
+
+static std::vector<size_t> random_indices(size_t elements)
+{
+	std::vector<size_t> indices(elements);
+	unsigned long state = 12345;
+
+	for (size_t idx = 0; idx < elements; idx++) {
+		state = state * 1103515245UL + 12345UL;
+		indices[idx] = (size_t)((state >> 8) % elements);
+	}
+	return indices;
+}
+
+static void bench_std_vector(size_t elements,
+			     const std::vector<size_t> &indices)
+{
+	std::vector<Element> vec;
+	size_t rounds = rounds_for(elements);
+	size_t edits = edits_for(elements);
+	clock_t start = 0;
+	long sum = 0;
+
+	start = clock();
+	for (size_t round = 0; round < rounds; round++) {
+		std::vector<Element>().swap(vec);
+		for (size_t idx = 0; idx < elements; idx++) {
+			vec.push_back(make_element(idx));
+		}
+	}
+	bench_report("push", "std_vector", sizeof(Element), elements, start,
+		     clock(), rounds * elements);
+
+	start = clock();
+	for (size_t round = 0; round < rounds; round++) {
+		for (size_t idx = 0; idx < elements; idx++) {
+			sum += vec[indices[idx]].words[0];
+		}
+	}
+	bench_report("random_get", "std_vector", sizeof(Element), elements,
+		     start, clock(), rounds * elements);
+
+	start = clock();
+	for (size_t round = 0; round < rounds; round++) {
+		for (std::vector<Element>::const_iterator it = vec.begin();
+		     it != vec.end(); ++it) {
+			sum += it->words[0];
+		}
+	}
+	bench_report("iterate", "std_vector", sizeof(Element), elements,
+		     start, clock(), rounds * elements);
+
+	start = clock();
+	for (size_t round = 0; round < rounds; round++) {
+		std::vector<Element> copy(vec);
+		sum += copy[0].words[0];
+	}
+	bench_report("duplicate", "std_vector", sizeof(Element), elements,
+		     start, clock(), rounds * elements);
+
+	start = clock();
+	for (size_t idx = 0; idx < edits; idx++) {
+		vec.insert(vec.begin(), make_element(idx));
+	}
+	bench_report("insert_front", "std_vector", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	start = clock();
+	for (size_t idx = 0; idx < edits; idx++) {
+		vec.erase(vec.begin());
+	}
+	bench_report("delete_front", "std_vector", sizeof(Element), elements,
+		     start, clock(), edits);
+
+	bench_sink = sum;
+}
+
+int main()
+{
+	bench_header();
+	for (size_t length = 0; length < sizeof(lengths) / sizeof(lengths[0]);
+	     length++) {
+		bench_std_vector(lengths[length], random_indices(lengths[length]));
+	}
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#define VECTOR_PARALLEL 1
+#include "bench.h"
+#include "vector.h"
+
+#define INT_LESS(a, b) ((a) < (b))
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SORT(Vector, vector)
+VECTOR_DECLARE_PARALLEL(Vector, vector, int)
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SORT(Vector, vector, int, INT_LESS)
+VECTOR_DEFINE_PARALLEL(Vector, vector, int)
+
+enum { ELEMENTS = 1 << 24 };
+
+/* Processor time adds up over threads, so parallel runs are measured on the
+ * monotonic clock */
+static void wall_clock(struct timespec *now)
+{
+	(void)clock_gettime(CLOCK_MONOTONIC, now);
+}
+
+static double seconds_since(const struct timespec *start)
+{
+	struct timespec stop;
+
+	wall_clock(&stop);
+	return (double)(stop.tv_sec - start->tv_sec)
+	       + (double)(stop.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static void fill_random(Vector *vec)
+{
+	unsigned long state = 12345;
+	size_t idx = 0;
+
+	for (idx = 0; idx < VECTOR_SIZE(vec); idx++) {
+		state = state * 1103515245UL + 12345UL;
+		vec->begin[idx] = (int)((state >> 8) & 0x7fffffffUL);
+	}
+}
+
+static void bench_sort(Vector *vec, Vector *scratch, size_t threads)
+{
+	char variant[32];
+	struct timespec start;
+
+	(void)sprintf(variant, "parallel_%lu_threads", (unsigned long)threads);
+	vector_core_parallel_set_threads(threads);
+
+	/* Starts the pool outside of the measure */
+	fill_random(vec);
+	vector_parallel_sort(vec);
+
+	fill_random(vec);
+	wall_clock(&start);
+	vector_span_parallel_sort(vector_span(vec), vector_span(scratch));
+	bench_report_seconds("sort", variant, sizeof(int), ELEMENTS,
+			     seconds_since(&start), ELEMENTS);
+	bench_sink = vec->begin[ELEMENTS / 2];
+}
+
+static void bench_duplicate(const Vector *vec, size_t threads)
+{
+	Vector copy = { 0 };
+	char variant[32];
+	struct timespec start;
+
+	(void)sprintf(variant, "parallel_%lu_threads", (unsigned long)threads);
+	vector_core_parallel_set_threads(threads);
+
+	vector_parallel_duplicate(&copy, vec, 1);
+	vector_free(&copy);
+
+	wall_clock(&start);
+	vector_parallel_duplicate(&copy, vec, 1);
+	bench_report_seconds("duplicate", variant, sizeof(int), ELEMENTS,
+			     seconds_since(&start), ELEMENTS);
+	bench_sink = copy.begin[ELEMENTS / 2];
+	vector_free(&copy);
+}
+
+int main(void)
+{
+	Vector vec = { 0 };
+	Vector scratch = { 0 };
+	Vector copy = { 0 };
+	size_t online = 0;
+	size_t threads = 0;
+	struct timespec start;
+
+	vector_resize(&vec, ELEMENTS);
+	vector_resize(&scratch, ELEMENTS);
+
+	bench_header();
+	fill_random(&vec);
+	wall_clock(&start);
+	vector_sort(&vec);
+	bench_report_seconds("sort", "serial", sizeof(int), ELEMENTS,
+			     seconds_since(&start), ELEMENTS);
+
+	vector_core_parallel_set_threads(0);
+	online = vector_core_parallel_threads();
+	for (threads = 1; threads < online; threads *= 2) {
+		bench_sort(&vec, &scratch, threads);
+	}
+	bench_sort(&vec, &scratch, online);
+
+	wall_clock(&start);
+	vector_duplicate(&copy, &vec);
+	bench_report_seconds("duplicate", "serial", sizeof(int), ELEMENTS,
+			     seconds_since(&start), ELEMENTS);
+	vector_free(&copy);
+	for (threads = 1; threads < online; threads *= 2) {
+		bench_duplicate(&vec, threads);
+	}
+	bench_duplicate(&vec, online);
+
+	vector_core_parallel_shutdown();
+	vector_free(&vec);
+	vector_free(&scratch);
+	return 0;
+}
@@ -0,0 +1,5 @@
+#include "vector_generated.h"
+
+#ifndef BENCH_INLINE
+VECTOR_DEFINE(Vector, vector, int)
+#endif
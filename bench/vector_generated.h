@@ -0,0 +1,12 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#include "vector.h"
+
+#ifdef BENCH_INLINE
+VECTOR_DEFINE_INLINE(Vector, vector, int)
+#else
+VECTOR_DECLARE(Vector, vector, int)
+#endif
+
+#endif /* VECTOR_GENERATED_H */
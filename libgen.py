@@ -2,6 +2,23 @@
 
 import re
 
+# A generated section is delimited by the following comments in vector.in.h:
+#
+#   /* Macro NAME(Param_=Sample, ...) start here */
+#   ...
+#   /* Macro NAME stop here */
+#
+# Every occurrence of a sample identifier is replaced by its macro parameter.
+# Identifiers that only start with a sample (e.g. vector_push) are token pasted
+# (Functions_Prefix_##_push).
+SECTION_START = re.compile(r"/\* Macro (\w+)\(([^)]*)\) start here \*/")
+SECTION_STOP = re.compile(r"/\* Macro (\w+) stop here \*/")
+
+# Shared, non-generated identifiers that must never be substituted even though
+# they start with a sample name.
+SHARED_PREFIXES = ("vector_core_", "VectorCore")
+
+
 def read_file(filename):
     """Read the input C file"""
     with open(filename, 'r') as f:
@@ -14,20 +31,50 @@ def write_file(filename, lines):
         f.writelines(lines)
 
 
-def transform_line(line):
+def parse_params(params):
+    """Parse 'Param_=Sample, ...' into a list of (param, sample) pairs"""
+    pairs = []
+    for param in params.split(','):
+        param = param.strip()
+        if not param:
+            continue
+        name, sample = param.split('=')
+        pairs.append((name.strip(), sample.strip()))
+    return pairs
+
+
+def build_pattern(pairs):
+    samples = sorted((sample for _, sample in pairs), key=len, reverse=True)
+    if not samples:
+        return None
+    return re.compile(r"\b(" + "|".join(map(re.escape, samples)) + r")(\w*)")
+
+
+def transform_line(line, pairs, pattern):
     new_line = line.rstrip('\n') + "\\\n"
-    new_line = new_line.replace("VECTOR_DEFINE_PANIC(vector)", "VECTOR_DEFINE_PANIC(Functions_Prefix_)")
+    if pattern is None:
+        return new_line
+
+    params = {sample: name for name, sample in pairs}
+
+    def substitute_code(match):
+        if match.group(0).startswith(SHARED_PREFIXES):
+            return match.group(0)
+        name = params[match.group(1)]
+        if match.group(2):
+            return name + "##" + match.group(2)
+        return name
+
+    def substitute_string(match):
+        return "\"#" + params[match.group(1)] + "\"" + match.group(2)
+
     tokenized = tokenize_code_line(new_line)
     new_tokenized = []
     for token in tokenized:
         if token.startswith('"'):
-            token = token.replace("Vector", "\"#Struct_Name_\"")
-            token = token.replace("vector", "\"#Functions_Prefix_\"")
-            token = token.replace("SampleType", "\"#Custom_Type_\"")
+            token = pattern.sub(substitute_string, token)
         else:
-            token = token.replace("Vector", "Struct_Name_")
-            token = token.replace("vector", "Functions_Prefix_##")
-            token = token.replace("SampleType", "Custom_Type_")
+            token = pattern.sub(substitute_code, token)
         new_tokenized.append(token)
 
     return "".join(new_tokenized)
@@ -36,35 +83,35 @@ def transform_line(line):
 def main():
     lines = read_file("vector.in.h")
     result = []
-    in_macro = False
-    for i, line in enumerate(lines):
-        if "typedef int SampleType;" in line:
+    section = None
+    in_samples = False
+    for line in lines:
+        if "/* Samples start here */" in line:
+            in_samples = True
             continue
-        if "/* Declarations start here */" in line:
-            in_macro = True
-            result.append("""#define VECTOR_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Type_)\\
-""")
+        if "/* Samples stop here */" in line:
+            in_samples = False
             continue
-        elif "/* Declarations stop here */" in line:
-            in_macro = False
-            last_value = result.pop()
-            last_value = last_value[:-2] + last_value[-1]
-            result.append(last_value)
+        if in_samples:
             continue
-        elif "/* Definitions start here */" in line:
-            in_macro = True
-            result.append("""#define VECTOR_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Type_)\\
-""")
+
+        start = SECTION_START.search(line)
+        stop = SECTION_STOP.search(line)
+        if start:
+            pairs = parse_params(start.group(2))
+            section = (pairs, build_pattern(pairs))
+            result.append("#define %s(%s)\\\n" % (
+                start.group(1), ", ".join(name for name, _ in pairs)))
             continue
-        elif "/* Definitions stop here */" in line:
-            in_macro = False
+        elif stop:
+            section = None
             last_value = result.pop()
             last_value = last_value[:-2] + last_value[-1]
             result.append(last_value)
             continue
 
-        if in_macro:
-            result.append(transform_line(line))
+        if section:
+            result.append(transform_line(line, *section))
         else:
             result.append(line)
 
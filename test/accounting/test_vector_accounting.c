@@ -0,0 +1,193 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+static size_t slack_total(const VectorCoreAccountStats *stats)
+{
+	size_t total = 0;
+	size_t bucket = 0;
+
+	for (bucket = 0; bucket < VECTOR_ACCOUNT_BUCKETS; bucket++) {
+		total += stats->slack[bucket];
+	}
+	return total;
+}
+
+static void assert_released(const VectorCoreAccountStats *stats)
+{
+	TEST_ASSERT_EQUAL_UINT(0, stats->live);
+	TEST_ASSERT_EQUAL_UINT(0, stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, stats->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, slack_total(stats));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+	assert_released(vector_account_stats());
+	assert_released(point_vector_account_stats());
+}
+
+void test_init_and_free(void)
+{
+	const VectorCoreAccountStats *stats = vector_account_stats();
+	Vector vec = { 0 };
+
+	vector_init(&vec, 10);
+
+	TEST_ASSERT_EQUAL_STRING("Vector", stats->type_name);
+	TEST_ASSERT_EQUAL_UINT(1, stats->live);
+	TEST_ASSERT_EQUAL_UINT(10 * sizeof(int), stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, stats->size_bytes);
+	/* 40 bytes of slack fall in [32, 64) */
+	TEST_ASSERT_EQUAL_UINT(1, stats->slack[6]);
+	TEST_ASSERT_EQUAL_UINT(1, slack_total(stats));
+
+	vector_free(&vec);
+}
+
+void test_size_changes(void)
+{
+	const VectorCoreAccountStats *stats = vector_account_stats();
+	Vector vec = { 0 };
+	size_t i = 0;
+
+	for (i = 0; i < VECTOR_DEFAULT_CAPACITY; i++) {
+		vector_push(&vec, (int)i);
+	}
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY * sizeof(int),
+			       stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(stats->capacity_bytes, stats->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(1, stats->slack[0]);
+
+	vector_push(&vec, 0);
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY * VECTOR_GROWTH_FACTOR
+				       * sizeof(int),
+			       stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT((VECTOR_DEFAULT_CAPACITY + 1) * sizeof(int),
+			       stats->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, stats->slack[0]);
+	TEST_ASSERT_EQUAL_UINT(1, slack_total(stats));
+
+	(void)vector_pop(&vec);
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY * sizeof(int),
+			       stats->size_bytes);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_try_push(&vec, 0));
+	vector_push_unchecked(&vec, 0);
+	TEST_ASSERT_EQUAL_UINT((VECTOR_DEFAULT_CAPACITY + 2) * sizeof(int),
+			       stats->size_bytes);
+
+	vector_resize(&vec, 3);
+	TEST_ASSERT_EQUAL_UINT(3 * sizeof(int), stats->size_bytes);
+
+	vector_clear(&vec);
+	TEST_ASSERT_EQUAL_UINT(0, stats->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(1, stats->live);
+
+	vector_free(&vec);
+}
+
+void test_edit_and_duplicate(void)
+{
+	const VectorCoreAccountStats *stats = vector_account_stats();
+	Vector vec = { 0 };
+	Vector copy = { 0 };
+
+	vector_insert(&vec, 0, 1);
+	vector_insert(&vec, 0, 2);
+	vector_delete(&vec, 0);
+	TEST_ASSERT_EQUAL_UINT(sizeof(int), stats->size_bytes);
+	TEST_ASSERT_EQUAL_INT(1, vector_try_insert(&vec, 1, 3));
+	TEST_ASSERT_EQUAL_UINT(2 * sizeof(int), stats->size_bytes);
+
+	vector_duplicate(&copy, &vec);
+	TEST_ASSERT_EQUAL_UINT(2, stats->live);
+	TEST_ASSERT_EQUAL_UINT(4 * sizeof(int), stats->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(2 * VECTOR_CAPACITY(&vec) * sizeof(int),
+			       stats->capacity_bytes);
+
+	vector_free(&vec);
+	vector_free(&copy);
+}
+
+void test_types_accounted_separately(void)
+{
+	const VectorCoreAccountStats *stats = NULL;
+	PointVector points = { 0 };
+	Point point = { 1, 2 };
+	int seen = 0;
+
+	point_vector_push(&points, point);
+
+	TEST_ASSERT_EQUAL_UINT(1, point_vector_account_stats()->live);
+	TEST_ASSERT_EQUAL_UINT(sizeof(Point),
+			       point_vector_account_stats()->size_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, vector_account_stats()->live);
+
+	for (stats = vector_core_account_registry; stats; stats = stats->next) {
+		seen += stats == point_vector_account_stats();
+	}
+	TEST_ASSERT_EQUAL_INT(1, seen);
+
+	point_vector_free(&points);
+}
+
+void test_print(void)
+{
+	Vector vec = { 0 };
+	FILE *stream = tmpfile();
+	char line[256] = { 0 };
+	unsigned long live = 0;
+	unsigned long capacity_bytes = 0;
+	unsigned long size_bytes = 0;
+	unsigned long slack_bytes = 0;
+	int found = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+
+	vector_init(&vec, 4);
+	vector_push(&vec, 1);
+	vector_core_account_print(stream);
+	vector_free(&vec);
+
+	rewind(stream);
+	while (fgets(line, sizeof(line), stream)) {
+		if (strncmp(line, "Vector: ", 8) != 0) {
+			continue;
+		}
+		found = 1;
+		TEST_ASSERT_EQUAL_INT(
+			4, sscanf(line,
+				  "Vector: %lu live, %lu capacity bytes, "
+				  "%lu size bytes, %lu slack bytes",
+				  &live, &capacity_bytes, &size_bytes,
+				  &slack_bytes));
+		TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), stream));
+		TEST_ASSERT_EQUAL_STRING("  slack [8, 16) bytes: 1\n", line);
+	}
+	TEST_ASSERT_TRUE(found);
+	TEST_ASSERT_EQUAL_UINT(1, live);
+	TEST_ASSERT_EQUAL_UINT(4 * sizeof(int), capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(sizeof(int), size_bytes);
+	TEST_ASSERT_EQUAL_UINT(3 * sizeof(int), slack_bytes);
+
+	(void)fclose(stream);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_init_and_free);
+	RUN_TEST(test_size_changes);
+	RUN_TEST(test_edit_and_duplicate);
+	RUN_TEST(test_types_accounted_separately);
+	RUN_TEST(test_print);
+
+	return UNITY_END();
+}
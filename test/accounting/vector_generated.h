@@ -0,0 +1,16 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_ACCOUNTING 1
+#include "vector.h"
+
+typedef struct Point {
+	int x;
+	int y;
+} Point;
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE(PointVector, point_vector, Point)
+
+#endif /* VECTOR_GENERATED_H */
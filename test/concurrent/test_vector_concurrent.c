@@ -0,0 +1,160 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <pthread.h>
+#include <sched.h>
+
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define THREADS 4
+#define PUSHES 20000
+
+jmp_buf abort_jmp;
+
+static VectorConcurrent shared;
+
+static void *push_values(void *arg)
+{
+	int thread = *(int *)arg;
+	int i = 0;
+
+	for (i = 0; i < PUSHES; i++) {
+		(void)vector_concurrent_push(&shared, thread * PUSHES + i);
+	}
+	return NULL;
+}
+
+/* Every element read while pushes go on must hold a pushed value */
+static void *read_published(void *arg)
+{
+	size_t idx = 0;
+	int value = 0;
+
+	(void)arg;
+	while (idx < THREADS * PUSHES) {
+		if (!vector_concurrent_try_get(&shared, idx, &value)) {
+			(void)sched_yield();
+			continue;
+		}
+		if (value < 0 || value >= THREADS * PUSHES) {
+			return &shared;
+		}
+		idx++;
+	}
+	return NULL;
+}
+
+void setUp(void)
+{
+	vector_concurrent_init(&shared);
+}
+
+void tearDown(void)
+{
+	vector_concurrent_free(&shared);
+}
+
+void test_segments_never_move(void)
+{
+	const int *first = NULL;
+	size_t segment = 0;
+	size_t offset = 0;
+	int i = 0;
+
+	TEST_ASSERT_EQUAL_UINT(0, vector_core_concurrent_locate(0, &offset));
+	TEST_ASSERT_EQUAL_UINT(0, offset);
+	segment = vector_core_concurrent_locate(VECTOR_CONCURRENT_FIRST_SEGMENT,
+						&offset);
+	TEST_ASSERT_EQUAL_UINT(1, segment);
+	TEST_ASSERT_EQUAL_UINT(0, offset);
+	segment = vector_core_concurrent_locate(
+		3 * VECTOR_CONCURRENT_FIRST_SEGMENT - 1, &offset);
+	TEST_ASSERT_EQUAL_UINT(1, segment);
+	TEST_ASSERT_EQUAL_UINT(2 * VECTOR_CONCURRENT_FIRST_SEGMENT - 1, offset);
+
+	TEST_ASSERT_EQUAL_UINT(0, vector_concurrent_push(&shared, 0));
+	first = shared.segments[0];
+	for (i = 1; i < 10000; i++) {
+		TEST_ASSERT_EQUAL_UINT(i, vector_concurrent_push(&shared, i));
+	}
+	TEST_ASSERT_EQUAL_PTR(first, shared.segments[0]);
+	TEST_ASSERT_EQUAL_UINT(10000, vector_concurrent_size(&shared));
+	for (i = 0; i < 10000; i++) {
+		TEST_ASSERT_EQUAL_INT(i, vector_concurrent_get(&shared, i));
+	}
+}
+
+void test_concurrent_push(void)
+{
+	pthread_t writers[THREADS];
+	pthread_t reader;
+	int ids[THREADS];
+	unsigned char *seen = calloc(THREADS * PUSHES, 1);
+	void *reader_result = NULL;
+	size_t idx = 0;
+	int value = 0;
+	int i = 0;
+
+	TEST_ASSERT_NOT_NULL(seen);
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&reader, NULL, read_published,
+						NULL));
+	for (i = 0; i < THREADS; i++) {
+		ids[i] = i;
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&writers[i], NULL,
+							push_values, &ids[i]));
+	}
+	for (i = 0; i < THREADS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(writers[i], NULL));
+	}
+	TEST_ASSERT_EQUAL_INT(0, pthread_join(reader, &reader_result));
+	TEST_ASSERT_NULL(reader_result);
+
+	TEST_ASSERT_EQUAL_UINT(THREADS * PUSHES,
+			       vector_concurrent_size(&shared));
+	for (idx = 0; idx < THREADS * PUSHES; idx++) {
+		value = vector_concurrent_get(&shared, idx);
+		TEST_ASSERT_EQUAL_INT(0, seen[value]);
+		seen[value] = 1;
+	}
+	free(seen);
+}
+
+void test_try_get_unpublished(void)
+{
+	int value = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, vector_concurrent_try_get(&shared, 0, &value));
+	TEST_ASSERT_EQUAL_UINT(0, vector_concurrent_push(&shared, 5));
+	TEST_ASSERT_EQUAL_INT(1, vector_concurrent_try_get(&shared, 0, &value));
+	TEST_ASSERT_EQUAL_INT(5, value);
+
+	/* Reserved by a push that has not written its element yet */
+	shared.size = 2;
+	TEST_ASSERT_EQUAL_INT(0, vector_concurrent_try_get(&shared, 1, &value));
+}
+
+void test_get_out_of_bounds(void)
+{
+	(void)vector_concurrent_push(&shared, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_concurrent_get(&shared, 1);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_segments_never_move);
+	RUN_TEST(test_concurrent_push);
+	RUN_TEST(test_try_get_unpublished);
+	RUN_TEST(test_get_out_of_bounds);
+
+	return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define FILE_PATH "test_vector_file.bin"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+	(void)remove(FILE_PATH);
+}
+
+void tearDown(void)
+{
+	(void)remove(FILE_PATH);
+}
+
+void test_persists_across_open(void)
+{
+	VectorFile vec;
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+	for (idx = 0; idx < 1000; idx++) {
+		vector_file_push(&vec, idx);
+	}
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+	TEST_ASSERT_NULL(vec.begin);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	TEST_ASSERT_EQUAL_UINT(1000, VECTOR_SIZE(&vec));
+	TEST_ASSERT(VECTOR_CAPACITY(&vec) >= 1000);
+	for (idx = 0; idx < 1000; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, vec.begin[idx]);
+	}
+
+	vector_file_push(&vec, 1000);
+	TEST_ASSERT_EQUAL_INT(1000, vector_file_get(&vec, 1000));
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+}
+
+void test_closed_file_is_saved_vector(void)
+{
+	VectorFile vec;
+	VectorView view;
+	Vector loaded = { 0 };
+	FILE *stream = NULL;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	vector_file_push(&vec, 4);
+	vector_file_push(&vec, 5);
+	vector_file_push(&vec, 6);
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+
+	TEST_ASSERT_EQUAL_INT(1, vector_view_open(&view, FILE_PATH));
+	TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&view));
+	TEST_ASSERT_EQUAL_INT(1, vector_view_verify(&view));
+	vector_view_close(&view);
+
+	stream = fopen(FILE_PATH, "rb");
+	TEST_ASSERT_NOT_NULL(stream);
+	TEST_ASSERT_EQUAL_INT(1, vector_load(&loaded, stream));
+	TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_INT(6, loaded.begin[2]);
+	(void)fclose(stream);
+	vector_free(&loaded);
+}
+
+void test_sync_publishes_size(void)
+{
+	VectorFile vec;
+	VectorView view;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	vector_file_resize(&vec, 100);
+	vector_file_set(&vec, 99, 7);
+	TEST_ASSERT_EQUAL_INT(1, vector_file_sync(&vec));
+
+	TEST_ASSERT_EQUAL_INT(1, vector_view_open(&view, FILE_PATH));
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_SIZE(&view));
+	TEST_ASSERT_EQUAL_INT(7, vector_view_get(&view, 99));
+	vector_view_close(&view);
+
+	TEST_ASSERT_EQUAL_INT(7, vector_file_pop(&vec));
+	vector_file_clear(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+}
+
+void test_rejects_other_element_size(void)
+{
+	VectorFile vec;
+	PointVectorFile points;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+	vector_file_push(&vec, 1);
+	TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+
+	TEST_ASSERT_EQUAL_INT(0, point_vector_file_open(&points, FILE_PATH));
+	TEST_ASSERT_NULL(points.begin);
+	TEST_ASSERT_EQUAL_INT(0, point_vector_file_close(&points));
+}
+
+void test_get_out_of_bounds(void)
+{
+	VectorFile vec;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_file_open(&vec, FILE_PATH));
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_file_get(&vec, 0);
+	} else {
+		TEST_ASSERT_EQUAL_INT(1, vector_file_close(&vec));
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_push_before_open(void)
+{
+	VectorFile vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_file_push(&vec, 1);
+	} else {
+		TEST_ASSERT_NULL(vec.begin);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_resize_after_failed_open(void)
+{
+	VectorFile vec;
+
+	TEST_ASSERT_EQUAL_INT(0, vector_file_open(&vec, "missing/dir/file.bin"));
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_file_resize(&vec, 10);
+	} else {
+		TEST_ASSERT_NULL(vec.begin);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_persists_across_open);
+	RUN_TEST(test_closed_file_is_saved_vector);
+	RUN_TEST(test_sync_publishes_size);
+	RUN_TEST(test_rejects_other_element_size);
+	RUN_TEST(test_get_out_of_bounds);
+	RUN_TEST(test_push_before_open);
+	RUN_TEST(test_resize_after_failed_open);
+
+	return UNITY_END();
+}
@@ -0,0 +1,9 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SERIAL(Vector, vector, int)
+VECTOR_DEFINE_VIEW(Vector, vector, int)
+VECTOR_DEFINE_FILE(Vector, vector, int)
+VECTOR_DEFINE_CORE(PointVector, point_vector, Point)
+VECTOR_DEFINE_FILE(PointVector, point_vector, Point)
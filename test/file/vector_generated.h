@@ -0,0 +1,23 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_MMAP 1
+#include "vector.h"
+
+typedef struct Point {
+	int x;
+	int y;
+} Point;
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SERIAL(Vector, vector)
+VECTOR_DECLARE_VIEW(Vector, vector, int)
+VECTOR_DECLARE_FILE(Vector, vector, int)
+VECTOR_DECLARE(PointVector, point_vector, Point)
+VECTOR_DECLARE_FILE(PointVector, point_vector, Point)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,200 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_push_from_zero(void)
+{
+	IncrementalVector vec = { 0 };
+
+	incremental_vector_push(&vec, 8);
+
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(1, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(8, incremental_vector_get(&vec, 0));
+	TEST_ASSERT_NULL(vec.old_begin);
+
+	incremental_vector_free(&vec);
+}
+
+void test_push_migrates_in_steps(void)
+{
+	IncrementalVector vec = { 0 };
+	int idx = 0;
+
+	incremental_vector_init(&vec, 64);
+	for (idx = 0; idx < 64; idx++) {
+		incremental_vector_push(&vec, idx);
+	}
+	TEST_ASSERT_NULL(vec.old_begin);
+
+	incremental_vector_push(&vec, 64);
+
+	/* Two ints per step */
+	TEST_ASSERT_NOT_NULL(vec.old_begin);
+	TEST_ASSERT_EQUAL_UINT(2, vec.migrated);
+	TEST_ASSERT_EQUAL_UINT(64, vec.old_size);
+	TEST_ASSERT_EQUAL_UINT(128, VECTOR_CAPACITY(&vec));
+
+	for (idx = 65; idx < 128; idx++) {
+		incremental_vector_push(&vec, idx);
+	}
+	TEST_ASSERT_NULL(vec.old_begin);
+
+	for (idx = 0; idx < 128; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, vec.begin[idx]);
+	}
+
+	incremental_vector_free(&vec);
+}
+
+void test_get_set_during_migration(void)
+{
+	IncrementalVector vec = { 0 };
+	int idx = 0;
+	int jdx = 0;
+
+	for (idx = 0; idx < 600; idx++) {
+		incremental_vector_push(&vec, idx);
+		for (jdx = 0; jdx <= idx; jdx++) {
+			TEST_ASSERT_EQUAL_INT(jdx,
+					      incremental_vector_get(&vec, jdx));
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(vec.old_begin);
+
+	for (idx = 0; idx < 600; idx++) {
+		incremental_vector_set(&vec, idx, idx * 2);
+	}
+
+	incremental_vector_finish_migration(&vec);
+	TEST_ASSERT_NULL(vec.old_begin);
+
+	for (idx = 0; idx < 600; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx * 2, vec.begin[idx]);
+	}
+
+	incremental_vector_free(&vec);
+}
+
+void test_pop_during_migration(void)
+{
+	IncrementalVector vec = { 0 };
+	int idx = 0;
+
+	incremental_vector_init(&vec, 64);
+	for (idx = 0; idx < 65; idx++) {
+		incremental_vector_push(&vec, idx);
+	}
+
+	TEST_ASSERT_NOT_NULL(vec.old_begin);
+
+	for (idx = 64; idx >= 0; idx--) {
+		TEST_ASSERT_EQUAL_INT(idx, incremental_vector_pop(&vec));
+	}
+
+	TEST_ASSERT_NULL(vec.old_begin);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+
+	incremental_vector_free(&vec);
+}
+
+void test_migrate(void)
+{
+	IncrementalVector vec = { 0 };
+	int idx = 0;
+	int steps = 0;
+
+	incremental_vector_init(&vec, 64);
+	for (idx = 0; idx < 65; idx++) {
+		incremental_vector_push(&vec, idx);
+	}
+
+	while (incremental_vector_migrate(&vec)) {
+		steps++;
+	}
+
+	TEST_ASSERT_EQUAL_INT(30, steps);
+	TEST_ASSERT_NULL(vec.old_begin);
+	TEST_ASSERT_EQUAL_INT(0, incremental_vector_migrate(&vec));
+
+	for (idx = 0; idx < 65; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, vec.begin[idx]);
+	}
+
+	incremental_vector_free(&vec);
+}
+
+void test_clear_during_migration(void)
+{
+	IncrementalVector vec = { 0 };
+	int idx = 0;
+
+	incremental_vector_init(&vec, 64);
+	for (idx = 0; idx < 65; idx++) {
+		incremental_vector_push(&vec, idx);
+	}
+
+	incremental_vector_clear(&vec);
+
+	TEST_ASSERT_NULL(vec.old_begin);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_UINT(128, VECTOR_CAPACITY(&vec));
+
+	incremental_vector_free(&vec);
+}
+
+void test_get_out_of_range(void)
+{
+	IncrementalVector vec = { 0 };
+
+	incremental_vector_push(&vec, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		incremental_vector_get(&vec, 1);
+	} else {
+		incremental_vector_free(&vec);
+		return;
+	}
+
+	incremental_vector_free(&vec);
+	TEST_FAIL();
+}
+
+void test_pop_zero(void)
+{
+	IncrementalVector vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		incremental_vector_pop(&vec);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_push_from_zero);
+	RUN_TEST(test_push_migrates_in_steps);
+	RUN_TEST(test_get_set_during_migration);
+	RUN_TEST(test_pop_during_migration);
+	RUN_TEST(test_migrate);
+	RUN_TEST(test_clear_during_migration);
+	RUN_TEST(test_get_out_of_range);
+	RUN_TEST(test_pop_zero);
+
+	return UNITY_END();
+}
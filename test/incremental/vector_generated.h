@@ -0,0 +1,10 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_INCREMENTAL_STEP_BYTES 8
+#include "vector.h"
+
+VECTOR_DECLARE_INCREMENTAL(IncrementalVector, incremental_vector, int)
+
+#endif /* VECTOR_GENERATED_H */
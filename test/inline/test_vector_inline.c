@@ -0,0 +1,69 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_across_translation_units(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	push_range(&vec, 100);
+
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_SIZE(&vec));
+	for (idx = 0; idx < 100; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, vector_get(&vec, idx));
+	}
+
+	vector_free(&vec);
+}
+
+void test_insert_delete_duplicate(void)
+{
+	Vector vec = { 0 };
+	Vector copy = { 0 };
+
+	push_range(&vec, 10);
+	vector_insert(&vec, 0, -1);
+	vector_delete(&vec, 10);
+	vector_duplicate(&copy, &vec);
+
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_SIZE(&copy));
+	TEST_ASSERT_EQUAL_INT(-1, vector_get(&copy, 0));
+	TEST_ASSERT_EQUAL_INT(8, vector_get(&copy, 9));
+
+	vector_free(&vec);
+	vector_free(&copy);
+}
+
+void test_get_out_of_range(void)
+{
+	Vector vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_get(&vec, 0);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_across_translation_units);
+	RUN_TEST(test_insert_delete_duplicate);
+	RUN_TEST(test_get_out_of_range);
+
+	return UNITY_END();
+}
@@ -0,0 +1,10 @@
+#include "vector_generated.h"
+
+void push_range(Vector *vec, int count)
+{
+	int idx = 0;
+
+	for (idx = 0; idx < count; idx++) {
+		vector_push(vec, idx);
+	}
+}
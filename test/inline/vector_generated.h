@@ -0,0 +1,12 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+VECTOR_DEFINE_INLINE(Vector, vector, int)
+
+/* Defined in another translation unit also using the inline vector */
+void push_range(Vector *vec, int count);
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,137 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <pthread.h>
+
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define THREADS 4
+#define ROUNDS 1000
+
+jmp_buf abort_jmp;
+
+static void *push_and_free(void *arg)
+{
+	Vector vec = { 0 };
+	int round = 0;
+
+	(void)arg;
+	for (round = 0; round < ROUNDS; round++) {
+		push_range(&vec, 100);
+		vector_free(&vec);
+	}
+	return NULL;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void read_trace(unsigned long *reallocs, unsigned long *frees)
+{
+	FILE *stream = tmpfile();
+	char line[256] = { 0 };
+	unsigned long realloc_bytes = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	vector_trace_dump(stream);
+	rewind(stream);
+	TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), stream));
+	TEST_ASSERT_EQUAL_INT(3, sscanf(line,
+					"Vector: %lu reallocs (%lu bytes), %lu frees",
+					reallocs, &realloc_bytes, frees));
+	(void)fclose(stream);
+}
+
+void test_trace_counts_every_translation_unit(void)
+{
+	Vector vec = { 0 };
+	unsigned long reallocs = 0;
+	unsigned long frees = 0;
+	unsigned long new_reallocs = 0;
+	unsigned long new_frees = 0;
+	size_t registered = 0;
+	const VectorCoreTraceCounters *counters = NULL;
+
+	read_trace(&reallocs, &frees);
+
+	/* Allocated in the other translation unit, freed in this one */
+	push_range(&vec, 100);
+	vector_free(&vec);
+
+	read_trace(&new_reallocs, &new_frees);
+	TEST_ASSERT_EQUAL_UINT(reallocs + 1, new_reallocs);
+	TEST_ASSERT_EQUAL_UINT(frees + 1, new_frees);
+
+	for (counters = vector_core_trace_registry; counters;
+	     counters = counters->next) {
+		registered += strcmp(counters->type_name, "Vector") == 0;
+	}
+	TEST_ASSERT_EQUAL_UINT(1, registered);
+}
+
+void test_accounting_shared_by_every_translation_unit(void)
+{
+	const VectorCoreAccountStats *stats = vector_account_stats();
+	Vector vec = { 0 };
+	size_t registered = 0;
+
+	/* Allocated in the other translation unit, freed in this one */
+	push_range(&vec, 100);
+	TEST_ASSERT_EQUAL_UINT(1, stats->live);
+	TEST_ASSERT_EQUAL_UINT(100 * sizeof(int), stats->size_bytes);
+
+	vector_free(&vec);
+	TEST_ASSERT_EQUAL_UINT(0, stats->live);
+	TEST_ASSERT_EQUAL_UINT(0, stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, stats->size_bytes);
+
+	for (stats = vector_core_account_registry; stats; stats = stats->next) {
+		registered += strcmp(stats->type_name, "Vector") == 0;
+	}
+	TEST_ASSERT_EQUAL_UINT(1, registered);
+}
+
+void test_instrumentation_counts_every_thread(void)
+{
+	const VectorCoreAccountStats *stats = vector_account_stats();
+	pthread_t threads[THREADS];
+	unsigned long reallocs = 0;
+	unsigned long frees = 0;
+	unsigned long new_reallocs = 0;
+	unsigned long new_frees = 0;
+	size_t thread = 0;
+
+	read_trace(&reallocs, &frees);
+	for (thread = 0; thread < THREADS; thread++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[thread], NULL,
+							push_and_free, NULL));
+	}
+	for (thread = 0; thread < THREADS; thread++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[thread], NULL));
+	}
+
+	/* One allocation and one deallocation per round */
+	read_trace(&new_reallocs, &new_frees);
+	TEST_ASSERT_EQUAL_UINT(reallocs + THREADS * ROUNDS, new_reallocs);
+	TEST_ASSERT_EQUAL_UINT(frees + THREADS * ROUNDS, new_frees);
+	TEST_ASSERT_EQUAL_UINT(0, stats->live);
+	TEST_ASSERT_EQUAL_UINT(0, stats->capacity_bytes);
+	TEST_ASSERT_EQUAL_UINT(0, stats->size_bytes);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_trace_counts_every_translation_unit);
+	RUN_TEST(test_accounting_shared_by_every_translation_unit);
+	RUN_TEST(test_instrumentation_counts_every_thread);
+
+	return UNITY_END();
+}
@@ -0,0 +1,13 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+
+void push_range(Vector *vec, int count)
+{
+	int idx = 0;
+
+	vector_init(vec, (size_t)count);
+	for (idx = 0; idx < count; idx++) {
+		vector_push(vec, idx);
+	}
+}
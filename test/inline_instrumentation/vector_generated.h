@@ -0,0 +1,14 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_TRACE 1
+#define VECTOR_ACCOUNTING 1
+#include "vector.h"
+
+VECTOR_DEFINE_INLINE(Vector, vector, int)
+
+/* Defined in another translation unit also using the inline vector */
+void push_range(Vector *vec, int count);
+
+#endif /* VECTOR_GENERATED_H */
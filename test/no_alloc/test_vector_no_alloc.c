@@ -0,0 +1,187 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+VECTOR_THREAD_LOCAL int vector_no_alloc_depth;
+
+void setUp(void)
+{
+	vector_no_alloc_depth = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_try_push_from_zero(void)
+{
+	Vector vec = { 0 };
+
+	TEST_ASSERT_EQUAL_INT(0, vector_try_push(&vec, 1));
+	TEST_ASSERT_NULL(vec.begin);
+}
+
+void test_try_push(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	vector_init(&vec, 10);
+
+	for (idx = 0; idx < 10; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, vector_try_push(&vec, idx));
+		TEST_ASSERT_EQUAL_INT(idx, vector_get(&vec, idx));
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, vector_try_push(&vec, 10));
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_CAPACITY(&vec));
+
+	vector_free(&vec);
+}
+
+void test_try_insert(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	vector_init(&vec, 10);
+
+	for (idx = 0; idx < 10; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, vector_try_insert(&vec, 0, idx));
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, vector_try_insert(&vec, 5, 10));
+
+	for (idx = 0; idx < 10; idx++) {
+		TEST_ASSERT_EQUAL_INT(9 - idx, vector_get(&vec, idx));
+	}
+
+	vector_free(&vec);
+}
+
+void test_try_insert_out_of_range(void)
+{
+	Vector vec = { 0 };
+
+	vector_init(&vec, 10);
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_try_insert(&vec, 1, 10);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	vector_free(&vec);
+	TEST_FAIL();
+}
+
+void test_region_without_alloc(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	vector_init(&vec, 101);
+
+	VECTOR_NO_ALLOC_BEGIN();
+	for (idx = 0; idx < 100; idx++) {
+		vector_push(&vec, idx);
+	}
+	vector_insert(&vec, 0, 0);
+	vector_delete(&vec, 0);
+	VECTOR_NO_ALLOC_END();
+
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_SIZE(&vec));
+
+	vector_free(&vec);
+}
+
+void test_region_push_grow(void)
+{
+	Vector vec = { 0 };
+
+	vector_init(&vec, 1);
+	vector_push(&vec, 0);
+
+	VECTOR_NO_ALLOC_BEGIN();
+	if (setjmp(abort_jmp) == 0) {
+		vector_push(&vec, 1);
+	} else {
+		VECTOR_NO_ALLOC_END();
+		TEST_ASSERT_EQUAL_UINT(1, VECTOR_CAPACITY(&vec));
+		vector_free(&vec);
+		return;
+	}
+
+	vector_free(&vec);
+	TEST_FAIL();
+}
+
+void test_region_nested_init(void)
+{
+	Vector vec = { 0 };
+
+	VECTOR_NO_ALLOC_BEGIN();
+	VECTOR_NO_ALLOC_BEGIN();
+	VECTOR_NO_ALLOC_END();
+	if (setjmp(abort_jmp) == 0) {
+		vector_push(&vec, 1);
+	} else {
+		VECTOR_NO_ALLOC_END();
+		TEST_ASSERT_NULL(vec.begin);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_region_duplicate(void)
+{
+	Vector src = { 0 };
+	Vector dest = { 0 };
+
+	vector_push(&src, 1);
+
+	VECTOR_NO_ALLOC_BEGIN();
+	if (setjmp(abort_jmp) == 0) {
+		vector_duplicate(&dest, &src);
+	} else {
+		VECTOR_NO_ALLOC_END();
+		vector_free(&src);
+		return;
+	}
+
+	vector_free(&src);
+	TEST_FAIL();
+}
+
+void test_region_ended(void)
+{
+	Vector vec = { 0 };
+
+	VECTOR_NO_ALLOC_BEGIN();
+	VECTOR_NO_ALLOC_END();
+
+	vector_push(&vec, 1);
+	TEST_ASSERT_EQUAL_INT(1, vector_get(&vec, 0));
+
+	vector_free(&vec);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_try_push_from_zero);
+	RUN_TEST(test_try_push);
+	RUN_TEST(test_try_insert);
+	RUN_TEST(test_try_insert_out_of_range);
+	RUN_TEST(test_region_without_alloc);
+	RUN_TEST(test_region_push_grow);
+	RUN_TEST(test_region_nested_init);
+	RUN_TEST(test_region_duplicate);
+	RUN_TEST(test_region_ended);
+
+	return UNITY_END();
+}
@@ -0,0 +1,10 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_NO_ALLOC_GUARD 1
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+
+#endif /* VECTOR_GENERATED_H */
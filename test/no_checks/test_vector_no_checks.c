@@ -0,0 +1,107 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_push_get_set(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 1000; idx++) {
+		vector_push(&vec, idx);
+	}
+
+	for (idx = 0; idx < 1000; idx++) {
+		vector_set(&vec, idx, vector_get(&vec, idx) * 2);
+	}
+
+	for (idx = 0; idx < 1000; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx * 2, vector_get(&vec, idx));
+	}
+
+	vector_free(&vec);
+}
+
+void test_insert_delete_pop(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 100; idx++) {
+		vector_insert(&vec, 0, idx);
+	}
+
+	vector_delete(&vec, 0);
+	TEST_ASSERT_EQUAL_UINT(99, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(98, vector_get(&vec, 0));
+	TEST_ASSERT_EQUAL_INT(0, vector_pop(&vec));
+
+	vector_free(&vec);
+}
+
+void test_push_unchecked_from_zero(void)
+{
+	Vector vec = { 0 };
+
+	vector_push_unchecked(&vec, 8);
+
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(1, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(8, vector_get_unchecked(&vec, 0));
+
+	vector_free(&vec);
+}
+
+void test_push_unchecked(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 1000; idx++) {
+		vector_push_unchecked(&vec, idx);
+		TEST_ASSERT_EQUAL_INT(idx, vector_get_unchecked(&vec, idx));
+	}
+
+	TEST_ASSERT_EQUAL_UINT(1000, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_UINT(1024, VECTOR_CAPACITY(&vec));
+
+	vector_free(&vec);
+}
+
+void test_set_unchecked(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	vector_resize(&vec, 100);
+
+	for (idx = 0; idx < 100; idx++) {
+		vector_set_unchecked(&vec, idx, -idx);
+	}
+
+	for (idx = 0; idx < 100; idx++) {
+		TEST_ASSERT_EQUAL_INT(-idx, vector_get(&vec, idx));
+	}
+
+	vector_free(&vec);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_push_get_set);
+	RUN_TEST(test_insert_delete_pop);
+	RUN_TEST(test_push_unchecked_from_zero);
+	RUN_TEST(test_push_unchecked);
+	RUN_TEST(test_set_unchecked);
+
+	return UNITY_END();
+}
@@ -0,0 +1,3 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE(Vector, vector, int)
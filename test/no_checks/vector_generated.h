@@ -0,0 +1,9 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_NO_CHECKS 1
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,502 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+/* Long enough for the unrolled loops, the single vector ones and the tails */
+#define SIZE 300
+
+jmp_buf abort_jmp;
+
+static size_t naive_find(const int *begin, size_t size, int value)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < size; idx++) {
+		if (begin[idx] == value) {
+			return idx;
+		}
+	}
+	return VECTOR_NOT_FOUND;
+}
+
+static size_t naive_count(const int *begin, size_t size, int value)
+{
+	size_t idx = 0;
+	size_t count = 0;
+
+	for (idx = 0; idx < size; idx++) {
+		count += begin[idx] == value;
+	}
+	return count;
+}
+
+static int same_magnitude(int a, int b)
+{
+	return a == b || a == -b;
+}
+
+/* The documented order: element i in lane i % 16 over full rounds, lanes
+ * folded by halves, then the remaining elements */
+static double ordered_dot(const double *a, const double *b, size_t size)
+{
+	double lanes[VECTOR_REDUCE_LANES] = { 0 };
+	size_t idx = 0;
+	size_t width = 0;
+	size_t full = size - size % VECTOR_REDUCE_LANES;
+
+	for (idx = 0; idx < full; idx++) {
+		lanes[idx % VECTOR_REDUCE_LANES] +=
+			b ? a[idx] * b[idx] : a[idx];
+	}
+	for (width = VECTOR_REDUCE_LANES / 2; width > 0; width /= 2) {
+		for (idx = 0; idx < width; idx++) {
+			lanes[idx] += lanes[idx + width];
+		}
+	}
+	for (idx = full; idx < size; idx++) {
+		lanes[0] += b ? a[idx] * b[idx] : a[idx];
+	}
+	return lanes[0];
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+	vector_core_simd_level = 2;
+}
+
+void test_find_and_count_match_naive_loops(void)
+{
+	Vector vec = { 0 };
+	size_t idx = 0;
+	size_t start = 0;
+	size_t size = 0;
+	int value = 0;
+	int level = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&vec, (int)(idx * 7 % 23));
+	}
+
+	/* Every simd level, from unaligned starts, over sizes ending in
+	 * every kind of tail */
+	for (level = 0; level <= 2; level++) {
+		vector_core_simd_level = level;
+		for (start = 0; start < 4; start++) {
+			for (size = 0; size + start <= SIZE; size += 13) {
+				for (value = -1; value < 24; value++) {
+					TEST_ASSERT_EQUAL_UINT(
+						naive_find(vec.begin + start,
+							   size, value),
+						vector_core_find(
+							VECTOR_I32,
+							vec.begin + start, size,
+							&value));
+					TEST_ASSERT_EQUAL_UINT(
+						naive_count(vec.begin + start,
+							    size, value),
+						vector_core_count(
+							VECTOR_I32,
+							vec.begin + start, size,
+							&value));
+				}
+			}
+		}
+	}
+
+	vector_free(&vec);
+}
+
+void test_generated_functions(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND, vector_find(&vec, 0));
+	TEST_ASSERT_EQUAL_UINT(0, vector_count(&vec, 0));
+	TEST_ASSERT_FALSE(vector_contains(&vec, 0));
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&vec, idx % 100);
+	}
+	vector_set(&vec, SIZE - 1, -5);
+
+	TEST_ASSERT_EQUAL_UINT(42, vector_find(&vec, 42));
+	TEST_ASSERT_EQUAL_UINT(3, vector_count(&vec, 42));
+	TEST_ASSERT_EQUAL_UINT(SIZE - 1, vector_find(&vec, -5));
+	TEST_ASSERT_TRUE(vector_contains(&vec, -5));
+	TEST_ASSERT_FALSE(vector_contains(&vec, 100));
+
+	TEST_ASSERT_EQUAL_UINT(5, vector_find_if_eq(&vec, -5, same_magnitude));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND,
+			       vector_find_if_eq(&vec, 100, same_magnitude));
+
+	vector_free(&vec);
+}
+
+void test_span_searches_are_relative_to_the_span(void)
+{
+	Vector vec = { 0 };
+	VectorSpan span = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&vec, idx % 100);
+	}
+	vector_set(&vec, SIZE - 1, -5);
+
+	/* 30 to 99 then 0 to 29, without the last element */
+	span = vector_span_subslice(vector_span(&vec), 130, 100);
+	TEST_ASSERT_EQUAL_UINT(12, vector_span_find(span, 42));
+	TEST_ASSERT_EQUAL_UINT(1, vector_span_count(span, 42));
+	TEST_ASSERT_TRUE(vector_span_contains(span, 0));
+	TEST_ASSERT_FALSE(vector_span_contains(span, -5));
+	TEST_ASSERT_EQUAL_UINT(75, vector_span_find_if_eq(span, -5,
+							  same_magnitude));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND, vector_span_find(span, 100));
+
+	span = vector_span_subslice(span, 0, 0);
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND, vector_span_find(span, 30));
+	TEST_ASSERT_EQUAL_UINT(0, vector_span_count(span, 30));
+
+	vector_free(&vec);
+}
+
+void test_64_bits_elements_compare_both_halves(void)
+{
+	LongVector vec = { 0 };
+	long low = 1;
+	long high = 1L << 32;
+	int level = 0;
+	int idx = 0;
+
+	/* Elements matching the value on one half only */
+	for (idx = 0; idx < SIZE; idx++) {
+		long_vector_push(&vec, idx % 2 ? low : high);
+	}
+	long_vector_set(&vec, 250, low + high);
+
+	for (level = 0; level <= 2; level++) {
+		vector_core_simd_level = level;
+		TEST_ASSERT_EQUAL_UINT(250, long_vector_find(&vec, low + high));
+		TEST_ASSERT_EQUAL_UINT(1, long_vector_count(&vec, low + high));
+		TEST_ASSERT_EQUAL_UINT(1, long_vector_find(&vec, low));
+		TEST_ASSERT_EQUAL_UINT(SIZE / 2 - 1,
+				       long_vector_count(&vec, high));
+		TEST_ASSERT_FALSE(long_vector_contains(&vec, 0));
+	}
+
+	long_vector_free(&vec);
+}
+
+void test_float_comparisons(void)
+{
+	FloatVector vec = { 0 };
+	float zero = 0.0f;
+	float nan = 0.0f;
+	int level = 0;
+	int idx = 0;
+
+	nan = zero / zero;
+	for (idx = 0; idx < SIZE; idx++) {
+		float_vector_push(&vec, (float)idx / 4);
+	}
+	float_vector_set(&vec, 0, 1.0f);
+	float_vector_set(&vec, 100, -zero);
+	float_vector_set(&vec, 200, zero);
+	float_vector_set(&vec, 210, nan);
+
+	for (level = 0; level <= 2; level++) {
+		vector_core_simd_level = level;
+		TEST_ASSERT_EQUAL_UINT(0, float_vector_find(&vec, 1.0f));
+		TEST_ASSERT_EQUAL_UINT(2, float_vector_count(&vec, 1.0f));
+		/* NaN equals nothing, not even itself, and -0 equals 0 */
+		TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND,
+				       float_vector_find(&vec, nan));
+		TEST_ASSERT_EQUAL_UINT(0, float_vector_count(&vec, nan));
+		TEST_ASSERT_EQUAL_UINT(100, float_vector_find(&vec, zero));
+		TEST_ASSERT_EQUAL_UINT(100, float_vector_find(&vec, -zero));
+		TEST_ASSERT_EQUAL_UINT(2, float_vector_count(&vec, -zero));
+	}
+
+	float_vector_free(&vec);
+}
+
+void test_double_comparisons(void)
+{
+	DoubleVector vec = { 0 };
+	double zero = 0.0;
+	double nan = 0.0;
+	int level = 0;
+	int idx = 0;
+
+	nan = zero / zero;
+	for (idx = 0; idx < SIZE; idx++) {
+		double_vector_push(&vec, idx % 3 ? nan : (double)idx);
+	}
+	double_vector_set(&vec, 150, zero);
+	double_vector_set(&vec, 33, -zero);
+
+	for (level = 0; level <= 2; level++) {
+		vector_core_simd_level = level;
+		TEST_ASSERT_EQUAL_UINT(297, double_vector_find(&vec, 297.0));
+		TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND,
+				       double_vector_find(&vec, nan));
+		TEST_ASSERT_EQUAL_UINT(0, double_vector_find(&vec, -zero));
+		TEST_ASSERT_EQUAL_UINT(3, double_vector_count(&vec, -zero));
+		TEST_ASSERT_FALSE(double_vector_contains(&vec, 1.0));
+	}
+
+	double_vector_free(&vec);
+}
+
+void test_double_sums_follow_documented_order(void)
+{
+	DoubleVector a = { 0 };
+	DoubleVector b = { 0 };
+	size_t size = SIZE;
+	size_t step = 0;
+	int level = 0;
+	int idx = 0;
+
+	/* Magnitudes far enough apart for other orders to round differently */
+	for (idx = 0; idx < SIZE; idx++) {
+		double_vector_push(&a, (idx % 5 ? 1e-3 : 1e8) / (idx + 1));
+		double_vector_push(&b, (double)(idx % 7) - 3.5);
+	}
+
+	/* Shrinking, for sizes ending in every kind of tail */
+	for (step = 0; step * 13 < SIZE; step++) {
+		size = SIZE - step * 13;
+		double_vector_resize(&a, size);
+		double_vector_resize(&b, size);
+		for (level = 0; level <= 2; level++) {
+			vector_core_simd_level = level;
+			TEST_ASSERT_TRUE(ordered_dot(a.begin, NULL, size)
+					 == double_vector_sum(&a));
+			TEST_ASSERT_TRUE(ordered_dot(a.begin, b.begin, size)
+					 == double_vector_dot(&a, &b));
+		}
+	}
+
+	double_vector_free(&a);
+	double_vector_free(&b);
+}
+
+void test_float_sums_agree_across_levels(void)
+{
+	FloatVector vec = { 0 };
+	float expected = 0;
+	double exact = 0;
+	int level = 0;
+	int idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		float_vector_push(&vec, (idx % 3 ? 1e-4f : 1e4f) * (float)idx);
+		exact += (double)vec.begin[idx] * vec.begin[idx];
+	}
+
+	vector_core_simd_level = 0;
+	expected = float_vector_dot(&vec, &vec);
+	for (level = 1; level <= 2; level++) {
+		vector_core_simd_level = level;
+		TEST_ASSERT_TRUE(expected == float_vector_dot(&vec, &vec));
+	}
+	TEST_ASSERT_FLOAT_WITHIN(1e9f, (float)exact, expected);
+
+	float_vector_free(&vec);
+}
+
+void test_kahan_sum(void)
+{
+	FloatVector vec = { 0 };
+	double exact = 0;
+	int idx = 0;
+
+	for (idx = 0; idx < 1000000; idx++) {
+		float_vector_push(&vec, 0.1f);
+	}
+	exact = 1000000 * (double)0.1f;
+
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, (float)exact,
+				 float_vector_sum_kahan(&vec));
+
+	float_vector_free(&vec);
+}
+
+void test_integer_reductions(void)
+{
+	Vector a = { 0 };
+	Vector b = { 0 };
+	int sum = 0;
+	int dot = 0;
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, vector_sum(&a));
+	TEST_ASSERT_EQUAL_INT(0, vector_dot(&a, &b));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND, vector_argmin(&a));
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&a, idx % 17 - 8);
+		vector_push(&b, idx % 5);
+	}
+	vector_set(&a, 37, 50);
+	vector_set(&a, 290, 50);
+	vector_set(&a, 298, -9);
+	for (idx = 0; idx < SIZE; idx++) {
+		sum += a.begin[idx];
+		dot += a.begin[idx] * b.begin[idx];
+	}
+
+	TEST_ASSERT_EQUAL_INT(sum, vector_sum(&a));
+	TEST_ASSERT_EQUAL_INT(sum, vector_sum_kahan(&a));
+	TEST_ASSERT_EQUAL_INT(dot, vector_dot(&a, &b));
+	TEST_ASSERT_EQUAL_INT(50, vector_max(&a));
+	TEST_ASSERT_EQUAL_UINT(37, vector_argmax(&a));
+	TEST_ASSERT_EQUAL_INT(-9, vector_min(&a));
+	TEST_ASSERT_EQUAL_UINT(298, vector_argmin(&a));
+
+	vector_free(&a);
+	vector_free(&b);
+}
+
+void test_span_reductions_cover_only_the_span(void)
+{
+	Vector a = { 0 };
+	Vector b = { 0 };
+	DoubleVector c = { 0 };
+	VectorSpan span = { 0 };
+	DoubleVectorSpan double_span = { 0 };
+	int sum = 0;
+	int dot = 0;
+	int idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&a, idx % 17 - 8);
+		vector_push(&b, idx % 5);
+		double_vector_push(&c, (idx % 5 ? 1e-3 : 1e8) / (idx + 1));
+	}
+	vector_set(&a, 37, 50);
+	vector_set(&a, 120, 40);
+	vector_set(&a, 298, -9);
+	for (idx = 41; idx < 290; idx++) {
+		sum += a.begin[idx];
+		dot += a.begin[idx] * b.begin[idx];
+	}
+
+	/* The extremes at 37 and 298 are outside */
+	span = vector_span_subslice(vector_span(&a), 41, 249);
+	TEST_ASSERT_EQUAL_INT(sum, vector_span_sum(span));
+	TEST_ASSERT_EQUAL_INT(sum, vector_span_sum_kahan(span));
+	TEST_ASSERT_EQUAL_INT(dot, vector_span_dot(
+					   span, vector_span_subslice(
+							 vector_span(&b), 41,
+							 249)));
+	TEST_ASSERT_EQUAL_INT(40, vector_span_max(span));
+	TEST_ASSERT_EQUAL_UINT(79, vector_span_argmax(span));
+	TEST_ASSERT_EQUAL_INT(-8, vector_span_min(span));
+	TEST_ASSERT_EQUAL_UINT(10, vector_span_argmin(span));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND,
+			       vector_span_argmin(vector_span_subslice(span, 0,
+								       0)));
+
+	/* Floating point sums of a span start their lanes at its beginning */
+	double_span = double_vector_span_subslice(double_vector_span(&c), 3,
+						  250);
+	TEST_ASSERT_TRUE(ordered_dot(c.begin + 3, NULL, 250)
+			 == double_vector_span_sum(double_span));
+	TEST_ASSERT_TRUE(ordered_dot(c.begin + 3, c.begin + 3, 250)
+			 == double_vector_span_dot(double_span, double_span));
+
+	vector_free(&a);
+	vector_free(&b);
+	double_vector_free(&c);
+}
+
+void test_float_extremes_skip_nan(void)
+{
+	FloatVector vec = { 0 };
+	float zero = 0.0f;
+	float nan = 0.0f;
+	int idx = 0;
+
+	nan = zero / zero;
+	float_vector_push(&vec, nan);
+	TEST_ASSERT_TRUE(float_vector_min(&vec) != float_vector_min(&vec));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_NOT_FOUND, float_vector_argmax(&vec));
+
+	for (idx = 0; idx < 40; idx++) {
+		float_vector_push(&vec, idx % 2 ? nan : (float)idx);
+	}
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, float_vector_min(&vec));
+	TEST_ASSERT_EQUAL_UINT(1, float_vector_argmin(&vec));
+	TEST_ASSERT_EQUAL_FLOAT(38.0f, float_vector_max(&vec));
+	TEST_ASSERT_EQUAL_UINT(39, float_vector_argmax(&vec));
+
+	float_vector_free(&vec);
+}
+
+void test_min_of_empty_vector(void)
+{
+	Vector vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_min(&vec);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_dot_of_different_sizes(void)
+{
+	Vector a = { 0 };
+	Vector b = { 0 };
+
+	vector_push(&a, 1);
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_dot(&a, &b);
+	} else {
+		vector_free(&a);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_find_null(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_find(NULL, 0);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_find_and_count_match_naive_loops);
+	RUN_TEST(test_generated_functions);
+	RUN_TEST(test_span_searches_are_relative_to_the_span);
+	RUN_TEST(test_64_bits_elements_compare_both_halves);
+	RUN_TEST(test_float_comparisons);
+	RUN_TEST(test_double_comparisons);
+	RUN_TEST(test_double_sums_follow_documented_order);
+	RUN_TEST(test_float_sums_agree_across_levels);
+	RUN_TEST(test_kahan_sum);
+	RUN_TEST(test_integer_reductions);
+	RUN_TEST(test_span_reductions_cover_only_the_span);
+	RUN_TEST(test_float_extremes_skip_nan);
+	RUN_TEST(test_min_of_empty_vector);
+	RUN_TEST(test_dot_of_different_sizes);
+	RUN_TEST(test_find_null);
+
+	return UNITY_END();
+}
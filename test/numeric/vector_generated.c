@@ -0,0 +1,12 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_NUMERIC(Vector, vector, int, VECTOR_I32)
+/* long has 64 bits on the LP64 systems the tests run on */
+VECTOR_DEFINE(LongVector, long_vector, long)
+VECTOR_DEFINE_NUMERIC(LongVector, long_vector, long, VECTOR_I64)
+VECTOR_DEFINE(FloatVector, float_vector, float)
+VECTOR_DEFINE_NUMERIC(FloatVector, float_vector, float, VECTOR_F32)
+VECTOR_DEFINE(DoubleVector, double_vector, double)
+VECTOR_DEFINE_NUMERIC(DoubleVector, double_vector, double, VECTOR_F64)
@@ -0,0 +1,16 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_NUMERIC(Vector, vector, int)
+VECTOR_DECLARE(LongVector, long_vector, long)
+VECTOR_DECLARE_NUMERIC(LongVector, long_vector, long)
+VECTOR_DECLARE(FloatVector, float_vector, float)
+VECTOR_DECLARE_NUMERIC(FloatVector, float_vector, float)
+VECTOR_DECLARE(DoubleVector, double_vector, double)
+VECTOR_DECLARE_NUMERIC(DoubleVector, double_vector, double)
+
+#endif /* VECTOR_GENERATED_H */
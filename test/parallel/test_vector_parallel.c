@@ -0,0 +1,310 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define SIZE 100000
+
+jmp_buf abort_jmp;
+
+static Vector inner;
+static unsigned long seed = 1;
+
+static int next_random(int range)
+{
+	seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+	return (int)((seed >> 8) % (unsigned long)range);
+}
+
+static void assert_parallel_sort(size_t size, int range, size_t threads)
+{
+	Vector vec = { 0 };
+	Vector expected = { 0 };
+	size_t idx = 0;
+
+	for (idx = 0; idx < size; idx++) {
+		vector_push(&vec, next_random(range));
+	}
+	vector_duplicate(&expected, &vec);
+	vector_sort(&expected);
+
+	vector_core_parallel_set_threads(threads);
+	vector_parallel_sort(&vec);
+	TEST_ASSERT_EQUAL_UINT(size, VECTOR_SIZE(&vec));
+	if (size != 0) {
+		TEST_ASSERT_EQUAL_INT_ARRAY(expected.begin, vec.begin, size);
+	}
+
+	vector_free(&vec);
+	vector_free(&expected);
+}
+
+static void increment(int *element, void *context)
+{
+	*element += *(int *)context;
+}
+
+static int square(int value, void *context)
+{
+	(void)context;
+	return value * value;
+}
+
+static int add(int a, int b, void *context)
+{
+	(void)context;
+	return a + b;
+}
+
+static double add_double(double a, double b, void *context)
+{
+	(void)context;
+	return a + b;
+}
+
+static void sum_inner(int *element, void *context)
+{
+	(void)context;
+	*element = vector_parallel_reduce(&inner, 0, add, NULL);
+}
+
+void setUp(void)
+{
+	vector_core_parallel_set_threads(4);
+}
+
+void tearDown(void)
+{
+}
+
+void test_fill_and_for_each(void)
+{
+	Vector vec = { 0 };
+	int step = 3;
+	size_t idx = 0;
+
+	vector_resize(&vec, SIZE);
+	vector_parallel_fill(&vec, 7);
+	vector_parallel_for_each(&vec, increment, &step);
+
+	for (idx = 0; idx < SIZE; idx++) {
+		TEST_ASSERT_EQUAL_INT(10, vec.begin[idx]);
+	}
+
+	vector_free(&vec);
+}
+
+void test_transform(void)
+{
+	Vector src = { 0 };
+	Vector dest = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&src, idx % 1000);
+	}
+	vector_push(&dest, -1);
+
+	vector_parallel_transform(&dest, &src, square, NULL);
+	TEST_ASSERT_EQUAL_UINT(SIZE, VECTOR_SIZE(&dest));
+	for (idx = 0; idx < SIZE; idx++) {
+		TEST_ASSERT_EQUAL_INT((idx % 1000) * (idx % 1000),
+				      dest.begin[idx]);
+	}
+
+	/* In place */
+	vector_parallel_transform(&src, &src, square, NULL);
+	TEST_ASSERT_EQUAL_INT_ARRAY(dest.begin, src.begin, SIZE);
+
+	vector_free(&src);
+	vector_free(&dest);
+}
+
+void test_reduce(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(42, vector_parallel_reduce(&vec, 42, add, NULL));
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&vec, idx % 7);
+	}
+	TEST_ASSERT_EQUAL_INT(299995, vector_parallel_reduce(&vec, 0, add,
+							     NULL));
+
+	vector_free(&vec);
+}
+
+void test_reduce_order_independent_of_threads(void)
+{
+	DoubleVector vec = { 0 };
+	double sums[3];
+	size_t threads[3] = { 1, 2, 7 };
+	size_t idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		double_vector_push(&vec, 1.0 / (double)(idx + 1));
+	}
+	for (idx = 0; idx < 3; idx++) {
+		vector_core_parallel_set_threads(threads[idx]);
+		sums[idx] = double_vector_parallel_reduce(&vec, 0.0, add_double,
+							  NULL);
+	}
+
+	/* Bitwise identical, not only close */
+	TEST_ASSERT_TRUE(sums[0] == sums[1]);
+	TEST_ASSERT_TRUE(sums[0] == sums[2]);
+
+	double_vector_free(&vec);
+}
+
+void test_nested_loops_run_serially(void)
+{
+	Vector outer = { 0 };
+	size_t idx = 0;
+
+	vector_resize(&inner, 1000);
+	vector_parallel_fill(&inner, 1);
+	vector_resize(&outer, 1000);
+	vector_parallel_for_each(&outer, sum_inner, NULL);
+
+	for (idx = 0; idx < 1000; idx++) {
+		TEST_ASSERT_EQUAL_INT(1000, outer.begin[idx]);
+	}
+
+	vector_free(&outer);
+	vector_free(&inner);
+}
+
+void test_parallel_sort(void)
+{
+	/* Sizes around the block and chunk sizes of 64 ints, and thread counts
+	 * giving odd and even numbers of merge levels */
+	assert_parallel_sort(0, 10, 4);
+	assert_parallel_sort(1, 10, 4);
+	assert_parallel_sort(64, 1000, 4);
+	assert_parallel_sort(65, 1000, 4);
+	assert_parallel_sort(1000, 1000, 3);
+	assert_parallel_sort(SIZE, 1000000, 4);
+	assert_parallel_sort(SIZE + 17, 5, 7);
+	assert_parallel_sort(SIZE, 1000000, 2);
+	assert_parallel_sort(SIZE, 1000000, 1);
+}
+
+void test_parallel_sort_scratch(void)
+{
+	Vector vec = { 0 };
+	Vector scratch = { 0 };
+	VectorSpan span;
+	int idx = 0;
+
+	for (idx = 0; idx < SIZE; idx++) {
+		vector_push(&vec, SIZE - idx);
+	}
+	vector_resize(&scratch, SIZE);
+
+	/* Sorting the second half only, with the caller's scratch */
+	span = vector_span_subslice(vector_span(&vec), SIZE / 2, SIZE / 2);
+	vector_span_parallel_sort(span, vector_span(&scratch));
+	TEST_ASSERT_TRUE(vector_span_is_sorted(span));
+	TEST_ASSERT_EQUAL_INT(1, vec.begin[SIZE / 2]);
+	TEST_ASSERT_EQUAL_INT(SIZE, vec.begin[0]);
+
+	vector_span_parallel_sort(vector_span(&vec), vector_span(&scratch));
+	TEST_ASSERT_TRUE(vector_is_sorted(&vec));
+	TEST_ASSERT_EQUAL_INT(SIZE, vec.end[-1]);
+
+	vector_free(&vec);
+	vector_free(&scratch);
+}
+
+void test_duplicate(void)
+{
+	Vector src = { 0 };
+	Vector dest = { 0 };
+	int idx = 0;
+
+	/* Below and above VECTOR_STREAM_BYTES */
+	vector_init(&src, 100);
+	for (idx = 0; idx < 10; idx++) {
+		vector_push(&src, idx);
+	}
+	vector_parallel_duplicate(&dest, &src, 0);
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_CAPACITY(&dest));
+	TEST_ASSERT_EQUAL_INT_ARRAY(src.begin, dest.begin, 10);
+	vector_free(&dest);
+
+	for (; idx < SIZE; idx++) {
+		vector_push(&src, idx);
+	}
+	vector_parallel_duplicate(&dest, &src, 1);
+	TEST_ASSERT_EQUAL_UINT(SIZE, VECTOR_SIZE(&dest));
+	TEST_ASSERT_EQUAL_UINT(SIZE, VECTOR_CAPACITY(&dest));
+	TEST_ASSERT_EQUAL_INT_ARRAY(src.begin, dest.begin, SIZE);
+	vector_free(&dest);
+
+	vector_clear(&src);
+	vector_parallel_duplicate(&dest, &src, 1);
+	TEST_ASSERT_NULL(dest.begin);
+
+	vector_free(&src);
+}
+
+void test_stream_copy_unaligned(void)
+{
+	unsigned char src[1000];
+	unsigned char dest[1000];
+	size_t offset = 0;
+	size_t idx = 0;
+
+	for (idx = 0; idx < sizeof(src); idx++) {
+		src[idx] = (unsigned char)(idx * 7);
+	}
+	for (offset = 0; offset < 17; offset++) {
+		memset(dest, 0, sizeof(dest));
+		vector_core_stream_copy(dest + offset, src + 3,
+					sizeof(dest) - 20);
+		TEST_ASSERT_EQUAL_MEMORY(src + 3, dest + offset,
+					 sizeof(dest) - 20);
+		TEST_ASSERT_EQUAL_UINT8(0, dest[offset + sizeof(dest) - 20]);
+	}
+}
+
+void test_empty_and_shutdown(void)
+{
+	Vector vec = { 0 };
+
+	vector_parallel_fill(&vec, 1);
+	vector_parallel_transform(&vec, &vec, square, NULL);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+
+	vector_core_parallel_shutdown();
+
+	/* The pool starts again when needed */
+	vector_resize(&vec, SIZE);
+	vector_parallel_fill(&vec, 2);
+	TEST_ASSERT_EQUAL_INT(2 * SIZE, vector_parallel_reduce(&vec, 0, add,
+							       NULL));
+
+	vector_free(&vec);
+}
+
+int main(void)
+{
+	int failures = 0;
+
+	UNITY_BEGIN();
+
+	RUN_TEST(test_fill_and_for_each);
+	RUN_TEST(test_transform);
+	RUN_TEST(test_reduce);
+	RUN_TEST(test_reduce_order_independent_of_threads);
+	RUN_TEST(test_nested_loops_run_serially);
+	RUN_TEST(test_parallel_sort);
+	RUN_TEST(test_parallel_sort_scratch);
+	RUN_TEST(test_duplicate);
+	RUN_TEST(test_stream_copy_unaligned);
+	RUN_TEST(test_empty_and_shutdown);
+
+	failures = UNITY_END();
+	vector_core_parallel_shutdown();
+	return failures;
+}
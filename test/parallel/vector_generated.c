@@ -0,0 +1,10 @@
+#include "vector_generated.h"
+
+#define INT_LESS(a, b) ((a) < (b))
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_PARALLEL(Vector, vector, int)
+VECTOR_DEFINE_SORT(Vector, vector, int, INT_LESS)
+VECTOR_DEFINE_CORE(DoubleVector, double_vector, double)
+VECTOR_DEFINE_PARALLEL(DoubleVector, double_vector, double)
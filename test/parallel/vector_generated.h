@@ -0,0 +1,20 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_PARALLEL 1
+/* Small chunks, for many of them even on small vectors */
+#define VECTOR_PARALLEL_GRAIN_BYTES 256
+#define VECTOR_STREAM_BYTES 4096
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_PARALLEL(Vector, vector, int)
+VECTOR_DECLARE_SORT(Vector, vector)
+VECTOR_DECLARE(DoubleVector, double_vector, double)
+VECTOR_DECLARE_PARALLEL(DoubleVector, double_vector, double)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,261 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define VALUES 20000
+#define BATCH 7
+#define PRODUCERS 2
+#define CONSUMERS 2
+
+jmp_buf abort_jmp;
+
+static VectorSpsc spsc;
+static VectorMpmc mpmc;
+static unsigned char *seen;
+static VECTOR_ATOMIC(size_t) consumed;
+
+static void *spsc_produce(void *arg)
+{
+	int values[BATCH];
+	int next = 0;
+	size_t pushed = 0;
+	size_t i = 0;
+
+	(void)arg;
+	while (next < VALUES) {
+		for (i = 0; i < BATCH; i++) {
+			values[i] = next + (int)i;
+		}
+		pushed = vector_spsc_push_batch(&spsc, values,
+						VALUES - next < BATCH
+							? (size_t)(VALUES - next)
+							: BATCH);
+		if (pushed == 0) {
+			(void)sched_yield();
+		}
+		next += (int)pushed;
+	}
+	return NULL;
+}
+
+static void *mpmc_produce(void *arg)
+{
+	int first = *(int *)arg;
+	int last = first + VALUES / PRODUCERS;
+	int values[2];
+	size_t pushed = 0;
+
+	/* Alternates between single and batched pushes */
+	while (first < last) {
+		values[0] = first;
+		values[1] = first + 1;
+		if (first % 2 == 0 && first + 1 < last) {
+			pushed = vector_mpmc_push_batch(&mpmc, values, 2);
+		} else {
+			pushed = (size_t)vector_mpmc_push(&mpmc, first);
+		}
+		if (pushed == 0) {
+			(void)sched_yield();
+		}
+		first += (int)pushed;
+	}
+	return NULL;
+}
+
+static void *mpmc_consume(void *arg)
+{
+	int values[BATCH];
+	size_t popped = 0;
+	size_t i = 0;
+
+	(void)arg;
+	while (VECTOR_ATOMIC_LOAD(&consumed) < VALUES) {
+		popped = vector_mpmc_pop_batch(&mpmc, values, BATCH);
+		if (popped == 0) {
+			(void)sched_yield();
+			continue;
+		}
+		for (i = 0; i < popped; i++) {
+			if (values[i] < 0 || values[i] >= VALUES
+			    || seen[values[i]]) {
+				return &mpmc;
+			}
+			seen[values[i]] = 1;
+		}
+		(void)VECTOR_ATOMIC_FETCH_ADD(&consumed, popped);
+	}
+	return NULL;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_spsc_push_pop(void)
+{
+	int values[8] = { 0 };
+	int value = 0;
+	int i = 0;
+
+	/* Apart enough to never share a line, however the queue is aligned */
+	TEST_ASSERT_TRUE(offsetof(VectorSpsc, head) >= 2 * VECTOR_CACHE_LINE);
+	TEST_ASSERT_TRUE(offsetof(VectorSpsc, tail) - offsetof(VectorSpsc, head)
+			 >= 2 * VECTOR_CACHE_LINE);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spsc_init(&spsc, 3));
+	TEST_ASSERT_EQUAL_UINT(3, spsc.mask);
+
+	TEST_ASSERT_EQUAL_INT(0, vector_spsc_pop(&spsc, &value));
+	for (i = 0; i < 4; i++) {
+		TEST_ASSERT_EQUAL_INT(1, vector_spsc_push(&spsc, i));
+	}
+	TEST_ASSERT_EQUAL_INT(0, vector_spsc_push(&spsc, 4));
+	TEST_ASSERT_EQUAL_INT(1, vector_spsc_pop(&spsc, &value));
+	TEST_ASSERT_EQUAL_INT(0, value);
+
+	/* Batches wrap around the end of the ring and stop when full */
+	values[0] = 10;
+	values[1] = 11;
+	TEST_ASSERT_EQUAL_UINT(1, vector_spsc_push_batch(&spsc, values, 2));
+	TEST_ASSERT_EQUAL_UINT(4, vector_spsc_pop_batch(&spsc, values, 8));
+	TEST_ASSERT_EQUAL_INT(1, values[0]);
+	TEST_ASSERT_EQUAL_INT(3, values[2]);
+	TEST_ASSERT_EQUAL_INT(10, values[3]);
+	TEST_ASSERT_EQUAL_UINT(0, vector_spsc_pop_batch(&spsc, values, 8));
+
+	vector_spsc_free(&spsc);
+	TEST_ASSERT_NULL(spsc.begin);
+}
+
+void test_spsc_threads(void)
+{
+	pthread_t producer;
+	int values[BATCH];
+	int expected = 0;
+	size_t popped = 0;
+	size_t i = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spsc_init(&spsc, 64));
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, spsc_produce,
+						NULL));
+
+	while (expected < VALUES) {
+		popped = vector_spsc_pop_batch(&spsc, values, BATCH);
+		if (popped == 0) {
+			(void)sched_yield();
+		}
+		for (i = 0; i < popped; i++) {
+			TEST_ASSERT_EQUAL_INT(expected++, values[i]);
+		}
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+	vector_spsc_free(&spsc);
+}
+
+void test_mpmc_push_pop(void)
+{
+	int values[4] = { 1, 2, 3, 4 };
+	int value = 0;
+
+	TEST_ASSERT_TRUE(offsetof(VectorMpmc, dequeue_pos)
+				 - offsetof(VectorMpmc, enqueue_pos)
+			 >= 2 * VECTOR_CACHE_LINE);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_mpmc_init(&mpmc, 4));
+	TEST_ASSERT_EQUAL_INT(0, vector_mpmc_pop(&mpmc, &value));
+	TEST_ASSERT_EQUAL_UINT(3, vector_mpmc_push_batch(&mpmc, values, 3));
+	TEST_ASSERT_EQUAL_UINT(1, vector_mpmc_push_batch(&mpmc, values, 4));
+	TEST_ASSERT_EQUAL_INT(0, vector_mpmc_push(&mpmc, 5));
+
+	TEST_ASSERT_EQUAL_INT(1, vector_mpmc_pop(&mpmc, &value));
+	TEST_ASSERT_EQUAL_INT(1, value);
+	TEST_ASSERT_EQUAL_INT(1, vector_mpmc_push(&mpmc, 5));
+	TEST_ASSERT_EQUAL_UINT(4, vector_mpmc_pop_batch(&mpmc, values, 4));
+	TEST_ASSERT_EQUAL_INT(2, values[0]);
+	TEST_ASSERT_EQUAL_INT(1, values[2]);
+	TEST_ASSERT_EQUAL_INT(5, values[3]);
+	TEST_ASSERT_EQUAL_UINT(0, vector_mpmc_pop_batch(&mpmc, values, 4));
+
+	vector_mpmc_free(&mpmc);
+}
+
+void test_mpmc_threads(void)
+{
+	pthread_t producers[PRODUCERS];
+	pthread_t consumers[CONSUMERS];
+	int firsts[PRODUCERS];
+	void *result = NULL;
+	int i = 0;
+
+	seen = calloc(VALUES, 1);
+	TEST_ASSERT_NOT_NULL(seen);
+	VECTOR_ATOMIC_STORE(&consumed, 0);
+	TEST_ASSERT_EQUAL_INT(1, vector_mpmc_init(&mpmc, 16));
+
+	for (i = 0; i < CONSUMERS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumers[i], NULL,
+							mpmc_consume, NULL));
+	}
+	for (i = 0; i < PRODUCERS; i++) {
+		firsts[i] = i * (VALUES / PRODUCERS);
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL,
+							mpmc_produce,
+							&firsts[i]));
+	}
+	for (i = 0; i < PRODUCERS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(producers[i], NULL));
+	}
+	for (i = 0; i < CONSUMERS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(consumers[i], &result));
+		TEST_ASSERT_NULL(result);
+	}
+
+	for (i = 0; i < VALUES; i++) {
+		TEST_ASSERT_EQUAL_INT(1, seen[i]);
+	}
+	free(seen);
+	vector_mpmc_free(&mpmc);
+}
+
+void test_vector_messages(void)
+{
+	MessageVectorSpsc queue;
+	Vector message = { 0 };
+	Vector received = { 0 };
+
+	TEST_ASSERT_EQUAL_INT(1, message_vector_spsc_init(&queue, 2));
+	vector_push(&message, 42);
+	TEST_ASSERT_EQUAL_INT(1, message_vector_spsc_push(&queue, message));
+
+	/* The storage changed hands: only the receiver frees it */
+	TEST_ASSERT_EQUAL_INT(1, message_vector_spsc_pop(&queue, &received));
+	TEST_ASSERT_EQUAL_PTR(message.begin, received.begin);
+	TEST_ASSERT_EQUAL_INT(42, vector_get(&received, 0));
+
+	vector_free(&received);
+	message_vector_spsc_free(&queue);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_spsc_push_pop);
+	RUN_TEST(test_spsc_threads);
+	RUN_TEST(test_mpmc_push_pop);
+	RUN_TEST(test_mpmc_threads);
+	RUN_TEST(test_vector_messages);
+
+	return UNITY_END();
+}
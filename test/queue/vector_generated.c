@@ -0,0 +1,7 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_QUEUE(Vector, vector, int)
+VECTOR_DEFINE_CORE(MessageVector, message_vector, Vector)
+VECTOR_DEFINE_QUEUE(MessageVector, message_vector, Vector)
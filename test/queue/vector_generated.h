@@ -0,0 +1,14 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_QUEUE(Vector, vector, int)
+
+/* Queues of vectors, handing their storage over between threads */
+VECTOR_DECLARE(MessageVector, message_vector, Vector)
+VECTOR_DECLARE_QUEUE(MessageVector, message_vector, Vector)
+
+#endif /* VECTOR_GENERATED_H */
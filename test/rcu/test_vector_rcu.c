@@ -0,0 +1,160 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <pthread.h>
+#include <sched.h>
+
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define READERS 3
+#define PUSHES 100000
+
+jmp_buf abort_jmp;
+
+static VectorRcu shared;
+
+static void *push_values(void *arg)
+{
+	int i = 0;
+
+	(void)arg;
+	for (i = 0; i < PUSHES; i++) {
+		vector_rcu_push(&shared, i);
+		if (i % 1000 == 0) {
+			(void)sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/* Every snapshot must hold 0, 1, 2... up to its size, even when the writer
+ * grows meanwhile */
+static void *scan_snapshots(void *arg)
+{
+	size_t reader = *(size_t *)arg;
+	VectorSpan span = { 0 };
+	const int *i = NULL;
+	int expected = 0;
+
+	while (VECTOR_SIZE(&span) < PUSHES) {
+		span = vector_rcu_read_begin(&shared, reader);
+		(void)sched_yield();
+		for (i = span.begin, expected = 0; i < span.end; i++) {
+			if (*i != expected++) {
+				vector_rcu_read_end(&shared, reader);
+				return &shared;
+			}
+		}
+		vector_rcu_read_end(&shared, reader);
+	}
+	return NULL;
+}
+
+void setUp(void)
+{
+	vector_rcu_init(&shared);
+}
+
+void tearDown(void)
+{
+	vector_rcu_free(&shared);
+}
+
+void test_push_and_read(void)
+{
+	VectorSpan span = { 0 };
+	int i = 0;
+
+	span = vector_rcu_read_begin(&shared, 0);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&span));
+	vector_rcu_read_end(&shared, 0);
+
+	for (i = 0; i < 100; i++) {
+		vector_rcu_push(&shared, i);
+	}
+	TEST_ASSERT_EQUAL_UINT(100, vector_rcu_size(&shared));
+
+	span = vector_rcu_read_begin(&shared, 0);
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_SIZE(&span));
+	TEST_ASSERT_EQUAL_INT(42, vector_span_get(span, 42));
+	vector_rcu_read_end(&shared, 0);
+
+	/* Nobody reads while growing: old buffers are reclaimed at once */
+	TEST_ASSERT_NULL(shared.retired);
+}
+
+void test_reader_delays_reclamation(void)
+{
+	VectorSpan span = { 0 };
+	int i = 0;
+
+	for (i = 0; i < VECTOR_DEFAULT_CAPACITY; i++) {
+		vector_rcu_push(&shared, i);
+	}
+
+	span = vector_rcu_read_begin(&shared, 1);
+	for (i = VECTOR_DEFAULT_CAPACITY; i < 100; i++) {
+		vector_rcu_push(&shared, i);
+	}
+
+	/* The snapshot still points to the first buffer, full and retired */
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY, VECTOR_SIZE(&span));
+	TEST_ASSERT_EQUAL_INT(VECTOR_DEFAULT_CAPACITY - 1,
+			      span.begin[VECTOR_DEFAULT_CAPACITY - 1]);
+	TEST_ASSERT_NOT_NULL(shared.retired);
+	TEST_ASSERT_TRUE(vector_rcu_reclaim(&shared) > 0);
+
+	vector_rcu_read_end(&shared, 1);
+	TEST_ASSERT_EQUAL_UINT(0, vector_rcu_reclaim(&shared));
+	TEST_ASSERT_NULL(shared.retired);
+}
+
+void test_concurrent_readers(void)
+{
+	pthread_t writer;
+	pthread_t readers[READERS];
+	size_t ids[READERS];
+	void *result = NULL;
+	size_t i = 0;
+
+	for (i = 0; i < READERS; i++) {
+		ids[i] = i;
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], NULL,
+							scan_snapshots,
+							&ids[i]));
+	}
+	TEST_ASSERT_EQUAL_INT(0,
+			      pthread_create(&writer, NULL, push_values, NULL));
+
+	TEST_ASSERT_EQUAL_INT(0, pthread_join(writer, NULL));
+	for (i = 0; i < READERS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(readers[i], &result));
+		TEST_ASSERT_NULL(result);
+	}
+	TEST_ASSERT_EQUAL_UINT(PUSHES, vector_rcu_size(&shared));
+	TEST_ASSERT_EQUAL_UINT(0, vector_rcu_reclaim(&shared));
+}
+
+void test_reader_out_of_range(void)
+{
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_rcu_read_begin(&shared, VECTOR_RCU_READERS);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_push_and_read);
+	RUN_TEST(test_reader_delays_reclamation);
+	RUN_TEST(test_concurrent_readers);
+	RUN_TEST(test_reader_out_of_range);
+
+	return UNITY_END();
+}
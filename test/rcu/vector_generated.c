@@ -0,0 +1,5 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE_CORE(Vector, vector, int)
+VECTOR_DEFINE_RCU(Vector, vector, int)
@@ -0,0 +1,79 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_core_access(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 100; idx++) {
+		vector_push(&vec, idx);
+	}
+	vector_set(&vec, 0, -1);
+
+	TEST_ASSERT_EQUAL_UINT(100, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(-1, vector_get(&vec, 0));
+	TEST_ASSERT_EQUAL_INT(99, vector_pop(&vec));
+	TEST_ASSERT_EQUAL_INT(98, vector_get(&vec, 98));
+
+	vector_free(&vec);
+}
+
+void test_core_access_out_of_range(void)
+{
+	Vector vec = { 0 };
+
+	vector_push(&vec, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_get(&vec, 1);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	vector_free(&vec);
+	TEST_FAIL();
+}
+
+void test_edit_duplicate(void)
+{
+	EditVector vec = { 0 };
+	EditVector copy = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 10; idx++) {
+		edit_vector_insert(&vec, 0, idx);
+	}
+	edit_vector_delete(&vec, 0);
+	edit_vector_duplicate(&copy, &vec);
+
+	TEST_ASSERT_EQUAL_UINT(9, VECTOR_SIZE(&copy));
+	for (idx = 0; idx < 9; idx++) {
+		TEST_ASSERT_EQUAL_INT(8 - idx, copy.begin[idx]);
+	}
+
+	edit_vector_free(&vec);
+	edit_vector_free(&copy);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_core_access);
+	RUN_TEST(test_core_access_out_of_range);
+	RUN_TEST(test_edit_duplicate);
+
+	return UNITY_END();
+}
@@ -0,0 +1,8 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_CORE(Vector, vector, int)
+VECTOR_DEFINE_ACCESS(Vector, vector, int)
+
+VECTOR_DEFINE_CORE(EditVector, edit_vector, int)
+VECTOR_DEFINE_EDIT(EditVector, edit_vector, int)
+VECTOR_DEFINE_DUPLICATE(EditVector, edit_vector, int)
@@ -0,0 +1,266 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_save_load_stream(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	FILE *stream = tmpfile();
+	int i = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	for (i = 0; i < 1000; i++) {
+		vector_push(&vec, i * 3);
+	}
+
+	TEST_ASSERT_EQUAL_INT(1, vector_save(&vec, stream));
+	TEST_ASSERT_EQUAL_INT((long)vector_serialized_size(&vec),
+			      ftell(stream));
+
+	rewind(stream);
+	TEST_ASSERT_EQUAL_INT(1, vector_load(&loaded, stream));
+	TEST_ASSERT_EQUAL_UINT(1000, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_UINT(1000, VECTOR_CAPACITY(&loaded));
+	TEST_ASSERT_EQUAL_INT_ARRAY(vec.begin, loaded.begin, 1000);
+
+	(void)fclose(stream);
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+void test_load_replaces_contents(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	FILE *stream = tmpfile();
+	int i = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	vector_push(&vec, 7);
+	vector_push(&vec, 8);
+	TEST_ASSERT_EQUAL_INT(1, vector_save(&vec, stream));
+
+	for (i = 0; i < 20; i++) {
+		vector_push(&loaded, -1);
+	}
+	rewind(stream);
+	TEST_ASSERT_EQUAL_INT(1, vector_load(&loaded, stream));
+	TEST_ASSERT_EQUAL_UINT(2, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_INT(7, loaded.begin[0]);
+	TEST_ASSERT_EQUAL_INT(8, loaded.begin[1]);
+
+	(void)fclose(stream);
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+void test_empty_vector(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE];
+
+	TEST_ASSERT_EQUAL_UINT(VECTOR_SERIAL_HEADER_SIZE,
+			       vector_serialized_size(&vec));
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_INT(1, vector_load_buffer(&loaded, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_NULL(loaded.begin);
+}
+
+void test_buffer_round_trip(void)
+{
+	PointVector points = { 0 };
+	PointVector loaded = { 0 };
+	Point point = { 1, 2 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE + 3 * sizeof(Point)];
+
+	point_vector_push(&points, point);
+	point.x = 3;
+	point_vector_push(&points, point);
+	point.y = 4;
+	point_vector_push(&points, point);
+
+	TEST_ASSERT_EQUAL_UINT(sizeof(buffer),
+			       point_vector_serialized_size(&points));
+	TEST_ASSERT_EQUAL_INT(0, point_vector_save_buffer(&points, buffer,
+							  sizeof(buffer) - 1));
+	TEST_ASSERT_EQUAL_INT(1, point_vector_save_buffer(&points, buffer,
+							  sizeof(buffer)));
+	TEST_ASSERT_EQUAL_MEMORY("VECTOR", buffer, 6);
+
+	TEST_ASSERT_EQUAL_INT(0, point_vector_load_buffer(&loaded, buffer,
+							  sizeof(buffer) - 1));
+	TEST_ASSERT_EQUAL_INT(1, point_vector_load_buffer(&loaded, buffer,
+							  sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_MEMORY(points.begin, loaded.begin,
+				 3 * sizeof(Point));
+
+	point_vector_free(&points);
+	point_vector_free(&loaded);
+}
+
+void test_rejects_corrupted_data(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE + 2 * sizeof(int)];
+
+	vector_push(&vec, 1);
+	vector_push(&vec, 2);
+	vector_push(&loaded, 5);
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, buffer,
+						    sizeof(buffer)));
+
+	buffer[sizeof(buffer) - 1] ^= 1;
+	TEST_ASSERT_EQUAL_INT(0, vector_load_buffer(&loaded, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+	buffer[sizeof(buffer) - 1] ^= 1;
+
+	buffer[0] = 'X';
+	TEST_ASSERT_EQUAL_INT(0, vector_load_buffer(&loaded, buffer,
+						    sizeof(buffer)));
+	buffer[0] = 'V';
+
+	TEST_ASSERT_EQUAL_INT(1, vector_load_buffer(&loaded, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(2, VECTOR_SIZE(&loaded));
+
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+void test_rejects_other_element_size(void)
+{
+	Vector vec = { 0 };
+	PointVector points = { 0 };
+	FILE *stream = tmpfile();
+
+	TEST_ASSERT_NOT_NULL(stream);
+	vector_push(&vec, 1);
+	vector_push(&vec, 2);
+	TEST_ASSERT_EQUAL_INT(1, vector_save(&vec, stream));
+
+	rewind(stream);
+	TEST_ASSERT_EQUAL_INT(0, point_vector_load(&points, stream));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&points));
+
+	(void)fclose(stream);
+	vector_free(&vec);
+	point_vector_free(&points);
+}
+
+void test_rejects_truncated_stream(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE + 4 * sizeof(int)];
+	FILE *stream = tmpfile();
+	int i = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	for (i = 0; i < 4; i++) {
+		vector_push(&vec, i);
+	}
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(sizeof(buffer) - 1,
+			       fwrite(buffer, 1, sizeof(buffer) - 1, stream));
+
+	rewind(stream);
+	TEST_ASSERT_EQUAL_INT(0, vector_load(&loaded, stream));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+
+	(void)fclose(stream);
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+static int load_with_count(const unsigned char *buffer, size_t buffer_size,
+			   int count_byte, unsigned char value, Vector *loaded)
+{
+	unsigned char corrupted[VECTOR_SERIAL_HEADER_SIZE + 4 * sizeof(int)];
+	FILE *stream = tmpfile();
+	int ret = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	memcpy(corrupted, buffer, buffer_size);
+	/* The element count is 8 bytes little-endian at offset 16 */
+	corrupted[16 + count_byte] = value;
+	TEST_ASSERT_EQUAL_UINT(buffer_size,
+			       fwrite(corrupted, 1, buffer_size, stream));
+
+	rewind(stream);
+	ret = vector_load(loaded, stream);
+	(void)fclose(stream);
+	return ret;
+}
+
+void test_rejects_corrupted_count(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE + 4 * sizeof(int)];
+	int i = 0;
+
+	for (i = 0; i < 4; i++) {
+		vector_push(&vec, i);
+	}
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, buffer,
+						    sizeof(buffer)));
+
+	/* 16 GiB of ints claimed, 16 bytes present */
+	TEST_ASSERT_EQUAL_INT(0, load_with_count(buffer, sizeof(buffer), 4, 1,
+						 &loaded));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+	TEST_ASSERT(VECTOR_CAPACITY(&loaded) * sizeof(int)
+		    <= VECTOR_SERIAL_CHUNK_BYTES);
+
+	/* A plausible count, past the end of the stream */
+	TEST_ASSERT_EQUAL_INT(0, load_with_count(buffer, sizeof(buffer), 0, 100,
+						 &loaded));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+
+	/* Fewer elements than saved fail the checksum */
+	TEST_ASSERT_EQUAL_INT(0, load_with_count(buffer, sizeof(buffer), 0, 3,
+						 &loaded));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&loaded));
+
+	TEST_ASSERT_EQUAL_INT(1, load_with_count(buffer, sizeof(buffer), 0, 4,
+						 &loaded));
+	TEST_ASSERT_EQUAL_UINT(4, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_INT(3, vector_get(&loaded, 3));
+
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_save_load_stream);
+	RUN_TEST(test_load_replaces_contents);
+	RUN_TEST(test_empty_vector);
+	RUN_TEST(test_buffer_round_trip);
+	RUN_TEST(test_rejects_corrupted_data);
+	RUN_TEST(test_rejects_other_element_size);
+	RUN_TEST(test_rejects_truncated_stream);
+	RUN_TEST(test_rejects_corrupted_count);
+
+	return UNITY_END();
+}
@@ -0,0 +1,7 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SERIAL(Vector, vector, int)
+VECTOR_DEFINE(PointVector, point_vector, Point)
+VECTOR_DEFINE_SERIAL(PointVector, point_vector, Point)
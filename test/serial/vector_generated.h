@@ -0,0 +1,17 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+typedef struct Point {
+	int x;
+	int y;
+} Point;
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SERIAL(Vector, vector)
+VECTOR_DECLARE(PointVector, point_vector, Point)
+VECTOR_DECLARE_SERIAL(PointVector, point_vector)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,145 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <pthread.h>
+
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define THREADS 4
+#define PER_THREAD 10000
+
+jmp_buf abort_jmp;
+
+static VectorSharded sharded;
+static Vector gathered;
+static pthread_barrier_t barrier;
+
+static void *collect_and_gather(void *arg)
+{
+	size_t shard = *(size_t *)arg;
+	Vector *vec = vector_sharded_shard(&sharded, shard);
+	int value = 0;
+
+	for (value = 0; value < PER_THREAD; value++) {
+		vector_push(vec, (int)shard * PER_THREAD + value);
+	}
+
+	/* Thread 0 sizes the output once every shard is complete, then each
+	 * thread copies its own shard */
+	(void)pthread_barrier_wait(&barrier);
+	if (shard == 0 && !vector_sharded_gather_begin(&sharded, &gathered)) {
+		return &sharded;
+	}
+	(void)pthread_barrier_wait(&barrier);
+	vector_sharded_gather_shard(&sharded, &gathered, shard);
+	return NULL;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_shards_are_isolated(void)
+{
+	TEST_ASSERT_EQUAL_INT(1, vector_sharded_init(&sharded, 3));
+	TEST_ASSERT_EQUAL_UINT(3, sharded.count);
+	TEST_ASSERT_TRUE(sizeof(VectorShard) >= 2 * VECTOR_CACHE_LINE);
+	TEST_ASSERT_EQUAL_UINT(0, vector_sharded_size(&sharded));
+
+	vector_push(vector_sharded_shard(&sharded, 0), 1);
+	vector_push(vector_sharded_shard(&sharded, 2), 2);
+	vector_push(vector_sharded_shard(&sharded, 2), 3);
+	TEST_ASSERT_EQUAL_UINT(3, vector_sharded_size(&sharded));
+	TEST_ASSERT_EQUAL_UINT(
+		0, VECTOR_SIZE(vector_sharded_shard(&sharded, 1)));
+
+	vector_sharded_free(&sharded);
+	TEST_ASSERT_NULL(sharded.shards);
+	TEST_ASSERT_EQUAL_UINT(0, sharded.count);
+}
+
+void test_gather_appends_in_shard_order(void)
+{
+	Vector out = { 0 };
+
+	TEST_ASSERT_EQUAL_INT(1, vector_sharded_init(&sharded, 3));
+	vector_push(&out, -1);
+	vector_push(vector_sharded_shard(&sharded, 2), 4);
+	vector_push(vector_sharded_shard(&sharded, 0), 1);
+	vector_push(vector_sharded_shard(&sharded, 0), 2);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_sharded_gather(&sharded, &out));
+	TEST_ASSERT_EQUAL_UINT(4, VECTOR_SIZE(&out));
+	TEST_ASSERT_EQUAL_INT(-1, out.begin[0]);
+	TEST_ASSERT_EQUAL_INT(1, out.begin[1]);
+	TEST_ASSERT_EQUAL_INT(2, out.begin[2]);
+	TEST_ASSERT_EQUAL_INT(4, out.begin[3]);
+
+	/* The shards are left as they were */
+	TEST_ASSERT_EQUAL_UINT(3, vector_sharded_size(&sharded));
+
+	vector_sharded_free(&sharded);
+	vector_free(&out);
+}
+
+void test_parallel_collect_and_gather(void)
+{
+	pthread_t threads[THREADS];
+	size_t shards[THREADS];
+	void *result = NULL;
+	size_t i = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_sharded_init(&sharded, THREADS));
+	TEST_ASSERT_EQUAL_INT(0, pthread_barrier_init(&barrier, NULL,
+						      THREADS));
+	for (i = 0; i < THREADS; i++) {
+		shards[i] = i;
+		TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL,
+							collect_and_gather,
+							&shards[i]));
+	}
+	for (i = 0; i < THREADS; i++) {
+		TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[i], &result));
+		TEST_ASSERT_NULL(result);
+	}
+	TEST_ASSERT_EQUAL_INT(0, pthread_barrier_destroy(&barrier));
+
+	TEST_ASSERT_EQUAL_UINT(THREADS * PER_THREAD, VECTOR_SIZE(&gathered));
+	for (i = 0; i < THREADS * PER_THREAD; i++) {
+		TEST_ASSERT_EQUAL_INT((int)i, gathered.begin[i]);
+	}
+
+	vector_sharded_free(&sharded);
+	vector_free(&gathered);
+}
+
+void test_shard_out_of_range(void)
+{
+	TEST_ASSERT_EQUAL_INT(1, vector_sharded_init(&sharded, 2));
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_sharded_shard(&sharded, 2);
+	} else {
+		vector_sharded_free(&sharded);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_shards_are_isolated);
+	RUN_TEST(test_gather_appends_in_shard_order);
+	RUN_TEST(test_parallel_collect_and_gather);
+	RUN_TEST(test_shard_out_of_range);
+
+	return UNITY_END();
+}
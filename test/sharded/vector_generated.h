@@ -0,0 +1,10 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SHARDED(Vector, vector, int)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,196 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static Point make_point(int idx)
+{
+	Point point;
+
+	point.x = idx;
+	point.y = -idx;
+	point.tag = (char)('a' + idx % 26);
+	return point;
+}
+
+void test_init_grow(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	vector_init(&vec, 10);
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+
+	vector_resize(&vec, 3);
+	for (idx = 11; idx < 1000; idx++) {
+		vector_grow(&vec, idx);
+		TEST_ASSERT_EQUAL_UINT(idx, VECTOR_CAPACITY(&vec));
+		TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&vec));
+	}
+
+	vector_free(&vec);
+}
+
+void test_grow_from_zero(void)
+{
+	Vector vec = { 0 };
+
+	vector_grow(&vec, 5);
+
+	TEST_ASSERT_EQUAL_UINT(5, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+	TEST_ASSERT_NOT_NULL(vec.begin);
+
+	vector_free(&vec);
+}
+
+void test_shrink_abort(void)
+{
+	Vector vec = { 0 };
+	vector_init(&vec, 10);
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_grow(&vec, 5);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	vector_free(&vec);
+	TEST_FAIL();
+}
+
+void test_grow_overflow(void)
+{
+	PointVector vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		point_vector_grow(&vec, (size_t)-1);
+	} else {
+		TEST_ASSERT_NULL(vec.begin);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_insert_delete(void)
+{
+	Vector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 100; idx++) {
+		vector_insert(&vec, 0, idx);
+	}
+	vector_insert(&vec, 50, -1);
+	vector_insert(&vec, VECTOR_SIZE(&vec), -2);
+
+	TEST_ASSERT_EQUAL_UINT(102, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(99, vector_get(&vec, 0));
+	TEST_ASSERT_EQUAL_INT(-1, vector_get(&vec, 50));
+	TEST_ASSERT_EQUAL_INT(49, vector_get(&vec, 51));
+	TEST_ASSERT_EQUAL_INT(-2, vector_get(&vec, 101));
+
+	vector_delete(&vec, 101);
+	vector_delete(&vec, 50);
+	vector_delete(&vec, 0);
+
+	TEST_ASSERT_EQUAL_UINT(99, VECTOR_SIZE(&vec));
+	for (idx = 0; idx < 99; idx++) {
+		TEST_ASSERT_EQUAL_INT(98 - idx, vector_get(&vec, idx));
+	}
+
+	vector_free(&vec);
+}
+
+void test_try_insert(void)
+{
+	Vector vec = { 0 };
+
+	vector_init(&vec, 2);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_try_insert(&vec, 0, 1));
+	TEST_ASSERT_EQUAL_INT(1, vector_try_insert(&vec, 0, 2));
+	TEST_ASSERT_EQUAL_INT(0, vector_try_insert(&vec, 0, 3));
+	TEST_ASSERT_EQUAL_INT(2, vector_get(&vec, 0));
+	TEST_ASSERT_EQUAL_INT(1, vector_get(&vec, 1));
+
+	vector_free(&vec);
+}
+
+void test_struct_elements(void)
+{
+	PointVector vec = { 0 };
+	PointVector copy = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 50; idx++) {
+		point_vector_insert(&vec, VECTOR_SIZE(&vec) / 2, make_point(idx));
+	}
+	point_vector_delete(&vec, 10);
+
+	point_vector_duplicate(&copy, &vec);
+
+	TEST_ASSERT_EQUAL_UINT(49, VECTOR_SIZE(&copy));
+	TEST_ASSERT_EQUAL_UINT(VECTOR_CAPACITY(&vec), VECTOR_CAPACITY(&copy));
+	TEST_ASSERT_EQUAL_MEMORY(vec.begin, copy.begin,
+				 VECTOR_SIZE(&vec) * sizeof(Point));
+
+	point_vector_free(&vec);
+	point_vector_free(&copy);
+}
+
+void test_duplicate_from_zero(void)
+{
+	Vector vec = { 0 };
+	Vector copy = { 0 };
+
+	vector_duplicate(&copy, &vec);
+
+	TEST_ASSERT_NULL(copy.begin);
+	TEST_ASSERT_NULL(copy.end);
+	TEST_ASSERT_NULL(copy.end_of_storage);
+}
+
+void test_delete_out_of_range(void)
+{
+	Vector vec = { 0 };
+
+	vector_push(&vec, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		vector_delete(&vec, 1);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	vector_free(&vec);
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_init_grow);
+	RUN_TEST(test_grow_from_zero);
+	RUN_TEST(test_shrink_abort);
+	RUN_TEST(test_grow_overflow);
+	RUN_TEST(test_insert_delete);
+	RUN_TEST(test_try_insert);
+	RUN_TEST(test_struct_elements);
+	RUN_TEST(test_duplicate_from_zero);
+	RUN_TEST(test_delete_out_of_range);
+
+	return UNITY_END();
+}
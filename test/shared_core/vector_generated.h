@@ -0,0 +1,17 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_SHARED_CORE 1
+#include "vector.h"
+
+typedef struct Point {
+	double x;
+	double y;
+	char tag;
+} Point;
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE(PointVector, point_vector, Point)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,262 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define SORT_INPUT "test_vector_sort_input.bin"
+#define SORT_OUTPUT "test_vector_sort_output.bin"
+
+jmp_buf abort_jmp;
+size_t failing_size;
+
+void *failing_realloc(void *pointer, size_t size)
+{
+	return size == failing_size ? NULL : realloc(pointer, size);
+}
+
+static unsigned long seed = 1;
+
+static int next_random(int range)
+{
+	seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+	return (int)((seed >> 8) % (unsigned long)range);
+}
+
+static void fill_random(Vector *vec, size_t count, int range)
+{
+	size_t i = 0;
+
+	vector_clear(vec);
+	for (i = 0; i < count; i++) {
+		vector_push(vec, next_random(range));
+	}
+}
+
+static long sum(const Vector *vec)
+{
+	const int *i = NULL;
+	long total = 0;
+
+	for (i = vec->begin; i < vec->end; i++) {
+		total += *i;
+	}
+	return total;
+}
+
+static void save_file(const char *path, const Vector *vec)
+{
+	FILE *stream = fopen(path, "wb");
+
+	TEST_ASSERT_NOT_NULL(stream);
+	TEST_ASSERT_EQUAL_INT(1, vector_save(vec, stream));
+	TEST_ASSERT_EQUAL_INT(0, fclose(stream));
+}
+
+static void load_file(const char *path, Vector *vec)
+{
+	FILE *stream = fopen(path, "rb");
+
+	TEST_ASSERT_NOT_NULL(stream);
+	TEST_ASSERT_EQUAL_INT(1, vector_load(vec, stream));
+	(void)fclose(stream);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+	(void)remove(SORT_INPUT);
+	(void)remove(SORT_OUTPUT);
+}
+
+void test_sort_in_memory(void)
+{
+	Vector vec = { 0 };
+	long total = 0;
+	size_t i = 0;
+
+	fill_random(&vec, 10000, 1000000);
+	total = sum(&vec);
+	TEST_ASSERT_EQUAL_INT(0, vector_is_sorted(&vec));
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+	TEST_ASSERT_EQUAL_INT(total, sum(&vec));
+
+	/* Many duplicates */
+	fill_random(&vec, 10000, 3);
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+
+	/* Sorted, reversed and tiny inputs */
+	vector_clear(&vec);
+	for (i = 0; i < 5000; i++) {
+		vector_push(&vec, (int)i);
+	}
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+	for (i = 0; i < 5000; i++) {
+		vec.begin[i] = 5000 - (int)i;
+	}
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+	TEST_ASSERT_EQUAL_INT(1, vec.begin[0]);
+
+	vector_resize(&vec, 1);
+	vector_sort(&vec);
+	vector_clear(&vec);
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+
+	vector_free(&vec);
+}
+
+void test_sort_with_function(void)
+{
+	PointVector points = { 0 };
+	Point point = { 0, 0 };
+	size_t i = 0;
+
+	for (i = 0; i < 100; i++) {
+		point.x = next_random(10);
+		point.y = next_random(10);
+		point_vector_push(&points, point);
+	}
+	point_vector_sort(&points);
+	TEST_ASSERT_EQUAL_INT(1, point_vector_is_sorted(&points));
+
+	point_vector_free(&points);
+}
+
+void test_sort_file_many_runs(void)
+{
+	Vector vec = { 0 };
+	Vector sorted = { 0 };
+
+	fill_random(&vec, 100000, 1000000);
+	save_file(SORT_INPUT, &vec);
+
+	/* 1000 elements in memory: 100 runs merged with 9 element buffers */
+	TEST_ASSERT_EQUAL_INT(
+		1, vector_sort_file(SORT_INPUT, SORT_OUTPUT, 1000 * sizeof(int)));
+	load_file(SORT_OUTPUT, &sorted);
+	TEST_ASSERT_EQUAL_UINT(100000, VECTOR_SIZE(&sorted));
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&sorted));
+
+	vector_sort(&vec);
+	TEST_ASSERT_EQUAL_INT_ARRAY(vec.begin, sorted.begin, 100000);
+
+	/* More runs than elements in memory: single element buffers */
+	TEST_ASSERT_EQUAL_INT(
+		1, vector_sort_file(SORT_INPUT, SORT_OUTPUT, 50 * sizeof(int)));
+	load_file(SORT_OUTPUT, &sorted);
+	TEST_ASSERT_EQUAL_INT_ARRAY(vec.begin, sorted.begin, 100000);
+
+	vector_free(&vec);
+	vector_free(&sorted);
+}
+
+void test_sort_file_in_place(void)
+{
+	Vector vec = { 0 };
+	long total = 0;
+
+	fill_random(&vec, 3000, 100);
+	total = sum(&vec);
+	save_file(SORT_INPUT, &vec);
+
+	TEST_ASSERT_EQUAL_INT(
+		1, vector_sort_file(SORT_INPUT, SORT_INPUT, 256 * sizeof(int)));
+	load_file(SORT_INPUT, &vec);
+	TEST_ASSERT_EQUAL_UINT(3000, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+	TEST_ASSERT_EQUAL_INT(total, sum(&vec));
+
+	/* Fits the budget: a single run */
+	TEST_ASSERT_EQUAL_INT(1, vector_sort_file(SORT_INPUT, SORT_OUTPUT,
+						  1 << 20));
+	vector_free(&vec);
+	load_file(SORT_OUTPUT, &vec);
+	TEST_ASSERT_EQUAL_UINT(3000, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(1, vector_is_sorted(&vec));
+
+	vector_free(&vec);
+}
+
+void test_sort_file_in_place_failure_keeps_input(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	size_t idx = 0;
+
+	fill_random(&vec, 3000, 100);
+	save_file(SORT_INPUT, &vec);
+
+	/* The merge of the 12 runs of 256 elements runs out of memory after the
+	 * output is opened */
+	failing_size = 12 * sizeof(VectorCoreRun);
+	TEST_ASSERT_EQUAL_INT(
+		0, vector_sort_file(SORT_INPUT, SORT_INPUT, 256 * sizeof(int)));
+	failing_size = 0;
+
+	load_file(SORT_INPUT, &loaded);
+	TEST_ASSERT_EQUAL_UINT(VECTOR_SIZE(&vec), VECTOR_SIZE(&loaded));
+	for (idx = 0; idx < VECTOR_SIZE(&vec); idx++) {
+		TEST_ASSERT_EQUAL_INT(vec.begin[idx], loaded.begin[idx]);
+	}
+	TEST_ASSERT_NULL(fopen(SORT_INPUT VECTOR_SORT_TEMP_SUFFIX, "rb"));
+
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+void test_sort_file_empty(void)
+{
+	Vector vec = { 0 };
+
+	save_file(SORT_INPUT, &vec);
+	TEST_ASSERT_EQUAL_INT(1, vector_sort_file(SORT_INPUT, SORT_OUTPUT, 0));
+
+	vector_push(&vec, 1);
+	load_file(SORT_OUTPUT, &vec);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+
+	vector_free(&vec);
+}
+
+void test_sort_file_rejects_invalid_input(void)
+{
+	Vector vec = { 0 };
+	FILE *stream = NULL;
+
+	TEST_ASSERT_EQUAL_INT(0, vector_sort_file("does_not_exist", SORT_OUTPUT,
+						  1 << 20));
+
+	fill_random(&vec, 1000, 1000);
+	save_file(SORT_INPUT, &vec);
+	stream = fopen(SORT_INPUT, "r+b");
+	TEST_ASSERT_NOT_NULL(stream);
+	TEST_ASSERT_EQUAL_INT(0, fseek(stream, -1, SEEK_END));
+	TEST_ASSERT_EQUAL_INT('X', fputc('X', stream));
+	TEST_ASSERT_EQUAL_INT(0, fclose(stream));
+
+	TEST_ASSERT_EQUAL_INT(0, vector_sort_file(SORT_INPUT, SORT_OUTPUT,
+						  100 * sizeof(int)));
+	TEST_ASSERT_NULL(fopen(SORT_OUTPUT, "rb"));
+
+	vector_free(&vec);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_sort_in_memory);
+	RUN_TEST(test_sort_with_function);
+	RUN_TEST(test_sort_file_many_runs);
+	RUN_TEST(test_sort_file_in_place);
+	RUN_TEST(test_sort_file_in_place_failure_keeps_input);
+	RUN_TEST(test_sort_file_empty);
+	RUN_TEST(test_sort_file_rejects_invalid_input);
+
+	return UNITY_END();
+}
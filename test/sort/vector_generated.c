@@ -0,0 +1,15 @@
+#include "vector_generated.h"
+
+#define INT_LESS(a, b) ((a) < (b))
+
+int point_less(Point a, Point b)
+{
+	return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SERIAL(Vector, vector, int)
+VECTOR_DEFINE_SORT(Vector, vector, int, INT_LESS)
+VECTOR_DEFINE(PointVector, point_vector, Point)
+VECTOR_DEFINE_SORT(PointVector, point_vector, Point, point_less)
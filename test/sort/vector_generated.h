@@ -0,0 +1,28 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#include <stdlib.h>
+
+/* Allocations of failing_size bytes fail, to interrupt vector_sort_file */
+extern size_t failing_size;
+void *failing_realloc(void *pointer, size_t size);
+
+#define VECTOR_REALLOC(p, s) (failing_realloc((p), (s)))
+#define VECTOR_FREE(p) (free((p)))
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+typedef struct Point {
+	int x;
+	int y;
+} Point;
+
+int point_less(Point a, Point b);
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SERIAL(Vector, vector)
+VECTOR_DECLARE_SORT(Vector, vector)
+VECTOR_DECLARE(PointVector, point_vector, Point)
+VECTOR_DECLARE_SORT(PointVector, point_vector)
+
+#endif /* VECTOR_GENERATED_H */
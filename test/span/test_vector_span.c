@@ -0,0 +1,176 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+static void fill(Vector *vec, int count)
+{
+	int i = 0;
+
+	for (i = 0; i < count; i++) {
+		vector_push(vec, i);
+	}
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_span_and_subslice(void)
+{
+	Vector vec = { 0 };
+	VectorSpan span = { 0 };
+	VectorSpan sub = { 0 };
+
+	span = vector_span(&vec);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&span));
+
+	fill(&vec, 10);
+	span = vector_span(&vec);
+	TEST_ASSERT_EQUAL_PTR(vec.begin, span.begin);
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_SIZE(&span));
+
+	sub = vector_span_subslice(span, 2, 5);
+	TEST_ASSERT_EQUAL_UINT(5, VECTOR_SIZE(&sub));
+	TEST_ASSERT_EQUAL_INT(2, vector_span_get(sub, 0));
+	TEST_ASSERT_EQUAL_INT(6, vector_span_get(sub, 4));
+
+	sub = vector_span_subslice(sub, 5, 0);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&sub));
+	TEST_ASSERT_EQUAL_PTR(vec.begin + 7, sub.begin);
+
+	vector_free(&vec);
+}
+
+void test_split_at(void)
+{
+	Vector vec = { 0 };
+	VectorSpan head = { 0 };
+	VectorSpan tail = { 0 };
+
+	fill(&vec, 10);
+
+	vector_span_split_at(vector_span(&vec), 3, &head, &tail);
+	TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&head));
+	TEST_ASSERT_EQUAL_UINT(7, VECTOR_SIZE(&tail));
+	TEST_ASSERT_EQUAL_INT(3, vector_span_get(tail, 0));
+
+	vector_span_split_at(vector_span(&vec), 10, &head, &tail);
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_SIZE(&head));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&tail));
+
+	vector_free(&vec);
+}
+
+void test_chunks(void)
+{
+	Vector vec = { 0 };
+	VectorSpan rest = { 0 };
+	VectorSpan chunk = { 0 };
+	size_t sizes[4] = { 0 };
+	size_t chunks = 0;
+	const int *i = NULL;
+	long sum = 0;
+
+	fill(&vec, 10);
+
+	rest = vector_span(&vec);
+	while (vector_span_next_chunk(&rest, 3, &chunk)) {
+		TEST_ASSERT_TRUE(chunks < 4);
+		sizes[chunks++] = VECTOR_SIZE(&chunk);
+		for (i = chunk.begin; i < chunk.end; i++) {
+			sum += *i;
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT(4, chunks);
+	TEST_ASSERT_EQUAL_UINT(3, sizes[0]);
+	TEST_ASSERT_EQUAL_UINT(1, sizes[3]);
+	TEST_ASSERT_EQUAL_INT(45, sum);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&rest));
+
+	vector_free(&vec);
+}
+
+void test_algorithms_on_spans(void)
+{
+	Vector vec = { 0 };
+	Vector loaded = { 0 };
+	VectorSpan middle = { 0 };
+	unsigned char buffer[VECTOR_SERIAL_HEADER_SIZE + 4 * sizeof(int)];
+	int i = 0;
+
+	for (i = 0; i < 8; i++) {
+		vector_push(&vec, 8 - i);
+	}
+
+	/* Sort the middle 4 elements only: 8 7 [6 5 4 3] 2 1 */
+	middle = vector_span_subslice(vector_span(&vec), 2, 4);
+	TEST_ASSERT_EQUAL_INT(0, vector_span_is_sorted(middle));
+	vector_span_sort(middle);
+	TEST_ASSERT_EQUAL_INT(1, vector_span_is_sorted(middle));
+	TEST_ASSERT_EQUAL_INT(3, vec.begin[2]);
+	TEST_ASSERT_EQUAL_INT(8, vec.begin[0]);
+	TEST_ASSERT_EQUAL_INT(1, vec.begin[7]);
+
+	TEST_ASSERT_EQUAL_INT(0, vector_span_save_buffer(middle, buffer,
+							 sizeof(buffer) - 1));
+	TEST_ASSERT_EQUAL_INT(1, vector_span_save_buffer(middle, buffer,
+							 sizeof(buffer)));
+	TEST_ASSERT_EQUAL_INT(1, vector_load_buffer(&loaded, buffer,
+						    sizeof(buffer)));
+	TEST_ASSERT_EQUAL_UINT(4, VECTOR_SIZE(&loaded));
+	TEST_ASSERT_EQUAL_INT_ARRAY(middle.begin, loaded.begin, 4);
+
+	vector_free(&vec);
+	vector_free(&loaded);
+}
+
+void test_get_out_of_bounds(void)
+{
+	Vector vec = { 0 };
+
+	fill(&vec, 4);
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_span_get(vector_span(&vec), 4);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_subslice_out_of_bounds(void)
+{
+	Vector vec = { 0 };
+
+	fill(&vec, 4);
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_span_subslice(vector_span(&vec), 3, 2);
+	} else {
+		vector_free(&vec);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_span_and_subslice);
+	RUN_TEST(test_split_at);
+	RUN_TEST(test_chunks);
+	RUN_TEST(test_algorithms_on_spans);
+	RUN_TEST(test_get_out_of_bounds);
+	RUN_TEST(test_subslice_out_of_bounds);
+
+	return UNITY_END();
+}
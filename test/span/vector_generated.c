@@ -0,0 +1,8 @@
+#include "vector_generated.h"
+
+#define INT_LESS(a, b) ((a) < (b))
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SERIAL(Vector, vector, int)
+VECTOR_DEFINE_SORT(Vector, vector, int, INT_LESS)
@@ -0,0 +1,11 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SERIAL(Vector, vector)
+VECTOR_DECLARE_SORT(Vector, vector)
+
+#endif /* VECTOR_GENERATED_H */
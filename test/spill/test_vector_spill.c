@@ -0,0 +1,165 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+/* 64 bytes blocks of 16 ints, 4 of them in memory */
+#define BLOCK_ELEMENTS 16
+#define BUDGET (4 * 64)
+
+jmp_buf abort_jmp;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_push_and_scan_beyond_budget(void)
+{
+	VectorSpill vec;
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, BUDGET));
+	TEST_ASSERT_EQUAL_UINT(4, vec.core.slot_count);
+
+	for (idx = 0; idx < 10000; idx++) {
+		vector_spill_push(&vec, idx);
+	}
+	TEST_ASSERT_EQUAL_UINT(10000, vector_spill_size(&vec));
+	TEST_ASSERT_NOT_NULL(vec.core.file);
+
+	for (idx = 0; idx < 10000; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, vector_spill_get(&vec, (size_t)idx));
+	}
+
+	TEST_ASSERT_EQUAL_INT(9999, vector_spill_pop(&vec));
+	TEST_ASSERT_EQUAL_UINT(9999, vector_spill_size(&vec));
+
+	vector_spill_free(&vec);
+}
+
+void test_random_access(void)
+{
+	VectorSpill vec;
+	size_t idx = 0;
+	size_t step = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, BUDGET));
+	for (idx = 0; idx < 4096; idx++) {
+		vector_spill_push(&vec, 0);
+	}
+
+	/* 1237 is coprime with 4096, so every index is visited once */
+	for (step = 0, idx = 0; step < 4096; step++, idx = (idx + 1237) % 4096) {
+		vector_spill_set(&vec, idx, (int)idx * 2);
+	}
+	for (step = 0, idx = 0; step < 4096; step++, idx = (idx + 611) % 4096) {
+		TEST_ASSERT_EQUAL_INT((int)idx * 2, vector_spill_get(&vec, idx));
+	}
+
+	vector_spill_free(&vec);
+}
+
+void test_span_iteration(void)
+{
+	VectorSpill vec;
+	const int *i = NULL;
+	const int *end = NULL;
+	size_t idx = 0;
+	size_t count = 0;
+	long sum = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, BUDGET));
+	for (idx = 0; idx < 1000; idx++) {
+		vector_spill_push(&vec, (int)idx);
+	}
+
+	TEST_ASSERT_NOT_NULL(vector_spill_span(&vec, 10, &count));
+	TEST_ASSERT_EQUAL_UINT(BLOCK_ELEMENTS - 10, count);
+	TEST_ASSERT_NOT_NULL(vector_spill_span(&vec, 992, &count));
+	TEST_ASSERT_EQUAL_UINT(8, count);
+
+	for (idx = 0; idx < vector_spill_size(&vec); idx += count) {
+		i = vector_spill_span(&vec, idx, &count);
+		for (end = i + count; i < end; i++) {
+			sum += *i;
+		}
+	}
+	TEST_ASSERT_EQUAL_INT(999L * 1000 / 2, sum);
+
+	vector_spill_free(&vec);
+}
+
+void test_sequential_read_ahead(void)
+{
+	VectorSpill vec;
+	size_t idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, BUDGET));
+	for (idx = 0; idx < 20 * BLOCK_ELEMENTS; idx++) {
+		vector_spill_push(&vec, (int)idx);
+	}
+
+	/* Block 10 is a random miss, block 11 a sequential one reading
+	 * ahead 2 blocks, half of the slots */
+	TEST_ASSERT_EQUAL_INT(10 * BLOCK_ELEMENTS,
+			      vector_spill_get(&vec, 10 * BLOCK_ELEMENTS));
+	TEST_ASSERT_EQUAL_UINT(10, vec.core.last_miss);
+	TEST_ASSERT_EQUAL_INT(11 * BLOCK_ELEMENTS,
+			      vector_spill_get(&vec, 11 * BLOCK_ELEMENTS));
+	TEST_ASSERT_EQUAL_UINT(13, vec.core.last_miss);
+
+	TEST_ASSERT_EQUAL_INT(13 * BLOCK_ELEMENTS,
+			      vector_spill_get(&vec, 13 * BLOCK_ELEMENTS));
+	TEST_ASSERT_EQUAL_UINT(13, vec.core.last_miss);
+
+	vector_spill_free(&vec);
+}
+
+void test_minimum_budget(void)
+{
+	VectorSpill vec;
+	int idx = 0;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, 0));
+	TEST_ASSERT_EQUAL_UINT(2, vec.core.slot_count);
+
+	for (idx = 0; idx < 100; idx++) {
+		vector_spill_push(&vec, idx);
+	}
+	TEST_ASSERT_EQUAL_INT(42, vector_spill_get(&vec, 42));
+
+	vector_spill_free(&vec);
+}
+
+void test_get_out_of_bounds(void)
+{
+	VectorSpill vec;
+
+	TEST_ASSERT_EQUAL_INT(1, vector_spill_init(&vec, BUDGET));
+	vector_spill_push(&vec, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_spill_get(&vec, 1);
+	} else {
+		vector_spill_free(&vec);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_push_and_scan_beyond_budget);
+	RUN_TEST(test_random_access);
+	RUN_TEST(test_span_iteration);
+	RUN_TEST(test_sequential_read_ahead);
+	RUN_TEST(test_minimum_budget);
+	RUN_TEST(test_get_out_of_bounds);
+
+	return UNITY_END();
+}
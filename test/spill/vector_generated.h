@@ -0,0 +1,11 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_SPILL_BLOCK_BYTES 64
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SPILL(Vector, vector, int)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,248 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+size_t realloc_calls = 0;
+
+void *counting_realloc(void *ptr, size_t size)
+{
+	realloc_calls++;
+	return realloc(ptr, size);
+}
+
+void setUp(void)
+{
+	realloc_calls = 0;
+}
+
+void tearDown(void)
+{
+	TEST_ASSERT_EQUAL_UINT(0, realloc_calls);
+}
+
+void test_push_from_zero(void)
+{
+	StaticVector vec = { 0 };
+
+	static_vector_push(&vec, 8);
+
+	TEST_ASSERT_EQUAL_UINT(STATIC_VECTOR_CAPACITY, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(1, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(8, static_vector_get(&vec, 0));
+	TEST_ASSERT(vec.begin == vec.storage);
+
+	static_vector_free(&vec);
+}
+
+void test_push_full(void)
+{
+	StaticVector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < STATIC_VECTOR_CAPACITY; idx++) {
+		static_vector_push(&vec, idx);
+		TEST_ASSERT_EQUAL_UINT(idx + 1, VECTOR_SIZE(&vec));
+		TEST_ASSERT_EQUAL_INT(idx, static_vector_get(&vec, idx));
+	}
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_push(&vec, -1);
+	} else {
+		TEST_ASSERT_EQUAL_UINT(STATIC_VECTOR_CAPACITY,
+				       VECTOR_SIZE(&vec));
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_try_push(void)
+{
+	StaticVector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < STATIC_VECTOR_CAPACITY; idx++) {
+		TEST_ASSERT_EQUAL_INT(1, static_vector_try_push(&vec, idx));
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, static_vector_try_push(&vec, -1));
+	TEST_ASSERT_EQUAL_INT(0, static_vector_try_insert(&vec, 0, -1));
+	TEST_ASSERT_EQUAL_UINT(STATIC_VECTOR_CAPACITY, VECTOR_SIZE(&vec));
+
+	static_vector_pop(&vec);
+	TEST_ASSERT_EQUAL_INT(1, static_vector_try_insert(&vec, 0, -1));
+	TEST_ASSERT_EQUAL_INT(-1, static_vector_get(&vec, 0));
+}
+
+void test_init_too_large(void)
+{
+	StaticVector vec = { 0 };
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_init(&vec, STATIC_VECTOR_CAPACITY + 1);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_grow(void)
+{
+	StaticVector vec = { 0 };
+
+	static_vector_grow(&vec, STATIC_VECTOR_CAPACITY);
+	TEST_ASSERT_EQUAL_UINT(STATIC_VECTOR_CAPACITY, VECTOR_CAPACITY(&vec));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_grow(&vec, STATIC_VECTOR_CAPACITY + 1);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_resize(void)
+{
+	StaticVector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx <= STATIC_VECTOR_CAPACITY; idx++) {
+		static_vector_resize(&vec, idx);
+		TEST_ASSERT_EQUAL_UINT(idx, VECTOR_SIZE(&vec));
+	}
+
+	static_vector_resize(&vec, 2);
+	TEST_ASSERT_EQUAL_UINT(2, VECTOR_SIZE(&vec));
+}
+
+void test_pop(void)
+{
+	StaticVector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 100; idx++) {
+		static_vector_push(&vec, idx);
+		TEST_ASSERT_EQUAL_INT(idx, static_vector_pop(&vec));
+	}
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_pop(&vec);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_set_out_of_range(void)
+{
+	StaticVector vec = { 0 };
+
+	static_vector_push(&vec, 1);
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_set(&vec, 1, 100);
+	} else {
+		TEST_ASSERT_EQUAL_INT(1, static_vector_get(&vec, 0));
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_insert_delete(void)
+{
+	StaticVector vec = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 10; idx++) {
+		static_vector_insert(&vec, 0, idx);
+	}
+
+	for (idx = 0; idx < 10; idx++) {
+		TEST_ASSERT_EQUAL_INT(9 - idx, static_vector_get(&vec, idx));
+	}
+
+	static_vector_delete(&vec, 0);
+	static_vector_delete(&vec, 4);
+	static_vector_delete(&vec, VECTOR_SIZE(&vec) - 1);
+
+	TEST_ASSERT_EQUAL_UINT(7, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_INT(8, static_vector_get(&vec, 0));
+	TEST_ASSERT_EQUAL_INT(3, static_vector_get(&vec, 4));
+	TEST_ASSERT_EQUAL_INT(1, static_vector_get(&vec, 6));
+}
+
+void test_insert_full(void)
+{
+	StaticVector vec = { 0 };
+
+	static_vector_resize(&vec, STATIC_VECTOR_CAPACITY);
+
+	if (setjmp(abort_jmp) == 0) {
+		static_vector_insert(&vec, 0, 1);
+	} else {
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+void test_duplicate(void)
+{
+	StaticVector src = { 0 };
+	StaticVector dest = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 10; idx++) {
+		static_vector_push(&src, idx);
+	}
+
+	static_vector_duplicate(&dest, &src);
+
+	TEST_ASSERT(dest.begin == dest.storage);
+	TEST_ASSERT_EQUAL_UINT(10, VECTOR_SIZE(&dest));
+	for (idx = 0; idx < 10; idx++) {
+		TEST_ASSERT_EQUAL_INT(idx, static_vector_get(&dest, idx));
+	}
+}
+
+void test_clear_free(void)
+{
+	StaticVector vec = { 0 };
+	StaticVector vec_zero = { 0 };
+
+	static_vector_push(&vec, 1);
+	static_vector_clear(&vec);
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&vec));
+	TEST_ASSERT_EQUAL_UINT(STATIC_VECTOR_CAPACITY, VECTOR_CAPACITY(&vec));
+
+	static_vector_free(&vec);
+	TEST_ASSERT_NULL(vec.begin);
+	TEST_ASSERT_NULL(vec.end);
+	TEST_ASSERT_NULL(vec.end_of_storage);
+	static_vector_free(&vec_zero);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_push_from_zero);
+	RUN_TEST(test_push_full);
+	RUN_TEST(test_try_push);
+	RUN_TEST(test_init_too_large);
+	RUN_TEST(test_grow);
+	RUN_TEST(test_resize);
+	RUN_TEST(test_pop);
+	RUN_TEST(test_set_out_of_range);
+	RUN_TEST(test_insert_delete);
+	RUN_TEST(test_insert_full);
+	RUN_TEST(test_duplicate);
+	RUN_TEST(test_clear_free);
+
+	return UNITY_END();
+}
@@ -0,0 +1,19 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#include <stdlib.h>
+
+void *counting_realloc(void *ptr, size_t size);
+extern size_t realloc_calls;
+
+#define VECTOR_REALLOC(p, s) (counting_realloc((p), (s)))
+#define VECTOR_FREE(p) (free((p)))
+#define VECTOR_LONG_JUMP_NO_ABORT
+
+#include "vector.h"
+
+enum { STATIC_VECTOR_CAPACITY = 16 };
+
+VECTOR_DECLARE_STATIC(StaticVector, static_vector, int, STATIC_VECTOR_CAPACITY)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,176 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+jmp_buf abort_jmp;
+
+static VectorCoreTraceEvent last_event;
+static size_t event_count;
+
+static void record_event(const VectorCoreTraceEvent *event)
+{
+	last_event = *event;
+	event_count++;
+}
+
+void setUp(void)
+{
+	memset(&last_event, 0, sizeof(last_event));
+	event_count = 0;
+	vector_core_trace_callback = record_event;
+}
+
+void tearDown(void)
+{
+	vector_core_trace_callback = NULL;
+}
+
+void test_grow_event(void)
+{
+	Vector vec = { 0 };
+
+	vector_init(&vec, 4);
+	vector_grow(&vec, 10);
+
+	TEST_ASSERT_EQUAL_UINT(2, event_count);
+	TEST_ASSERT_EQUAL_STRING("Vector", last_event.type_name);
+	TEST_ASSERT_EQUAL_STRING("vector_grow", last_event.function);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_REALLOC, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(4, last_event.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(10, last_event.new_capacity);
+	TEST_ASSERT_EQUAL_UINT(10 * sizeof(int), last_event.bytes);
+
+	vector_free(&vec);
+
+	TEST_ASSERT_EQUAL_UINT(3, event_count);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_FREE, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(10 * sizeof(int), last_event.bytes);
+}
+
+void test_no_event_without_allocation(void)
+{
+	Vector vec = { 0 };
+
+	vector_init(&vec, 4);
+	vector_push(&vec, 1);
+	vector_push(&vec, 2);
+	vector_grow(&vec, 4);
+	event_count = 0;
+
+	vector_get(&vec, 0);
+	vector_pop(&vec);
+	vector_clear(&vec);
+
+	TEST_ASSERT_EQUAL_UINT(0, event_count);
+
+	vector_free(&vec);
+	vector_free(&vec);
+	TEST_ASSERT_EQUAL_UINT(1, event_count);
+}
+
+void test_copy_events(void)
+{
+	Vector vec = { 0 };
+	Vector copy = { 0 };
+	int idx = 0;
+
+	for (idx = 0; idx < 8; idx++) {
+		vector_push(&vec, idx);
+	}
+
+	vector_insert(&vec, 2, -1);
+	TEST_ASSERT_EQUAL_STRING("vector_insert", last_event.function);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_COPY, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(6 * sizeof(int), last_event.bytes);
+
+	vector_delete(&vec, 0);
+	TEST_ASSERT_EQUAL_STRING("vector_delete", last_event.function);
+	TEST_ASSERT_EQUAL_UINT(8 * sizeof(int), last_event.bytes);
+
+	vector_duplicate(&copy, &vec);
+	TEST_ASSERT_EQUAL_STRING("vector_duplicate", last_event.function);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_COPY, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(8 * sizeof(int), last_event.bytes);
+
+	vector_free(&vec);
+	vector_free(&copy);
+}
+
+void test_static_vector_events(void)
+{
+	StaticVector vec = { 0 };
+
+	static_vector_init(&vec, 0);
+	static_vector_push(&vec, 1);
+	static_vector_push(&vec, 2);
+	TEST_ASSERT_EQUAL_UINT(0, event_count);
+
+	static_vector_insert(&vec, 0, 0);
+	TEST_ASSERT_EQUAL_UINT(1, event_count);
+	TEST_ASSERT_EQUAL_STRING("StaticVector", last_event.type_name);
+	TEST_ASSERT_EQUAL_STRING("static_vector_insert", last_event.function);
+	TEST_ASSERT_EQUAL_UINT(8, last_event.old_capacity);
+	TEST_ASSERT_EQUAL_UINT(2 * sizeof(int), last_event.bytes);
+}
+
+void test_incremental_vector_events(void)
+{
+	IncrementalVector vec = { 0 };
+	size_t idx = 0;
+
+	for (idx = 0; idx < VECTOR_DEFAULT_CAPACITY + 1; idx++) {
+		incremental_vector_push(&vec, (int)idx);
+	}
+	TEST_ASSERT_EQUAL_STRING("incremental_vector_migrate",
+				 last_event.function);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_COPY, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(8, last_event.bytes);
+
+	incremental_vector_finish_migration(&vec);
+	TEST_ASSERT_EQUAL_STRING("incremental_vector_finish_migration",
+				 last_event.function);
+	TEST_ASSERT_EQUAL_INT(VECTOR_TRACE_FREE, last_event.kind);
+	TEST_ASSERT_EQUAL_UINT(VECTOR_DEFAULT_CAPACITY, last_event.old_capacity);
+
+	incremental_vector_free(&vec);
+}
+
+void test_dump(void)
+{
+	Vector vec = { 0 };
+	FILE *stream = tmpfile();
+	char line[256] = { 0 };
+	unsigned long reallocs = 0;
+	unsigned long realloc_bytes = 0;
+	unsigned long frees = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+
+	vector_init(&vec, 1);
+	vector_free(&vec);
+	vector_trace_dump(stream);
+
+	rewind(stream);
+	TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), stream));
+	TEST_ASSERT_EQUAL_INT(0, strncmp(line, "Vector: ", 8));
+	TEST_ASSERT_EQUAL_INT(3, sscanf(line,
+					"Vector: %lu reallocs (%lu bytes), %lu frees",
+					&reallocs, &realloc_bytes, &frees));
+	TEST_ASSERT(reallocs > 0);
+	TEST_ASSERT(frees > 0);
+
+	(void)fclose(stream);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_grow_event);
+	RUN_TEST(test_no_event_without_allocation);
+	RUN_TEST(test_copy_events);
+	RUN_TEST(test_static_vector_events);
+	RUN_TEST(test_incremental_vector_events);
+	RUN_TEST(test_dump);
+
+	return UNITY_END();
+}
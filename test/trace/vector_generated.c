@@ -0,0 +1,6 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_STATIC(StaticVector, static_vector, int)
+VECTOR_DEFINE_INCREMENTAL(IncrementalVector, incremental_vector, int)
@@ -0,0 +1,13 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_TRACE 1
+#define VECTOR_INCREMENTAL_STEP_BYTES 8
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_STATIC(StaticVector, static_vector, int, 8)
+VECTOR_DECLARE_INCREMENTAL(IncrementalVector, incremental_vector, int)
+
+#endif /* VECTOR_GENERATED_H */
@@ -0,0 +1,169 @@
+#include "unity/unity.h"
+#include "vector_generated.h"
+
+#define VIEW_FILE "test_vector_view.bin"
+
+jmp_buf abort_jmp;
+
+static void save_file(size_t count)
+{
+	Vector vec = { 0 };
+	FILE *stream = fopen(VIEW_FILE, "wb");
+	size_t i = 0;
+
+	TEST_ASSERT_NOT_NULL(stream);
+	for (i = 0; i < count; i++) {
+		vector_push(&vec, (int)i * 2);
+	}
+	TEST_ASSERT_EQUAL_INT(1, vector_save(&vec, stream));
+	TEST_ASSERT_EQUAL_INT(0, fclose(stream));
+	vector_free(&vec);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+	(void)remove(VIEW_FILE);
+}
+
+void test_open_mapped_file(void)
+{
+	VectorView view = { 0 };
+	const int *i = NULL;
+	int expected = 0;
+
+	save_file(10000);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_view_open(&view, VIEW_FILE));
+	TEST_ASSERT_NOT_NULL(view.mapping);
+	TEST_ASSERT_EQUAL_UINT(10000, VECTOR_SIZE(&view));
+	for (i = view.begin; i < view.end; i++) {
+		TEST_ASSERT_EQUAL_INT(expected, *i);
+		expected += 2;
+	}
+	TEST_ASSERT_EQUAL_INT(42, vector_view_get(&view, 21));
+	TEST_ASSERT_EQUAL_INT(1, vector_view_verify(&view));
+
+	vector_view_close(&view);
+	TEST_ASSERT_NULL(view.begin);
+	TEST_ASSERT_NULL(view.mapping);
+}
+
+void test_open_empty_vector(void)
+{
+	VectorView view = { 0 };
+
+	save_file(0);
+
+	TEST_ASSERT_EQUAL_INT(1, vector_view_open(&view, VIEW_FILE));
+	TEST_ASSERT_EQUAL_UINT(0, VECTOR_SIZE(&view));
+
+	vector_view_close(&view);
+}
+
+void test_open_rejects_invalid_file(void)
+{
+	VectorView view = { 0 };
+	FILE *stream = fopen(VIEW_FILE, "wb");
+
+	TEST_ASSERT_EQUAL_INT(0, vector_view_open(&view, "does_not_exist"));
+
+	TEST_ASSERT_NOT_NULL(stream);
+	TEST_ASSERT_TRUE(fputs("not a vector", stream) != EOF);
+	TEST_ASSERT_EQUAL_INT(0, fclose(stream));
+
+	TEST_ASSERT_EQUAL_INT(0, vector_view_open(&view, VIEW_FILE));
+	TEST_ASSERT_NULL(view.begin);
+	TEST_ASSERT_NULL(view.mapping);
+}
+
+/* Holds a saved vector of 3 ints, aligned for them, and a spare byte to
+ * misalign it */
+typedef union AlignedBuffer {
+	int align;
+	unsigned char bytes[VECTOR_SERIAL_HEADER_SIZE + 3 * sizeof(int) + 1];
+} AlignedBuffer;
+
+void test_init_over_buffer(void)
+{
+	Vector vec = { 0 };
+	VectorView view = { 0 };
+	AlignedBuffer aligned;
+	unsigned char *buffer = aligned.bytes;
+	size_t buffer_size = VECTOR_SERIAL_HEADER_SIZE + 3 * sizeof(int);
+
+	vector_push(&vec, 1);
+	vector_push(&vec, 2);
+	vector_push(&vec, 3);
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, buffer,
+						    buffer_size));
+
+	TEST_ASSERT_EQUAL_INT(0, vector_view_init(&view, buffer,
+						  buffer_size - 1));
+	TEST_ASSERT_EQUAL_INT(1, vector_view_init(&view, buffer,
+						  buffer_size));
+	TEST_ASSERT_NULL(view.mapping);
+	TEST_ASSERT_EQUAL_PTR(buffer + VECTOR_SERIAL_HEADER_SIZE, view.begin);
+	TEST_ASSERT_EQUAL_UINT(3, VECTOR_SIZE(&view));
+	TEST_ASSERT_EQUAL_INT(1, vector_view_verify(&view));
+
+	buffer[buffer_size - 1] ^= 1;
+	TEST_ASSERT_EQUAL_INT(0, vector_view_verify(&view));
+
+	vector_view_close(&view);
+	vector_free(&vec);
+}
+
+void test_init_rejects_misaligned_elements(void)
+{
+	Vector vec = { 0 };
+	VectorView view = { 0 };
+	AlignedBuffer aligned;
+	size_t buffer_size = VECTOR_SERIAL_HEADER_SIZE + 3 * sizeof(int);
+
+	vector_push(&vec, 1);
+	vector_push(&vec, 2);
+	vector_push(&vec, 3);
+	TEST_ASSERT_EQUAL_INT(1, vector_save_buffer(&vec, aligned.bytes + 1,
+						    buffer_size));
+
+	TEST_ASSERT_EQUAL_INT(0, vector_view_init(&view, aligned.bytes + 1,
+						  buffer_size));
+	TEST_ASSERT_NULL(view.begin);
+
+	vector_free(&vec);
+}
+
+void test_get_out_of_bounds(void)
+{
+	VectorView view = { 0 };
+
+	save_file(4);
+	TEST_ASSERT_EQUAL_INT(1, vector_view_open(&view, VIEW_FILE));
+
+	if (setjmp(abort_jmp) == 0) {
+		(void)vector_view_get(&view, 4);
+	} else {
+		vector_view_close(&view);
+		return;
+	}
+
+	TEST_FAIL();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(test_open_mapped_file);
+	RUN_TEST(test_open_empty_vector);
+	RUN_TEST(test_open_rejects_invalid_file);
+	RUN_TEST(test_init_over_buffer);
+	RUN_TEST(test_init_rejects_misaligned_elements);
+	RUN_TEST(test_get_out_of_bounds);
+
+	return UNITY_END();
+}
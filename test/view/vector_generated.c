@@ -0,0 +1,6 @@
+#include "vector_generated.h"
+
+VECTOR_DEFINE_SHARED_CORE()
+VECTOR_DEFINE(Vector, vector, int)
+VECTOR_DEFINE_SERIAL(Vector, vector, int)
+VECTOR_DEFINE_VIEW(Vector, vector, int)
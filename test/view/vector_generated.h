@@ -0,0 +1,15 @@
+#ifndef VECTOR_GENERATED_H
+#define VECTOR_GENERATED_H
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#define VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_MMAP 1
+#include "vector.h"
+
+VECTOR_DECLARE(Vector, vector, int)
+VECTOR_DECLARE_SERIAL(Vector, vector)
+VECTOR_DECLARE_VIEW(Vector, vector, int)
+
+#endif /* VECTOR_GENERATED_H */
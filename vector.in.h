@@ -2,6 +2,7 @@
 #define VECTOR_H
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,7 +17,58 @@
  * is recommended to place them in their respective files. Generate as many
  * different types of vectors as you want.
  *
- * This library is not thread safe.
+ * Alternatively, VECTOR_DEFINE_INLINE() generates both as static inline
+ * functions, to be placed in a header instead of VECTOR_DECLARE(). Every call
+ * can then be inlined without link-time optimization, at the cost of one copy
+ * of the functions per translation unit using them. VECTOR_DECLARE_LINKAGE()
+ * and VECTOR_DEFINE_LINKAGE() take as two extra arguments the linkage of the
+ * functions and the linkage of the panic function, which is never inlined.
+ *
+ * VECTOR_DEFINE() can also be replaced by the groups of functions a type
+ * actually uses, which saves compile time and code size:
+ * - VECTOR_DEFINE_CORE(): init, free, grow, resize, push, try_push, pop, clear.
+ * - VECTOR_DEFINE_ACCESS(): get, set.
+ * - VECTOR_DEFINE_EDIT(): insert, try_insert, delete.
+ * - VECTOR_DEFINE_DUPLICATE(): duplicate.
+ * - VECTOR_DEFINE_SERIAL(): serialized_size, save, load, save_buffer,
+ *   load_buffer. Not part of VECTOR_DEFINE(): it is declared by
+ *   VECTOR_DECLARE_SERIAL(Vector, vector) and requires
+ *   VECTOR_DEFINE_SHARED_CORE() to be expanded once.
+ * - VECTOR_DEFINE_VIEW(): the read-only VectorView type, see Views below.
+ *   Declared by VECTOR_DECLARE_VIEW(Vector, vector, SampleType), with the
+ *   same requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_FILE(): the file-backed VectorFile type, see File Vectors
+ *   below. Declared by VECTOR_DECLARE_FILE(Vector, vector, SampleType), with
+ *   the same requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_SPILL(): the external-memory VectorSpill type, see Spill
+ *   Vectors below. Declared by VECTOR_DECLARE_SPILL(Vector, vector,
+ *   SampleType), and requires VECTOR_DEFINE_SHARED_CORE() to be expanded once.
+ * - VECTOR_DEFINE_SORT(): sort, is_sorted, sort_file, see Sorting below.
+ *   Declared by VECTOR_DECLARE_SORT(Vector, vector), with the same
+ *   requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_CONCURRENT(): the append-only VectorConcurrent type, see
+ *   Concurrent Vectors below. Declared by VECTOR_DECLARE_CONCURRENT(Vector,
+ *   vector, SampleType), with the same requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_RCU(): the single-writer VectorRcu type, see RCU Vectors
+ *   below. Declared by VECTOR_DECLARE_RCU(Vector, vector, SampleType), with
+ *   the same requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_QUEUE(): the VectorSpsc and VectorMpmc queues, see Queues
+ *   below. Declared by VECTOR_DECLARE_QUEUE(Vector, vector, SampleType), with
+ *   the same requirements as VECTOR_DEFINE_SERIAL().
+ * - VECTOR_DEFINE_SHARDED(): the per-thread VectorSharded collection, see
+ *   Sharded Vectors below. Declared by VECTOR_DECLARE_SHARDED(Vector, vector,
+ *   SampleType), and requires VECTOR_DEFINE_CORE() in the same translation
+ *   unit.
+ * - VECTOR_DEFINE_PARALLEL(): parallel_for_each, parallel_transform,
+ *   parallel_reduce, parallel_fill, parallel_duplicate, see Parallel
+ *   Algorithms below. Declared by VECTOR_DECLARE_PARALLEL(Vector, vector,
+ *   SampleType), with the same requirements as VECTOR_DEFINE_SERIAL().
+ * Every other group requires VECTOR_DEFINE_CORE() in the same translation
+ * unit. Each group has a _LINKAGE() variant taking the linkage of its functions
+ * (and of the panic function for the core group).
+ *
+ * This library is not thread safe, except for concurrent and RCU vectors
+ * and queues.
  *
  * This library follows a 2x capacity growing policy.
  *
@@ -45,6 +97,78 @@
  * - VECTOR_FREE (default free(3)): specify the deallocator. If using a
  *   custom deallocator, must also specify VECTOR_REALLOC.
  *
+ * - VECTOR_NO_CHECKS (default 0): if true (1), compiles away NULL checks, index
+ *   bounds checks, the empty vector check of vector_pop and the internal
+ *   consistency asserts. Passing invalid arguments becomes undefined behavior.
+ *   Allocation failures, size overflows and static capacity limits are still
+ *   handled.
+ *
+ * - VECTOR_INCREMENTAL_STEP_BYTES (default 65536): bytes an incremental vector
+ *   migrates to its new buffer per push (at least one element).
+ *
+ * - VECTOR_SPILL_BLOCK_BYTES (default 65536): bytes of the blocks a spill
+ *   vector keeps in memory or writes to its temporary file (at least one
+ *   element).
+ *
+ * - VECTOR_RCU_READERS (default 16): number of reader slots of an RCU vector,
+ *   each usable by one reader thread at a time.
+ *
+ * - VECTOR_NO_ALLOC_GUARD (default 0): if true (1), panic whenever a vector
+ *   function allocates between VECTOR_NO_ALLOC_BEGIN() and
+ *   VECTOR_NO_ALLOC_END().
+ *   Regions nest and are tracked per thread. Must be the same in every
+ *   translation unit, and "VECTOR_THREAD_LOCAL int vector_no_alloc_depth;" must
+ *   be defined in exactly one of them. Otherwise, both macros are no-ops.
+ *
+ * - VECTOR_SHARED_CORE (default 0): if true (1), the slow paths of grow, init,
+ *   insert, delete and duplicate are implemented once for all vector types,
+ *   on untyped memory, instead of once per VECTOR_DEFINE(). Generated functions
+ *   become thin wrappers, which shrinks the code of programs generating many
+ *   vector types. Must be the same in every translation unit, along with the
+ *   allocator, and VECTOR_DEFINE_SHARED_CORE() must be expanded in exactly one
+ *   of them.
+ *
+ * - VECTOR_TRACE (default 0): if true (1), every allocation, deallocation and
+ *   element copy (memmove(3)/memcpy(3)) of a vector function is counted per
+ *   vector type and reported to vector_core_trace_callback, if set, with the
+ *   type name, function name, old and new capacities, and bytes involved.
+ *   Counters are shared by type name, so they add up the events of every
+ *   translation unit using the type, including VECTOR_DEFINE_INLINE() ones.
+ *   They are atomic where C11 or GCC atomics are available, so threads may
+ *   use vectors of the type concurrently; otherwise, instrumented programs
+ *   must be single-threaded. Must be the same in every translation unit, and
+ *   VECTOR_DEFINE_SHARED_CORE() must be expanded in exactly one of them.
+ *   Otherwise, the instrumentation compiles to nothing.
+ *
+ * - VECTOR_ACCOUNTING (default 0): if true (1), every heap vector registers
+ *   its capacity and size in a per-type entry of vector_core_account_registry:
+ *   the number of live vectors, their total capacity and size in bytes, and a
+ *   histogram of their slack (unused capacity). vector_core_account_print()
+ *   prints all of them. Entries are shared by type name across translation
+ *   units. Same requirements and thread safety as VECTOR_TRACE. Static and
+ *   incremental vectors are not accounted.
+ *
+ * - VECTOR_MMAP (default 0): if true (1), vector_view_open and
+ *   vector_file_open map files with mmap(2), which requires a POSIX system (and
+ *   _POSIX_C_SOURCE in strict modes, or _GNU_SOURCE to grow mappings with
+ *   mremap(2) on Linux). Otherwise, both always fail. Must be the same in the
+ *   translation unit expanding VECTOR_DEFINE_SHARED_CORE().
+ *
+ * - VECTOR_PARALLEL (default 0): if true (1), the loops of
+ *   VECTOR_DEFINE_PARALLEL() run on a pool of POSIX threads, which requires
+ *   linking with pthreads (and _POSIX_C_SOURCE in strict modes). Otherwise,
+ *   they run on the calling thread. Must be the same in the translation unit
+ *   expanding VECTOR_DEFINE_SHARED_CORE().
+ *
+ * - VECTOR_PARALLEL_GRAIN_BYTES (default 65536): bytes of elements in a chunk
+ *   of a parallel loop (at least one element), the unit of work threads
+ *   share. Loops over a single chunk run on the calling thread.
+ *
+ * - VECTOR_STREAM_BYTES (default 8388608): copies of vector_parallel_duplicate
+ *   of at least this many bytes, larger than most last level caches, use
+ *   non-temporal stores where SSE2 is available, bypassing the cache instead
+ *   of evicting all of it.
+ *
  * - VECTOR_LONG_JUMP_NO_ABORT (default undefined): for testing only. Jump to
  *   externally defined "jmp_buf abort_jmp" instead of panicking. Unlike other
  *   configuration options, must be defined before including the library.
@@ -87,6 +211,10 @@
  *   Append element, growing capacity if needed. Auto-initializes empty vectors.
  *   O(1) amortized complexity.
  *
+ * int vector_try_push(Vector *vec, SampleType value)
+ *   Append element only if capacity allows it. Never allocates. Returns 1 if
+ *   the element was appended, 0 if the vector is full.
+ *
  * SampleType vector_pop(Vector *vec)
  *   Remove and return last element. Panics if empty.
  *
@@ -101,6 +229,10 @@
  *   idx equal to size appends to end. Panics if idx > size.
  *   O(n) worst-case complexity.
  *
+ * int vector_try_insert(Vector *vec, size_t idx, SampleType value)
+ *   Same as vector_insert, but never allocates. Returns 1 if the element was
+ *   inserted, 0 if the vector is full.
+ *
  * void vector_delete(Vector *vec, size_t idx)
  *   Remove element at 0-based index, shifting later elements left.
  *   Panics if idx out of bounds. O(n) worst-case complexity.
@@ -112,6 +244,559 @@
  * void vector_clear(Vector *vec)
  *   Remove all elements without deallocating capacity.
  *
+ * void vector_trace_dump(FILE *stream)
+ *   Print the VECTOR_TRACE counters of the vector type to stream. Prints
+ *   nothing without VECTOR_TRACE.
+ *
+ * const VectorCoreAccountStats *vector_account_stats(void)
+ *   Return the VECTOR_ACCOUNTING entry of the vector type, or NULL without
+ *   VECTOR_ACCOUNTING.
+ *
+ * size_t vector_serialized_size(const Vector *vec)
+ *   Return the number of bytes vector_save and vector_save_buffer write: a
+ *   VECTOR_SERIAL_HEADER_SIZE bytes header (format version, byte order,
+ *   element size, count and checksum) followed by the elements.
+ *
+ * int vector_save(const Vector *vec, FILE *stream)
+ * int vector_save_buffer(const Vector *vec, void *buffer, size_t buffer_size)
+ *   Write the vector with a single fwrite(3) or memcpy(3) of its elements.
+ *   Return 1 on success, 0 on write error or if buffer_size is too small.
+ *
+ * int vector_load(Vector *vec, FILE *stream)
+ * int vector_load_buffer(Vector *vec, const void *buffer, size_t buffer_size)
+ *   Replace the elements of vec, which must be initialized or zeroed, by those
+ *   saved by vector_save or vector_save_buffer. vector_load_buffer grows vec
+ *   once to the exact count before a single memcpy(3). vector_load trusts the
+ *   count only as far as elements arrive: it reads chunks of at least
+ *   VECTOR_SERIAL_CHUNK_BYTES, growing vec geometrically, so a corrupted count
+ *   costs at most twice the size of the stream. Return 1 on success, 0 if the
+ *   data is truncated, fails its checksum, or was saved with another element
+ *   size, byte order or format version, or if vector_load runs out of memory;
+ *   vec is then left empty. Elements are
+ *   copied byte for byte, so pointers they hold are only valid in the process
+ *   which saved them.
+ *
+ * SampleType vector_get_unchecked(const Vector *vec, size_t idx)
+ * void vector_set_unchecked(Vector *vec, size_t idx, SampleType value)
+ * void vector_push_unchecked(Vector *vec, SampleType value)
+ *   Inline variants generated by VECTOR_DECLARE, so they can be optimized at
+ *   each call site. They never check for NULL nor bounds: vec must be valid and
+ *   idx less than the size. vector_push_unchecked still grows when full.
+ *
+ *
+ * Spans:
+ *
+ * VECTOR_DECLARE also generates VectorSpan, a non-owning range of elements
+ * passed by value. Its begin and end work with VECTOR_SIZE, and it stays valid
+ * until the vector it points into reallocates or is freed. Functions taking
+ * or returning a span are inline; subslicing never allocates nor copies.
+ *
+ * VectorSpan vector_span(const Vector *vec)
+ *   Return a span over every element of vec.
+ *
+ * VectorSpan vector_span_subslice(VectorSpan span, size_t idx, size_t count)
+ *   Return the count elements of span starting at 0-based index idx. Panics
+ *   if they are not all in span (returns an empty span under
+ *   VECTOR_NO_PANIC_ON_OOB).
+ *
+ * SampleType vector_span_get(VectorSpan span, size_t idx)
+ *   Get element at 0-based index, with a single comparison against the size
+ *   of span. Panics if idx out of bounds.
+ *
+ * void vector_span_split_at(VectorSpan span, size_t idx, VectorSpan *head,
+ *                           VectorSpan *tail)
+ *   Split span into its first idx elements and the remaining ones. Panics if
+ *   idx > size (splits at size under VECTOR_NO_PANIC_ON_OOB).
+ *
+ * int vector_span_next_chunk(VectorSpan *rest, size_t chunk_size,
+ *                            VectorSpan *chunk)
+ *   Move the first chunk_size elements of rest (or all of them if fewer) to
+ *   chunk. Return 1 if a chunk was taken, 0 if rest is empty. Iterates a
+ *   span in chunks with while (vector_span_next_chunk(&rest, n, &chunk)).
+ *   Panics if chunk_size is 0.
+ *
+ * int vector_span_save(VectorSpan span, FILE *stream)
+ * int vector_span_save_buffer(VectorSpan span, void *buffer,
+ *                             size_t buffer_size)
+ *   Same as vector_save and vector_save_buffer, for the elements of span.
+ *   Generated by VECTOR_DEFINE_SERIAL().
+ *
+ * SampleType vector_span_sum(VectorSpan span)
+ * SampleType vector_span_sum_kahan(VectorSpan span)
+ * SampleType vector_span_dot(VectorSpan a, VectorSpan b)
+ * SampleType vector_span_min(VectorSpan span)
+ * SampleType vector_span_max(VectorSpan span)
+ * size_t vector_span_argmin(VectorSpan span)
+ * size_t vector_span_argmax(VectorSpan span)
+ *   Same as the reductions of numeric vectors, for the elements of span,
+ *   added in the same order from its first element. Indexes are relative to
+ *   the beginning of span. Generated by VECTOR_DEFINE_NUMERIC().
+ *
+ *
+ * Views:
+ *
+ * VECTOR_DECLARE_VIEW(Vector, vector, SampleType) and VECTOR_DEFINE_VIEW()
+ * generate VectorView, a read-only vector over data written by vector_save or
+ * vector_save_buffer, without copying it. begin and end point to const
+ * elements, so views are iterated like vectors, but they cannot be passed to
+ * any function that modifies a vector.
+ *
+ * int vector_view_init(VectorView *view, const void *buffer,
+ *                      size_t buffer_size)
+ *   Point view at the elements inside buffer, which must outlive the view.
+ *   Return 1 if the header is valid for SampleType, buffer holds every element
+ *   and the elements, 32 bytes into buffer, are aligned for SampleType (as
+ *   they are in memory from malloc(3) or mmap(2)), 0 otherwise. The checksum
+ *   is not checked.
+ *
+ * int vector_view_open(VectorView *view, const char *path)
+ *   Same as vector_view_init over a read-only mmap(2) of the whole file, which
+ *   only touches the pages being read. Return 0 without VECTOR_MMAP.
+ *
+ * void vector_view_close(VectorView *view)
+ *   Unmap the file opened by vector_view_open, if any, and empty the view.
+ *
+ * SampleType vector_view_get(const VectorView *view, size_t idx)
+ *   Get element at 0-based index. Panics if idx out of bounds.
+ *
+ * int vector_view_verify(const VectorView *view)
+ *   Return 1 if the elements match the checksum of the header, 0 otherwise.
+ *   Reads every element.
+ *
+ *
+ * File Vectors:
+ *
+ * VECTOR_DECLARE_FILE(Vector, vector, SampleType) and VECTOR_DEFINE_FILE()
+ * generate VectorFile, a vector whose buffer is a shared mmap(2) of a file in
+ * the vector_save format. Elements persist across runs and may exceed RAM,
+ * since the page cache backs them. Growing extends the file with ftruncate(2)
+ * and remaps it, so begin and end move like those of a heap vector and
+ * pointers into the vector are invalidated the same way.
+ *
+ * int vector_file_open(VectorFile *vec, const char *path)
+ *   Open or create the file at path. Return 1 on success, 0 if it cannot be
+ *   mapped or holds another element size, byte order or format version.
+ *
+ * int vector_file_sync(VectorFile *vec)
+ *   Write the size to the header and flush the mapping with msync(2).
+ *   Return 1 on success, 0 otherwise.
+ *
+ * int vector_file_close(VectorFile *vec)
+ *   Same as vector_file_sync, also updating the checksum, which reads every
+ *   element, then unmap and close the file. The file can then be read by
+ *   vector_load or vector_view_open. Return 1 on success, 0 otherwise.
+ *
+ * vector_file_grow, vector_file_resize, vector_file_push, vector_file_pop,
+ * vector_file_get, vector_file_set and vector_file_clear behave like their
+ * heap vector counterparts. Failing to grow the file panics. Unlike a heap
+ * vector, a zeroed VectorFile cannot grow: vector_file_grow, vector_file_resize
+ * and vector_file_push treat a VectorFile that vector_file_open did not open
+ * like a NULL one.
+ *
+ *
+ * Spill Vectors:
+ *
+ * VECTOR_DECLARE_SPILL(Vector, vector, SampleType) and VECTOR_DEFINE_SPILL()
+ * generate VectorSpill, a vector larger than its memory budget. Elements are
+ * stored in blocks of VECTOR_SPILL_BLOCK_BYTES; at most budget_bytes of blocks
+ * stay in memory, and the least recently used one is written to a tmpfile(3)
+ * when another is needed. A miss on the block following the previous miss
+ * reads ahead up to half of the budget in the same pass over the file, so
+ * sequential scans and pushes mostly perform large sequential I/O, while
+ * random accesses go through the block cache. Not being contiguous, a spill
+ * vector has no begin and end; vector_spill_span iterates it block by block.
+ * Failing to read or write the file panics. The file grows past 2 GiB where
+ * long is 64 bits, or with _fseeki64 or fseeko(3) (see VECTOR_FSEEK), which
+ * needs -D_FILE_OFFSET_BITS=64 on 32 bits Linux.
+ *
+ * int vector_spill_init(VectorSpill *vec, size_t budget_bytes)
+ *   Initialize an empty vector keeping at most budget_bytes of blocks in
+ *   memory, but at least two blocks. Return 1 on success, 0 if out of memory.
+ *
+ * void vector_spill_free(VectorSpill *vec)
+ *   Deallocate the blocks and delete the file.
+ *
+ * size_t vector_spill_size(const VectorSpill *vec)
+ * void vector_spill_push(VectorSpill *vec, SampleType value)
+ * SampleType vector_spill_pop(VectorSpill *vec)
+ * SampleType vector_spill_get(VectorSpill *vec, size_t idx)
+ * void vector_spill_set(VectorSpill *vec, size_t idx, SampleType value)
+ *   Same as their heap vector counterparts, except they may page blocks in.
+ *
+ * const SampleType *vector_spill_span(VectorSpill *vec, size_t idx,
+ *                                     size_t *count)
+ *   Page in the block of idx and return the address of element idx, setting
+ *   count to the number of elements contiguous to it, up to the end of its
+ *   block or of the vector. The span stays valid until the next call on vec.
+ *   Panics if idx out of bounds.
+ *
+ *
+ * Sorting:
+ *
+ * VECTOR_DEFINE_SORT(Vector, vector, SampleType, Less) generates sorting
+ * functions ordering elements by Less(a, b), a function or a function-like
+ * macro taking two elements by value and returning non-zero if a goes before
+ * b. Being expanded in the sort loops, a macro such as ((a) < (b)) is inlined
+ * in every comparison.
+ *
+ * void vector_sort(Vector *vec)
+ *   Sort the elements in place, in O(n log n) time. The sort is not stable.
+ *
+ * int vector_is_sorted(const Vector *vec)
+ *   Return 1 if the elements are sorted, 0 otherwise.
+ *
+ * void vector_span_sort(VectorSpan span)
+ * int vector_span_is_sorted(VectorSpan span)
+ *   Same as vector_sort and vector_is_sorted, for the elements of span.
+ *
+ * void vector_parallel_sort(Vector *vec)
+ * void vector_span_parallel_sort(VectorSpan span, VectorSpan scratch)
+ *   Same as vector_sort, on the threads of VECTOR_DEFINE_PARALLEL() (see
+ *   Parallel Algorithms below). The elements are cut in four blocks per
+ *   thread, of at least VECTOR_PARALLEL_GRAIN_BYTES, sorted concurrently, then
+ *   merged pairwise level by level. Each level is cut in chunks of the output,
+ *   located in their two input runs by binary search, so that the last merges
+ *   are split across threads too. Merging goes back and forth between the
+ *   elements and a scratch buffer of as many: scratch if it is large enough,
+ *   otherwise an allocated one, falling back to vector_sort if out of memory.
+ *   Without VECTOR_PARALLEL or with a single thread, same as vector_sort.
+ *
+ * int vector_sort_file(const char *input_path, const char *output_path,
+ *                      size_t budget_bytes)
+ *   Sort the vector saved by vector_save in input_path into a vector_save
+ *   file at output_path, which may be input_path, holding at most
+ *   budget_bytes of elements in memory. The output is written to output_path
+ *   followed by VECTOR_SORT_TEMP_SUFFIX (".tmp") and renamed over output_path
+ *   once complete, so a failure leaves input_path and output_path as they
+ *   were. Runs of budget_bytes are sorted into
+ *   a tmpfile(3), then merged in a single pass through a loser tree, reading
+ *   each run and writing the output in buffers of budget_bytes / (runs + 1),
+ *   at least one element. Return 1 on success, 0 if a file cannot be opened,
+ *   read or written, the input is not a valid vector_save file of the type,
+ *   or out of memory. Runs are read back with VECTOR_FSEEK, so inputs over
+ *   2 GiB need -D_FILE_OFFSET_BITS=64 on 32 bits Linux, as for spill vectors.
+ *
+ *
+ * Concurrent Vectors:
+ *
+ * VECTOR_DECLARE_CONCURRENT(Vector, vector, SampleType) and
+ * VECTOR_DEFINE_CONCURRENT() generate VectorConcurrent, an append-only vector
+ * any number of threads push to and read from without a lock. A push reserves
+ * its index with an atomic fetch-add on the size, writes the element, then
+ * sets the ready flag of the element with release semantics. Elements live in
+ * segments of VECTOR_CONCURRENT_FIRST_SEGMENT << k elements, allocated by the
+ * first push reaching them and never moved, so an element read stays valid
+ * until vector_concurrent_free. Requires C11 <stdatomic.h>, or the __atomic
+ * builtins of GCC and Clang in older modes. Allocation failures panic.
+ *
+ * void vector_concurrent_init(VectorConcurrent *vec)
+ * void vector_concurrent_free(VectorConcurrent *vec)
+ *   Initialize an empty vector, or deallocate its segments and empty it. Not
+ *   thread safe: no other thread may use vec meanwhile.
+ *
+ * size_t vector_concurrent_push(VectorConcurrent *vec, SampleType value)
+ *   Append element and return its index. Never waits for other pushes.
+ *
+ * size_t vector_concurrent_size(const VectorConcurrent *vec)
+ *   Return the number of pushes started, some of which may not have written
+ *   their element yet.
+ *
+ * int vector_concurrent_try_get(const VectorConcurrent *vec, size_t idx,
+ *                               SampleType *value)
+ *   Set value to the element at 0-based index and return 1 if it is
+ *   published, return 0 otherwise.
+ *
+ * SampleType vector_concurrent_get(const VectorConcurrent *vec, size_t idx)
+ *   Get published element at 0-based index, such as an index returned by a
+ *   push of the calling thread, or any index below the size once the pushing
+ *   threads are joined. Panics if the element is not published.
+ *
+ *
+ * RCU Vectors:
+ *
+ * VECTOR_DECLARE_RCU(Vector, vector, SampleType) and VECTOR_DEFINE_RCU()
+ * generate VectorRcu, an append-only vector with one writer thread and up to
+ * VECTOR_RCU_READERS reader threads scanning it without locks. Growing copies
+ * the elements to a new buffer and publishes it atomically (read-copy-update);
+ * the old buffer is retired at the current epoch and freed once no reader
+ * entered before that epoch is still reading. Readers get a snapshot: a
+ * VectorSpan of the elements published when the read began, which stay valid
+ * and unchanged until the read ends. Same atomics requirements as concurrent
+ * vectors. Allocation failures panic.
+ *
+ * void vector_rcu_init(VectorRcu *vec)
+ * void vector_rcu_free(VectorRcu *vec)
+ *   Initialize an empty vector, or deallocate every buffer and empty it. No
+ *   other thread may use vec meanwhile.
+ *
+ * void vector_rcu_push(VectorRcu *vec, SampleType value)
+ *   Append element. Writer thread only. Growing reclaims the retired buffers
+ *   no reader can hold anymore.
+ *
+ * size_t vector_rcu_size(const VectorRcu *vec)
+ *   Return the number of published elements.
+ *
+ * size_t vector_rcu_reclaim(VectorRcu *vec)
+ *   Free the retired buffers no reader can hold anymore and return the number
+ *   of those left. Writer thread only.
+ *
+ * VectorSpan vector_rcu_read_begin(VectorRcu *vec, size_t reader)
+ * void vector_rcu_read_end(VectorRcu *vec, size_t reader)
+ *   Begin a read in slot reader and return the snapshot, or end it. Each slot
+ *   below VECTOR_RCU_READERS may be used by one thread at a time, and reads do
+ *   not nest. A long read only delays freeing the buffers retired meanwhile.
+ *   Panics if reader is out of range.
+ *
+ *
+ * Queues:
+ *
+ * VECTOR_DECLARE_QUEUE(Vector, vector, SampleType) and VECTOR_DEFINE_QUEUE()
+ * generate two bounded lock-free queues over a power of two ring of elements,
+ * which may be generated vector types themselves to hand whole buffers over
+ * between threads. VectorSpsc has one producer and one consumer thread: each
+ * side owns its index on its own cache line and keeps a cached copy of the
+ * other one, only reloaded when the queue looks full or empty. VectorMpmc
+ * accepts any number of producers and consumers: every cell carries a
+ * sequence number telling whether it is ready to be written or read at the
+ * current lap (Vyukov's bounded queue), and threads claim cells with a
+ * compare-and-swap on the shared index. Same atomics requirements as
+ * concurrent vectors.
+ *
+ * int vector_spsc_init(VectorSpsc *queue, size_t capacity)
+ * int vector_mpmc_init(VectorMpmc *queue, size_t capacity)
+ *   Initialize an empty queue holding capacity elements, rounded up to a
+ *   power of two, at least 2. Return 1 on success, 0 if capacity overflows or
+ *   out of memory.
+ *
+ * void vector_spsc_free(VectorSpsc *queue)
+ * void vector_mpmc_free(VectorMpmc *queue)
+ *   Deallocate the ring, dropping the elements left. No other thread may use
+ *   queue meanwhile.
+ *
+ * int vector_spsc_push(VectorSpsc *queue, SampleType value)
+ * int vector_mpmc_push(VectorMpmc *queue, SampleType value)
+ *   Enqueue value. Return 1 on success, 0 if the queue is full.
+ *
+ * int vector_spsc_pop(VectorSpsc *queue, SampleType *value)
+ * int vector_mpmc_pop(VectorMpmc *queue, SampleType *value)
+ *   Dequeue the oldest element into value. Return 1 on success, 0 if the
+ *   queue is empty.
+ *
+ * size_t vector_spsc_push_batch(VectorSpsc *queue, const SampleType *values,
+ *                               size_t count)
+ * size_t vector_mpmc_push_batch(VectorMpmc *queue, const SampleType *values,
+ *                               size_t count)
+ *   Enqueue up to count values in order and return how many fit. The SPSC
+ *   queue publishes the whole batch at once with a single store of its tail.
+ *   A batch of the MPMC queue is claimed with a single compare-and-swap, but
+ *   its cells become visible to consumers one at a time, in order, as each
+ *   value is written.
+ *
+ * size_t vector_spsc_pop_batch(VectorSpsc *queue, SampleType *values,
+ *                              size_t count)
+ * size_t vector_mpmc_pop_batch(VectorMpmc *queue, SampleType *values,
+ *                              size_t count)
+ *   Dequeue up to count of the oldest elements into values and return how
+ *   many were available. A batch of the MPMC queue is claimed with a single
+ *   compare-and-swap and is contiguous in the queue order.
+ *
+ *
+ * Sharded Vectors:
+ *
+ * VECTOR_DECLARE_SHARDED(Vector, vector, SampleType) and
+ * VECTOR_DEFINE_SHARDED() generate VectorSharded, a set of Vector shards for
+ * gathering results from several threads without locks: each thread pushes to
+ * its own shard with the usual vector functions, and the headers of different
+ * shards never share a cache line. Gathering concatenates the shards in shard
+ * order: a prefix sum of their sizes gives each one its offset in the output,
+ * then every shard is copied with a single memcpy, possibly by its own thread.
+ *
+ * int vector_sharded_init(VectorSharded *sharded, size_t shard_count)
+ *   Initialize shard_count empty shards. Return 1 on success, 0 if out of
+ *   memory.
+ *
+ * void vector_sharded_free(VectorSharded *sharded)
+ *   Deallocate every shard.
+ *
+ * Vector *vector_sharded_shard(VectorSharded *sharded, size_t shard)
+ *   Return the shard numbered shard, which only one thread at a time may
+ *   modify. Panics if shard is out of range.
+ *
+ * size_t vector_sharded_size(const VectorSharded *sharded)
+ *   Return the number of elements of all shards.
+ *
+ * int vector_sharded_gather(VectorSharded *sharded, Vector *out)
+ *   Append the elements of every shard to out, leaving the shards unchanged.
+ *   Return 1 on success, 0 if the size of out would overflow.
+ *
+ * int vector_sharded_gather_begin(VectorSharded *sharded, Vector *out)
+ * void vector_sharded_gather_shard(const VectorSharded *sharded, Vector *out,
+ *                                  size_t shard)
+ *   The two steps of vector_sharded_gather, for copying the shards in
+ *   parallel. Once no shard changes anymore, one thread calls
+ *   vector_sharded_gather_begin to compute the offsets and resize out, then
+ *   any thread may copy any shard with vector_sharded_gather_shard, each
+ *   writing a disjoint range of out. Shards must not change in between.
+ *
+ *
+ * Parallel Algorithms:
+ *
+ * VECTOR_DECLARE_PARALLEL(Vector, vector, SampleType) and
+ * VECTOR_DEFINE_PARALLEL() generate loops splitting a vector in chunks of
+ * VECTOR_PARALLEL_GRAIN_BYTES, run by a pool of VECTOR_PARALLEL threads and
+ * the caller. Each thread starts with a contiguous range of chunks, then
+ * steals chunks from the others once done. Functions are called concurrently
+ * on different elements, and the loop returns once all of them returned. A
+ * loop started from inside another one runs on its own thread, and loops
+ * started by different threads take turns.
+ *
+ * void vector_parallel_for_each(Vector *vec,
+ *                               void (*function)(SampleType *element,
+ *                                                void *context),
+ *                               void *context)
+ *   Call function on every element.
+ *
+ * void vector_parallel_transform(Vector *dest, const Vector *src,
+ *                                SampleType (*function)(SampleType value,
+ *                                                       void *context),
+ *                                void *context)
+ *   Resize dest to the size of src and set each element to function of the
+ *   element of src at the same index. dest may be src.
+ *
+ * SampleType vector_parallel_reduce(const Vector *vec, SampleType identity,
+ *                                   SampleType (*combine)(SampleType a,
+ *                                                         SampleType b,
+ *                                                         void *context),
+ *                                   void *context)
+ *   Fold the elements with combine, which must be associative and have
+ *   identity as identity element. Every chunk is folded from identity, then
+ *   the results of the chunks in order, so the result does not depend on the
+ *   number of threads, even for floating point. Return identity if empty.
+ *
+ * void vector_parallel_fill(Vector *vec, SampleType value)
+ *   Set every element to value.
+ *
+ * void vector_parallel_duplicate(Vector *RESTRICT dest,
+ *                                const Vector *RESTRICT src, int fit)
+ *   Same as vector_duplicate, copying the elements in parallel, with
+ *   non-temporal stores from VECTOR_STREAM_BYTES. If fit is non-zero, the
+ *   capacity of dest is the size of src rather than its capacity.
+ *
+ * void vector_core_parallel_set_threads(size_t threads)
+ *   Use threads threads, the caller included, from the next loop on. 0, the
+ *   default, uses one per online CPU.
+ *
+ * void vector_core_parallel_shutdown(void)
+ *   Join the threads of the pool, which starts again with the next loop.
+ *
+ *
+ * Numeric Vectors:
+ *
+ * VECTOR_DECLARE_NUMERIC(Vector, vector, SampleType) and
+ * VECTOR_DEFINE_NUMERIC(Vector, vector, SampleType, Kind) generate searches
+ * and reductions for vectors of a 32 or 64 bits arithmetic type, Kind being
+ * one of VECTOR_I32, VECTOR_U32, VECTOR_I64, VECTOR_U64, VECTOR_F32 (float)
+ * and VECTOR_F64 (double). A Kind of another size than SampleType fails to
+ * compile. On x86-64 with GCC or Clang, searches compare 64 bytes per
+ * iteration with SSE2, or 128 bytes with AVX2 if the CPU has it, checked at
+ * run time; on AArch64, 16 bytes with NEON; elsewhere, one element at a time.
+ * Floating point sums use the same instructions. Integer sums and extremes
+ * keep independent accumulators the compiler vectorizes. Floating point
+ * elements compare as with ==: NaN equals nothing, and 0 equals -0.
+ *
+ * size_t vector_find(const Vector *vec, SampleType value)
+ *   Return the index of the first element equal to value, or VECTOR_NOT_FOUND.
+ *
+ * size_t vector_count(const Vector *vec, SampleType value)
+ *   Return the number of elements equal to value.
+ *
+ * int vector_contains(const Vector *vec, SampleType value)
+ *   Return 1 if an element is equal to value, 0 otherwise.
+ *
+ * size_t vector_find_if_eq(const Vector *vec, SampleType value,
+ *                          int (*equal)(SampleType a, SampleType b))
+ *   Same as vector_find, equal(element, value) returning non-zero for equal
+ *   elements, e.g. within a tolerance. Calls equal on every element in order
+ *   up to the first match, without SIMD.
+ *
+ * size_t vector_span_find(VectorSpan span, SampleType value)
+ * size_t vector_span_count(VectorSpan span, SampleType value)
+ * int vector_span_contains(VectorSpan span, SampleType value)
+ * size_t vector_span_find_if_eq(VectorSpan span, SampleType value,
+ *                               int (*equal)(SampleType a, SampleType b))
+ *   Same as the functions above, for the elements of span. Indexes are
+ *   relative to the beginning of span.
+ *
+ * SampleType vector_sum(const Vector *vec)
+ * SampleType vector_dot(const Vector *a, const Vector *b)
+ *   Return the sum of the elements, or of the products of the elements of a
+ *   and b at the same index, 0 if empty. Panics if a and b have different
+ *   sizes. Integer sums must fit SampleType. Floating point sums go through
+ *   VECTOR_REDUCE_LANES (16) accumulators: element i is added to accumulator
+ *   i % 16 up to the last multiple of 16, accumulator j then adds accumulator
+ *   j + 8 for j < 8, j + 4 for j < 4, j + 2 and j + 1, and the last elements
+ *   are added in order to accumulator 0. Every kernel follows that order, so
+ *   the result does not depend on the CPU, unless the compiler contracts
+ *   products and sums into fused multiply-adds (-ffp-contract).
+ *
+ * SampleType vector_sum_kahan(const Vector *vec)
+ *   Same as vector_sum with Kahan compensation, for floating point sums
+ *   accurate to about one rounding whatever the size, about twice as slow and
+ *   without SIMD kernels. Each accumulator is compensated, then the
+ *   accumulators, their errors and the last elements are added in order with
+ *   compensation. Requires strict floating point (no -ffast-math).
+ *
+ * SampleType vector_min(const Vector *vec)
+ * SampleType vector_max(const Vector *vec)
+ *   Return the smallest or the largest element. NaN elements are skipped,
+ *   returned only if all of them are NaN. Panics if empty.
+ *
+ * size_t vector_argmin(const Vector *vec)
+ * size_t vector_argmax(const Vector *vec)
+ *   Return the index of the first element equal to vector_min or vector_max,
+ *   or VECTOR_NOT_FOUND if empty or only NaN.
+ *
+ * int vector_core_simd_level
+ *   Widest instructions the searches and sums use: 0 for scalar code, 1 for
+ *   SSE2 or NEON, 2 (default) for AVX2 where the CPU has it. For testing and
+ *   benchmarking the kernels against each other.
+ *
+ *
+ * Static Vectors:
+ *
+ * VECTOR_DECLARE_STATIC(StaticVector, static_vector, SampleType, N) and
+ * VECTOR_DEFINE_STATIC(StaticVector, static_vector, SampleType) generate a
+ * vector storing up to N elements in the struct itself. It exposes the same
+ * functions as the heap vector and never calls VECTOR_REALLOC or VECTOR_FREE,
+ * which makes it usable where allocating is forbidden.
+ *
+ * Exceeding N (pushing to a full vector, or growing, resizing or initializing
+ * past N) follows the VECTOR_NO_PANIC_ON_OOB policy. vector_free only resets
+ * the vector. Since begin points into the struct, a static vector must not be
+ * copied by assignment or memcpy(3); use vector_duplicate instead.
+ *
+ *
+ * Incremental Vectors:
+ *
+ * VECTOR_DECLARE_INCREMENTAL(IncrementalVector, incremental_vector, SampleType)
+ * and VECTOR_DEFINE_INCREMENTAL(IncrementalVector, incremental_vector,
+ * SampleType) generate a vector whose growth never copies the whole buffer at
+ * once. Growing allocates the new buffer and leaves the elements in the old
+ * one; every following push then migrates VECTOR_INCREMENTAL_STEP_BYTES, the
+ * same way incremental rehashing works in hash tables. Migration always ends
+ * before the new buffer fills up, bounding the latency of every push.
+ *
+ * It provides vector_init, vector_free, vector_push, vector_pop, vector_get,
+ * vector_set and vector_clear with the same semantics as the heap vector.
+ * Indexing stays correct during a migration, but begin and end may only be
+ * iterated once it completes. In addition:
+ *
+ * int vector_migrate(IncrementalVector *vec)
+ *   Migrate one more step. Returns 1 if the migration is still in progress.
+ *
+ * void vector_finish_migration(IncrementalVector *vec)
+ *   Migrate all remaining elements at once, e.g. before iterating.
+ *
  *
  * Example:
  *  // VECTOR_X(TypeName, func_prefixes, StoredType)
@@ -173,6 +858,124 @@
 #define VECTOR_NO_PANIC_ON_NULL 0
 #endif
 
+#ifndef VECTOR_NO_CHECKS
+#define VECTOR_NO_CHECKS 0
+#endif
+
+#ifndef VECTOR_INCREMENTAL_STEP_BYTES
+#define VECTOR_INCREMENTAL_STEP_BYTES 65536
+#endif
+
+#ifndef VECTOR_SPILL_BLOCK_BYTES
+#define VECTOR_SPILL_BLOCK_BYTES 65536
+#endif
+
+#ifndef VECTOR_RCU_READERS
+#define VECTOR_RCU_READERS 16
+#endif
+
+#ifndef VECTOR_NO_ALLOC_GUARD
+#define VECTOR_NO_ALLOC_GUARD 0
+#endif
+
+#ifndef VECTOR_SHARED_CORE
+#define VECTOR_SHARED_CORE 0
+#endif
+
+#ifndef VECTOR_TRACE
+#define VECTOR_TRACE 0
+#endif
+
+#ifndef VECTOR_ACCOUNTING
+#define VECTOR_ACCOUNTING 0
+#endif
+
+#ifndef VECTOR_MMAP
+#define VECTOR_MMAP 0
+#endif
+
+#ifndef VECTOR_PARALLEL
+#define VECTOR_PARALLEL 0
+#endif
+
+#ifndef VECTOR_PARALLEL_GRAIN_BYTES
+#define VECTOR_PARALLEL_GRAIN_BYTES 65536
+#endif
+
+#ifndef VECTOR_STREAM_BYTES
+#define VECTOR_STREAM_BYTES 8388608
+#endif
+
+/* Seeks in temporary files, which outgrow a 32 bits long: _fseeki64 on
+ * Windows and fseeko(3) on POSIX systems, whose off_t is 64 bits (with
+ * -D_FILE_OFFSET_BITS=64 on 32 bits Linux). Elsewhere, files stop at LONG_MAX
+ * bytes */
+#if defined(_MSC_VER)
+#define VECTOR_OFFSET __int64
+#define VECTOR_FSEEK(File_, Offset_) _fseeki64((File_), (Offset_), SEEK_SET)
+#elif (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L) \
+	|| defined(__APPLE__)
+#define VECTOR_OFFSET off_t
+#define VECTOR_FSEEK(File_, Offset_) fseeko((File_), (Offset_), SEEK_SET)
+#else
+#define VECTOR_OFFSET long
+#define VECTOR_FSEEK(File_, Offset_) fseek((File_), (Offset_), SEEK_SET)
+#endif
+
+#if VECTOR_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* mremap(2) is Linux-only. Elsewhere the file holds the data, so mapping it
+ * again from scratch loses nothing */
+#ifdef MREMAP_MAYMOVE
+#define VECTOR_REMAP(Fd_, Mapping_, Old_Bytes_, New_Bytes_) \
+	mremap((Mapping_), (Old_Bytes_), (New_Bytes_), MREMAP_MAYMOVE)
+#else
+#define VECTOR_REMAP(Fd_, Mapping_, Old_Bytes_, New_Bytes_)        \
+	((void)munmap((Mapping_), (Old_Bytes_)),                   \
+	 mmap(NULL, (New_Bytes_), PROT_READ | PROT_WRITE, MAP_SHARED, \
+	      (Fd_), 0))
+#endif
+#endif
+
+#if VECTOR_PARALLEL
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef _SC_NPROCESSORS_ONLN
+#define VECTOR_ONLINE_CPUS() sysconf(_SC_NPROCESSORS_ONLN)
+#else
+#define VECTOR_ONLINE_CPUS() 1L
+#endif
+#endif
+
+/* Non-temporal stores of vector_core_stream_copy, part of the x86-64
+ * baseline */
+#if defined(__SSE2__) || defined(_M_X64) \
+	|| defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#include <emmintrin.h>
+#define VECTOR_STREAM 1
+#else
+#define VECTOR_STREAM 0
+#endif
+
+/* Kernels of the searches and sums of VECTOR_DEFINE_NUMERIC(): SSE2, or AVX2
+ * where the CPU has it, on x86-64 with GCC or Clang, NEON on AArch64, scalar
+ * elsewhere */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define VECTOR_SIMD 1
+#define VECTOR_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VECTOR_SIMD 2
+#else
+#define VECTOR_SIMD 0
+#endif
+
 #ifdef VECTOR_LONG_JUMP_NO_ABORT
 #include <setjmp.h>
 extern jmp_buf abort_jmp;
@@ -200,6 +1003,103 @@ extern jmp_buf abort_jmp;
 #define VECTOR_INLINE inline
 #endif
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define VECTOR_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+#define VECTOR_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define VECTOR_THREAD_LOCAL __declspec(thread)
+#else
+#define VECTOR_THREAD_LOCAL
+#endif
+
+/* Atomics of concurrent vectors: C11 <stdatomic.h>, else compiler builtins */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L \
+	&& !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define VECTOR_ATOMIC(Type_) _Atomic(Type_)
+#define VECTOR_ATOMIC_LOAD(Object_) \
+	atomic_load_explicit((Object_), memory_order_acquire)
+#define VECTOR_ATOMIC_STORE(Object_, Value_) \
+	atomic_store_explicit((Object_), (Value_), memory_order_release)
+#define VECTOR_ATOMIC_FETCH_ADD(Object_, Value_) \
+	atomic_fetch_add_explicit((Object_), (Value_), memory_order_relaxed)
+#define VECTOR_ATOMIC_CAS(Object_, Expected_, Desired_)                     \
+	atomic_compare_exchange_strong_explicit((Object_), (Expected_),     \
+						(Desired_),                 \
+						memory_order_acq_rel,       \
+						memory_order_acquire)
+#define VECTOR_ATOMIC_FENCE() atomic_thread_fence(memory_order_seq_cst)
+#elif defined(__GNUC__) || defined(__clang__)
+#define VECTOR_ATOMIC(Type_) Type_
+#define VECTOR_ATOMIC_LOAD(Object_) __atomic_load_n((Object_), __ATOMIC_ACQUIRE)
+#define VECTOR_ATOMIC_STORE(Object_, Value_) \
+	__atomic_store_n((Object_), (Value_), __ATOMIC_RELEASE)
+#define VECTOR_ATOMIC_FETCH_ADD(Object_, Value_) \
+	__atomic_fetch_add((Object_), (Value_), __ATOMIC_RELAXED)
+#define VECTOR_ATOMIC_CAS(Object_, Expected_, Desired_)                  \
+	__atomic_compare_exchange_n((Object_), (Expected_), (Desired_), 0, \
+				    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define VECTOR_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+/* Only declares the types: concurrent and RCU vectors need atomics */
+#define VECTOR_ATOMIC(Type_) Type_
+#endif
+
+/* Counters of VECTOR_TRACE and VECTOR_ACCOUNTING, atomic where atomics are
+ * available so that threads update them concurrently. Otherwise, they are
+ * plain variables and instrumentation is limited to a single thread */
+#ifdef VECTOR_ATOMIC_CAS
+#define VECTOR_COUNTER(Type_) VECTOR_ATOMIC(Type_)
+#define VECTOR_COUNTER_LOAD(Object_) VECTOR_ATOMIC_LOAD(Object_)
+#define VECTOR_COUNTER_STORE(Object_, Value_) \
+	VECTOR_ATOMIC_STORE(Object_, Value_)
+#define VECTOR_COUNTER_ADD(Object_, Value_) \
+	((void)VECTOR_ATOMIC_FETCH_ADD(Object_, Value_))
+#define VECTOR_COUNTER_CAS(Object_, Expected_, Desired_) \
+	VECTOR_ATOMIC_CAS(Object_, Expected_, Desired_)
+#else
+#define VECTOR_COUNTER(Type_) Type_
+#define VECTOR_COUNTER_LOAD(Object_) (*(Object_))
+#define VECTOR_COUNTER_STORE(Object_, Value_) ((void)(*(Object_) = (Value_)))
+#define VECTOR_COUNTER_ADD(Object_, Value_) ((void)(*(Object_) += (Value_)))
+#define VECTOR_COUNTER_CAS(Object_, Expected_, Desired_) \
+	(*(Object_) = (Desired_), 1)
+#endif
+
+#ifndef __STDC_VERSION__
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_STATIC_INLINE static __inline__
+#else
+#define VECTOR_STATIC_INLINE static
+#endif
+#elif _MSC_VER
+#define VECTOR_STATIC_INLINE static __forceinline
+#else
+#define VECTOR_STATIC_INLINE static inline
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_LIKELY(x) (__builtin_expect(!!(x), 1))
+#define VECTOR_UNLIKELY(x) (__builtin_expect(!!(x), 0))
+#define VECTOR_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define VECTOR_LIKELY(x) (x)
+#define VECTOR_UNLIKELY(x) (x)
+#define VECTOR_COLD __declspec(noinline)
+#else
+#define VECTOR_LIKELY(x) (x)
+#define VECTOR_UNLIKELY(x) (x)
+#define VECTOR_COLD
+#endif
+
+/* Default linkage of generated functions, never empty as it is passed along
+ * macro arguments */
+#define VECTOR_EXTERN extern
+
+/* Argument validation, compiled away with VECTOR_NO_CHECKS */
+#define VECTOR_CHECK(x) (!VECTOR_NO_CHECKS && VECTOR_UNLIKELY(x))
+
 #ifndef __STDC_VERSION__
 #define RESTRICT
 #else
@@ -209,404 +1109,7458 @@ extern jmp_buf abort_jmp;
 #define VECTOR_SIZE(vec) (size_t)((vec)->end - (vec)->begin)
 #define VECTOR_IS_SIZE_ZERO(vec) ((vec)->end == (vec)->begin)
 #define VECTOR_CAPACITY(vec) (size_t)((vec)->end_of_storage - (vec)->begin)
+#define VECTOR_STATIC_CAPACITY(vec) \
+	(sizeof((vec)->storage) / sizeof((vec)->storage[0]))
 
-enum { VECTOR_DEFAULT_CAPACITY = 8, VECTOR_GROWTH_FACTOR = 2 };
-typedef int SampleType;
-
-/* Declarations start here */
-
-typedef struct Vector {
-	SampleType *begin;
-	SampleType *end;
-	SampleType *end_of_storage;
-} Vector;
+#if VECTOR_NO_ALLOC_GUARD
+extern VECTOR_THREAD_LOCAL int vector_no_alloc_depth;
+#define VECTOR_NO_ALLOC_BEGIN() (vector_no_alloc_depth++)
+#define VECTOR_NO_ALLOC_END() (vector_no_alloc_depth--)
+#define VECTOR_IS_ALLOC_FORBIDDEN() (vector_no_alloc_depth != 0)
+#else
+#define VECTOR_NO_ALLOC_BEGIN() ((void)0)
+#define VECTOR_NO_ALLOC_END() ((void)0)
+#define VECTOR_IS_ALLOC_FORBIDDEN() 0
+#endif
 
-VECTOR_NORETURN void vector_panic(const char *message);
-void vector_assert(const Vector *vec);
-void vector_grow(Vector *vec, size_t element_count);
-void vector_resize(Vector *vec, size_t element_count);
-void vector_free(Vector *vec);
-void vector_init(Vector *vec, size_t element_count);
-void vector_push(Vector *vec, SampleType value);
-SampleType vector_pop(Vector *vec);
-SampleType vector_get(const Vector *vec, size_t idx);
-void vector_set(Vector *vec, size_t idx, SampleType value);
-void vector_insert(Vector *vec, size_t idx, SampleType value);
-void vector_delete(Vector *vec, size_t idx);
-void vector_duplicate(Vector *RESTRICT dest, const Vector *RESTRICT src);
-void vector_clear(Vector *vec);
-/* Declarations stop here */
+/* Reports an allocation, deallocation or copy to the per-type counters and to
+ * vector_core_trace_callback, compiled away without VECTOR_TRACE */
+#if VECTOR_TRACE
+#define VECTOR_TRACE_EVENT(Counters_, Kind_, Type_Name_, Function_,         \
+			   Old_Capacity_, New_Capacity_, Bytes_)            \
+	vector_core_trace(&(Counters_), (Kind_), (Type_Name_), (Function_), \
+			  (Old_Capacity_), (New_Capacity_), (Bytes_))
+#else
+#define VECTOR_TRACE_EVENT(Counters_, Kind_, Type_Name_, Function_, \
+			   Old_Capacity_, New_Capacity_, Bytes_)    \
+	((void)0)
+#endif
 
-#ifdef VECTOR_LONG_JUMP_NO_ABORT
-#define VECTOR_DEFINE_PANIC(Function_Prefix_)                              \
-	VECTOR_NORETURN void Function_Prefix_##_panic(const char *message) \
-	{                                                                  \
-		assert(message);                                           \
-		longjmp(abort_jmp, 1);                                     \
-	}
+/* Reports a change of capacity or size to the per-type accounting, compiled
+ * away without VECTOR_ACCOUNTING */
+#if VECTOR_ACCOUNTING
+#define VECTOR_ACCOUNT(Function_, Old_Capacity_, Old_Size_, New_Capacity_, \
+		       New_Size_)                                           \
+	Function_((Old_Capacity_), (Old_Size_), (New_Capacity_), (New_Size_))
 #else
-#define VECTOR_DEFINE_PANIC(Function_Prefix_)                              \
-	VECTOR_NORETURN void Function_Prefix_##_panic(const char *message) \
-	{                                                                  \
-		assert(message);                                           \
-		(void)fprintf(stderr, "%s\n", message);                    \
-		abort();                                                   \
-	}
+#define VECTOR_ACCOUNT(Function_, Old_Capacity_, Old_Size_, New_Capacity_, \
+		       New_Size_)                                           \
+	((void)0)
 #endif
 
-/* Definitions start here */
-struct Vector;
-VECTOR_DEFINE_PANIC(vector)
+enum { VECTOR_DEFAULT_CAPACITY = 8, VECTOR_GROWTH_FACTOR = 2 };
+/* Type-erased slow paths shared by every vector type, see VECTOR_SHARED_CORE */
+size_t vector_core_grow(void **begin, size_t capacity, size_t element_count,
+			size_t element_size);
+void vector_core_insert(void *begin, size_t size, size_t idx,
+			size_t element_size);
+void vector_core_delete(void *begin, size_t size, size_t idx,
+			size_t element_size);
+void *vector_core_duplicate(const void *begin, size_t size, size_t capacity,
+			    size_t element_size);
 
-VECTOR_INLINE void vector_assert(const struct Vector *vec)
-{
-	if (vec->begin == NULL) {
-		assert(vec->end == NULL && vec->end_of_storage == NULL);
-		return;
-	}
+/* Instrumentation of VECTOR_TRACE, see VECTOR_TRACE */
+enum { VECTOR_TRACE_REALLOC, VECTOR_TRACE_FREE, VECTOR_TRACE_COPY };
 
-	assert(vec->end && vec->end_of_storage);
-	assert(vec->begin <= vec->end && vec->end <= vec->end_of_storage);
-}
+typedef struct VectorCoreTraceEvent {
+	const char *type_name;
+	const char *function;
+	int kind;
+	size_t old_capacity;
+	size_t new_capacity;
+	size_t bytes;
+} VectorCoreTraceEvent;
 
-void vector_grow(struct Vector *vec, size_t element_count)
-{
-	size_t old_size = 0;
-	SampleType *new_begin = NULL;
+/* Every translation unit has its own counters for a vector type. The first
+ * ones registered under the type name in vector_core_trace_registry count the
+ * events of all of them */
+typedef struct VectorCoreTraceCounters {
+	const char *type_name;
+	struct VectorCoreTraceCounters *next;
+	VECTOR_COUNTER(struct VectorCoreTraceCounters *) shared;
+	VECTOR_COUNTER(size_t) reallocs;
+	VECTOR_COUNTER(size_t) realloc_bytes;
+	VECTOR_COUNTER(size_t) frees;
+	VECTOR_COUNTER(size_t) free_bytes;
+	VECTOR_COUNTER(size_t) copies;
+	VECTOR_COUNTER(size_t) copy_bytes;
+} VectorCoreTraceCounters;
 
-	if (vec == NULL) {
-		if (VECTOR_NO_PANIC_ON_NULL) {
-			return;
-		}
-		vector_panic(
-			"Null passed to vector_grow but non-null argument expected.");
-	}
-	vector_assert(vec);
+extern void (*vector_core_trace_callback)(const VectorCoreTraceEvent *event);
+extern VECTOR_COUNTER(VectorCoreTraceCounters *) vector_core_trace_registry;
+void vector_core_trace(VectorCoreTraceCounters *counters, int kind,
+		       const char *type_name, const char *function,
+		       size_t old_capacity, size_t new_capacity, size_t bytes);
+void vector_core_trace_dump(VectorCoreTraceCounters *counters,
+			    const char *type_name, FILE *stream);
 
-	if (element_count != 0
-	    && sizeof(SampleType) > ((size_t)-1) / element_count) {
-		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
-			return;
-		}
-		vector_panic("Requested capacity would cause size overflow.");
-	}
+/* Memory accounting of VECTOR_ACCOUNTING, see VECTOR_ACCOUNTING. Bucket 0 of
+ * the slack histogram counts vectors without slack, bucket n those with a
+ * slack in [2^(n-1), 2^n) bytes. As with the trace counters, the first entry
+ * registered under a type name accounts for every translation unit */
+enum { VECTOR_ACCOUNT_BUCKETS = sizeof(size_t) * 8 + 1 };
 
-	if (vec->begin) {
-		if (VECTOR_CAPACITY(vec) == element_count) {
-			return;
-		}
-		if (VECTOR_CAPACITY(vec) > element_count) {
-			vector_panic("Vector shrinking not supported.");
-		}
-	}
+typedef struct VectorCoreAccountStats {
+	const char *type_name;
+	struct VectorCoreAccountStats *next;
+	VECTOR_COUNTER(struct VectorCoreAccountStats *) shared;
+	VECTOR_COUNTER(size_t) live;
+	VECTOR_COUNTER(size_t) capacity_bytes;
+	VECTOR_COUNTER(size_t) size_bytes;
+	VECTOR_COUNTER(size_t) slack[VECTOR_ACCOUNT_BUCKETS];
+} VectorCoreAccountStats;
 
-	old_size = VECTOR_SIZE(vec);
+extern VECTOR_COUNTER(VectorCoreAccountStats *) vector_core_account_registry;
+VectorCoreAccountStats *
+vector_core_account_shared(VectorCoreAccountStats *stats);
+void vector_core_account(VectorCoreAccountStats *stats, size_t element_size,
+			 size_t old_capacity, size_t old_size,
+			 size_t new_capacity, size_t new_size);
+void vector_core_account_print(FILE *stream);
+
+/* Binary format of VECTOR_DEFINE_SERIAL(), a VECTOR_SERIAL_HEADER_SIZE bytes
+ * header followed by the elements as laid out in memory:
+ * - 0: "VECTOR", format version, 'L' or 'B' for the byte order of elements
+ * - 8: element size, 4 bytes little-endian
+ * - 12: FNV-1a checksum of the elements, 4 bytes little-endian
+ * - 16: element count, 8 bytes little-endian
+ * - 24: reserved, zero */
+enum { VECTOR_SERIAL_HEADER_SIZE = 32, VECTOR_SERIAL_VERSION = 1 };
+
+/* Bytes vector_load reads at least at once. The element count of a stream is
+ * only trusted as far as elements arrive, the vector growing geometrically
+ * while they are read, so a corrupted count fails on a short read */
+#define VECTOR_SERIAL_CHUNK_BYTES 65536
+
+/* FNV-1a of data, or of the bytes hashed into hash so far when updating */
+#define VECTOR_CHECKSUM_INIT 2166136261UL
+unsigned long vector_core_checksum(const void *data, size_t size);
+unsigned long vector_core_checksum_update(unsigned long hash, const void *data,
+					  size_t size);
+int vector_core_serial_header(unsigned char *header, size_t element_size,
+			      size_t count, unsigned long checksum);
+int vector_core_serial_parse(const unsigned char *header, size_t element_size,
+			     size_t *count, unsigned long *checksum);
+
+/* Read-only mapping of a whole file with VECTOR_MMAP, NULL on failure or
+ * without VECTOR_MMAP */
+const void *vector_core_map(const char *path, size_t *size);
+void vector_core_unmap(const void *mapping, size_t size);
+
+/* Shared mapping of a file in the VECTOR_DEFINE_SERIAL() format, whose size
+ * is the header plus the capacity; NULL on failure or without VECTOR_MMAP */
+unsigned char *vector_core_file_open(const char *path, size_t element_size,
+				     int *fd, size_t *count, size_t *capacity);
+unsigned char *vector_core_file_resize(int fd, unsigned char *mapping,
+				       size_t old_bytes, size_t new_bytes);
+int vector_core_file_sync(unsigned char *mapping, size_t bytes,
+			  size_t element_size, size_t count, int checksum);
+int vector_core_file_close(int fd, unsigned char *mapping, size_t bytes);
+
+/* Block cache of spill vectors. Slots hold the blocks in memory, the others
+ * live in a tmpfile(3) created on the first eviction */
+typedef struct VectorCoreSpill {
+	FILE *file;
+	size_t element_size;
+	size_t block_elements;
+	size_t size;
+	size_t disk_blocks;
+	size_t slot_count;
+	unsigned char *slots;
+	size_t *slot_block;
+	unsigned long *slot_used;
+	unsigned char *slot_dirty;
+	unsigned long clock;
+	size_t last_slot;
+	size_t last_miss;
+} VectorCoreSpill;
+
+int vector_core_spill_init(VectorCoreSpill *spill, size_t element_size,
+			   size_t budget_bytes);
+void vector_core_spill_free(VectorCoreSpill *spill);
+unsigned char *vector_core_spill_at(VectorCoreSpill *spill, size_t idx,
+				    int dirty);
+
+/* Sorted run of vector_sort_file: elements [next, end) of the runs file are
+ * still on disk, elements [pos, len) of its buffer are still to be merged */
+typedef struct VectorCoreRun {
+	size_t next;
+	size_t end;
+	size_t pos;
+	size_t len;
+} VectorCoreRun;
+
+enum { VECTOR_SORT_INSERTION_SIZE = 16 };
+
+int vector_core_run_refill(FILE *file, VectorCoreRun *run, void *buffer,
+			   size_t buffer_elements, size_t element_size);
+
+/* vector_sort_file writes path followed by VECTOR_SORT_TEMP_SUFFIX, then
+ * renames it over path. The temporary path is allocated by VECTOR_REALLOC,
+ * NULL if out of memory */
+#define VECTOR_SORT_TEMP_SUFFIX ".tmp"
+char *vector_core_temp_path(const char *path);
+int vector_core_replace(const char *temp_path, const char *path);
+
+/* Segment k of a concurrent vector holds VECTOR_CONCURRENT_FIRST_SEGMENT << k
+ * elements */
+enum { VECTOR_CONCURRENT_FIRST_SEGMENT = VECTOR_DEFAULT_CAPACITY };
+#define VECTOR_CONCURRENT_SEGMENTS (sizeof(size_t) * 8)
+
+size_t vector_core_concurrent_locate(size_t idx, size_t *offset);
+
+/* Buffer of an RCU vector. Once replaced by a larger one, it is retired at
+ * the epoch of the replacement and linked to the other retired buffers */
+typedef struct VectorCoreRcuBuffer {
+	void *begin;
+	VECTOR_ATOMIC(size_t) size;
+	size_t capacity;
+	size_t retired_epoch;
+	struct VectorCoreRcuBuffer *next;
+} VectorCoreRcuBuffer;
+
+/* Epoch a reader entered, 0 outside of reads, alone on its cache line */
+enum { VECTOR_CACHE_LINE = 64 };
+typedef struct VectorCoreRcuReader {
+	VECTOR_ATOMIC(size_t) epoch;
+	char padding[VECTOR_CACHE_LINE - sizeof(size_t)];
+} VectorCoreRcuReader;
+
+size_t vector_core_ring_capacity(size_t capacity);
+
+/* Parallel loops of VECTOR_DEFINE_PARALLEL(). vector_core_parallel_run calls
+ * task on every chunk of [0, count): chunk c is [c * grain, (c + 1) * grain),
+ * the last one ending at count. Chunks are spread over the pool threads and
+ * the caller, see VECTOR_PARALLEL; without it the caller runs them all */
+typedef void (*VectorCoreParallelTask)(void *context, size_t chunk,
+				       size_t begin, size_t end);
+
+#define VECTOR_PARALLEL_GRAIN(Element_Size_)                  \
+	((Element_Size_) < VECTOR_PARALLEL_GRAIN_BYTES        \
+		 ? VECTOR_PARALLEL_GRAIN_BYTES / (Element_Size_) \
+		 : 1)
+
+void vector_core_parallel_run(size_t count, size_t grain,
+			      VectorCoreParallelTask task, void *context);
+size_t vector_core_parallel_threads(void);
+void vector_core_parallel_set_threads(size_t threads);
+void vector_core_parallel_shutdown(void);
+
+/* memcpy(3) with non-temporal stores where available, for copies larger than
+ * the cache that would only evict data still in use */
+void vector_core_stream_copy(void *dest, const void *src, size_t bytes);
+
+/* Element types of VECTOR_DEFINE_NUMERIC(): 32 and 64 bits integers and IEEE
+ * 754 floating point numbers */
+enum {
+	VECTOR_I32,
+	VECTOR_U32,
+	VECTOR_I64,
+	VECTOR_U64,
+	VECTOR_F32,
+	VECTOR_F64
+};
+#define VECTOR_KIND_SIZE(Kind_)                           \
+	((Kind_) == VECTOR_I32 || (Kind_) == VECTOR_U32 \
+			 || (Kind_) == VECTOR_F32       \
+		 ? 4                                       \
+		 : 8)
+#define VECTOR_NOT_FOUND ((size_t)-1)
+
+/* Widest instructions the kernels of VECTOR_DEFINE_SHARED_SIMD() may use: 0
+ * for scalar code, 1 for SSE2 or NEON, 2 (default) for AVX2 where the CPU has
+ * it */
+extern int vector_core_simd_level;
+
+/* Index of the first of size elements of kind equal to *value, or
+ * VECTOR_NOT_FOUND, and number of them. Floating point numbers compare as with
+ * ==, NaN equal to nothing and -0 equal to 0 */
+size_t vector_core_find(int kind, const void *begin, size_t size,
+			const void *value);
+size_t vector_core_count(int kind, const void *begin, size_t size,
+			 const void *value);
+
+/* Same on the bits of elements of 4 or 8 bytes, the kernels of
+ * VECTOR_DEFINE_SHARED_SIMD() falling back to the scalar ones */
+size_t vector_core_find_bits(const void *begin, size_t size, const void *value,
+			     size_t element_size);
+size_t vector_core_count_bits(const void *begin, size_t size, const void *value,
+			      size_t element_size);
+size_t vector_core_find_scalar(const void *begin, size_t size,
+			       const void *value, size_t element_size);
+size_t vector_core_count_scalar(const void *begin, size_t size,
+				const void *value, size_t element_size);
+
+/* Element i of a reduction goes to accumulator i % VECTOR_REDUCE_LANES, up to
+ * the last full round of them */
+enum { VECTOR_REDUCE_LANES = 16 };
+
+/* Sum of size floating point elements of kind at a, or of their products with
+ * the ones at b if not NULL, to *result. The kernels of
+ * VECTOR_DEFINE_SHARED_SIMD() add the elements in the same order (see Numeric
+ * Vectors), giving the same result */
+void vector_core_sum(int kind, const void *a, const void *b, size_t size,
+		     void *result);
+int vector_core_is_nan(int kind, const void *value);
+
+float vector_core_sum_f32(const float *a, const float *b, size_t size);
+double vector_core_sum_f64(const double *a, const double *b, size_t size);
+float vector_core_sum_f32_scalar(const float *a, const float *b, size_t size);
+double vector_core_sum_f64_scalar(const double *a, const double *b,
+				  size_t size);
+float vector_core_sum_f32_tail(float sum, const float *a, const float *b,
+			       size_t count);
+double vector_core_sum_f64_tail(double sum, const double *a, const double *b,
+				size_t count);
+
+/* Samples start here */
+typedef int SampleType;
+#define SampleLess(a, b) ((a) < (b))
+#define SampleKind VECTOR_I32
+#define SampleLinkage VECTOR_EXTERN
+#define SamplePanicLinkage VECTOR_EXTERN
+enum { SAMPLE_CAPACITY = 16 };
+#if VECTOR_TRACE
+static VectorCoreTraceCounters static_vector_trace_counters;
+static VectorCoreTraceCounters incremental_vector_trace_counters;
+#endif
+/* Samples stop here */
+
+/* Macro VECTOR_DECLARE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage, Panic_Linkage_=SamplePanicLinkage) start here */
+
+typedef struct Vector {
+	SampleType *begin;
+	SampleType *end;
+	SampleType *end_of_storage;
+} Vector;
+
+typedef struct VectorSpan {
+	SampleType *begin;
+	SampleType *end;
+} VectorSpan;
+
+VECTOR_NORETURN SamplePanicLinkage VECTOR_COLD void vector_panic(
+	const char *message);
+SampleLinkage void vector_assert(const Vector *vec);
+SampleLinkage void vector_grow(Vector *vec, size_t element_count);
+SampleLinkage void vector_resize(Vector *vec, size_t element_count);
+SampleLinkage void vector_free(Vector *vec);
+SampleLinkage void vector_init(Vector *vec, size_t element_count);
+SampleLinkage void vector_push(Vector *vec, SampleType value);
+SampleLinkage int vector_try_push(Vector *vec, SampleType value);
+SampleLinkage SampleType vector_pop(Vector *vec);
+SampleLinkage SampleType vector_get(const Vector *vec, size_t idx);
+SampleLinkage void vector_set(Vector *vec, size_t idx, SampleType value);
+SampleLinkage void vector_insert(Vector *vec, size_t idx, SampleType value);
+SampleLinkage int vector_try_insert(Vector *vec, size_t idx, SampleType value);
+SampleLinkage void vector_delete(Vector *vec, size_t idx);
+SampleLinkage void vector_duplicate(Vector *RESTRICT dest,
+				    const Vector *RESTRICT src);
+SampleLinkage void vector_clear(Vector *vec);
+SampleLinkage void vector_trace_dump(FILE *stream);
+SampleLinkage void vector_account(size_t old_capacity, size_t old_size,
+				  size_t new_capacity, size_t new_size);
+SampleLinkage const VectorCoreAccountStats *vector_account_stats(void);
+
+VECTOR_STATIC_INLINE SampleType vector_get_unchecked(const Vector *vec,
+						     size_t idx)
+{
+	return vec->begin[idx];
+}
+
+VECTOR_STATIC_INLINE void vector_set_unchecked(Vector *vec, size_t idx,
+					       SampleType value)
+{
+	vec->begin[idx] = value;
+}
+
+VECTOR_STATIC_INLINE void vector_push_unchecked(Vector *vec, SampleType value)
+{
+	if (VECTOR_UNLIKELY(vec->end == vec->end_of_storage)) {
+		vector_grow(vec, vec->begin ? VECTOR_CAPACITY(vec)
+						      * VECTOR_GROWTH_FACTOR
+					    : VECTOR_DEFAULT_CAPACITY);
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+}
+
+VECTOR_STATIC_INLINE VectorSpan vector_span(const Vector *vec)
+{
+	VectorSpan span = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return span;
+		}
+		vector_panic(
+			"Null passed to vector_span but non-null argument expected.");
+	}
+
+	span.begin = vec->begin;
+	span.end = vec->end;
+	return span;
+}
+
+VECTOR_STATIC_INLINE VectorSpan vector_span_subslice(VectorSpan span,
+						     size_t idx, size_t count)
+{
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(&span)
+			 || count > VECTOR_SIZE(&span) - idx)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			span.begin = span.end;
+			return span;
+		}
+		vector_panic("Out of range.");
+	}
+
+	span.begin += idx;
+	span.end = span.begin + count;
+	return span;
+}
+
+VECTOR_STATIC_INLINE SampleType vector_span_get(VectorSpan span, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(&span))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		vector_panic("Out of range.");
+	}
+
+	return span.begin[idx];
+}
+
+VECTOR_STATIC_INLINE void vector_span_split_at(VectorSpan span, size_t idx,
+					       VectorSpan *head,
+					       VectorSpan *tail)
+{
+	if (VECTOR_CHECK(head == NULL || tail == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_span_split_at but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(&span))) {
+		if (!VECTOR_NO_PANIC_ON_OOB) {
+			vector_panic("Out of range.");
+		}
+		idx = VECTOR_SIZE(&span);
+	}
+
+	head->begin = span.begin;
+	head->end = span.begin + idx;
+	tail->begin = head->end;
+	tail->end = span.end;
+}
+
+VECTOR_STATIC_INLINE int vector_span_next_chunk(VectorSpan *rest,
+						size_t chunk_size,
+						VectorSpan *chunk)
+{
+	if (VECTOR_CHECK(rest == NULL || chunk == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_span_next_chunk but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(chunk_size == 0)) {
+		vector_panic("Chunk size of 0 passed to vector_span_next_chunk.");
+	}
+
+	if (rest->begin == rest->end) {
+		return 0;
+	}
+	chunk->begin = rest->begin;
+	chunk->end = chunk_size < VECTOR_SIZE(rest) ? rest->begin + chunk_size
+						     : rest->end;
+	rest->begin = chunk->end;
+	return 1;
+}
+/* Macro VECTOR_DECLARE_LINKAGE stop here */
+
+#ifdef VECTOR_LONG_JUMP_NO_ABORT
+#define VECTOR_DEFINE_PANIC(Function_Prefix_, Linkage_)                    \
+	VECTOR_NORETURN Linkage_ VECTOR_COLD void Function_Prefix_##_panic( \
+		const char *message)                                       \
+	{                                                                  \
+		assert(message);                                           \
+		longjmp(abort_jmp, 1);                                     \
+	}
+#else
+#define VECTOR_DEFINE_PANIC(Function_Prefix_, Linkage_)                    \
+	VECTOR_NORETURN Linkage_ VECTOR_COLD void Function_Prefix_##_panic( \
+		const char *message)                                       \
+	{                                                                  \
+		assert(message);                                           \
+		(void)fprintf(stderr, "%s\n", message);                    \
+		abort();                                                   \
+	}
+#endif
+
+/* Macro VECTOR_DEFINE_SHARED_CORE_BASE() start here */
+VECTOR_DEFINE_PANIC(vector_core, static)
+
+size_t vector_core_grow(void **begin, size_t capacity, size_t element_count,
+			size_t element_size)
+{
+	void *new_begin = NULL;
+
+	if (VECTOR_UNLIKELY(element_count != 0
+			    && element_size > ((size_t)-1) / element_count)) {
+		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+			return capacity;
+		}
+		vector_core_panic(
+			"Requested capacity would cause size overflow.");
+	}
+
+	if (*begin) {
+		if (capacity == element_count) {
+			return capacity;
+		}
+		if (capacity > element_count) {
+			vector_core_panic("Vector shrinking not supported.");
+		}
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_core_panic("Allocation inside a no-alloc region.");
+	}
+
+	new_begin = VECTOR_REALLOC(*begin, element_count * element_size);
+	if (VECTOR_UNLIKELY(new_begin == NULL)) {
+		vector_core_panic("Out of memory. Panic.");
+	}
+
+	*begin = new_begin;
+	return element_count;
+}
+
+void vector_core_insert(void *begin, size_t size, size_t idx,
+			size_t element_size)
+{
+	char *middle = (char *)begin + idx * element_size;
+
+	memmove(middle + element_size, middle, (size - idx) * element_size);
+}
+
+void vector_core_delete(void *begin, size_t size, size_t idx,
+			size_t element_size)
+{
+	char *middle = (char *)begin + idx * element_size;
+
+	memmove(middle, middle + element_size, (size - idx - 1) * element_size);
+}
+
+void *vector_core_duplicate(const void *begin, size_t size, size_t capacity,
+			    size_t element_size)
+{
+	void *new_begin = NULL;
+
+	if (capacity == 0) {
+		return NULL;
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_core_panic("Allocation inside a no-alloc region.");
+	}
+
+	new_begin = VECTOR_REALLOC(NULL, capacity * element_size);
+	if (VECTOR_UNLIKELY(new_begin == NULL)) {
+		vector_core_panic("Out of memory.");
+	}
+
+	memcpy(new_begin, begin, size * element_size);
+	return new_begin;
+}
+
+void (*vector_core_trace_callback)(const VectorCoreTraceEvent *event) = NULL;
+VECTOR_COUNTER(VectorCoreTraceCounters *) vector_core_trace_registry = NULL;
+
+/* Serializes registrations, once per translation unit and type. Readers walk
+ * the registries without it: the release store of a registry head publishes
+ * the entry, which is never unlinked */
+static VECTOR_COUNTER(int) vector_core_registry_lock = 0;
+
+static void vector_core_registry_acquire(void)
+{
+	int expected = 0;
+
+	while (!VECTOR_COUNTER_CAS(&vector_core_registry_lock, &expected, 1)) {
+		expected = 0;
+	}
+}
+
+static void vector_core_registry_release(void)
+{
+	VECTOR_COUNTER_STORE(&vector_core_registry_lock, 0);
+}
+
+static VectorCoreTraceCounters *
+vector_core_trace_shared(VectorCoreTraceCounters *counters,
+			 const char *type_name)
+{
+	VectorCoreTraceCounters *shared = NULL;
+
+	shared = VECTOR_COUNTER_LOAD(&counters->shared);
+	if (VECTOR_LIKELY(shared != NULL)) {
+		return shared;
+	}
+
+	vector_core_registry_acquire();
+	shared = VECTOR_COUNTER_LOAD(&counters->shared);
+	if (shared == NULL) {
+		for (shared = VECTOR_COUNTER_LOAD(&vector_core_trace_registry);
+		     shared; shared = shared->next) {
+			if (strcmp(shared->type_name, type_name) == 0) {
+				break;
+			}
+		}
+	}
+	if (shared == NULL) {
+		counters->type_name = type_name;
+		counters->next =
+			VECTOR_COUNTER_LOAD(&vector_core_trace_registry);
+		VECTOR_COUNTER_STORE(&vector_core_trace_registry, counters);
+		shared = counters;
+	}
+	VECTOR_COUNTER_STORE(&counters->shared, shared);
+	vector_core_registry_release();
+	return shared;
+}
+
+void vector_core_trace(VectorCoreTraceCounters *counters, int kind,
+		       const char *type_name, const char *function,
+		       size_t old_capacity, size_t new_capacity, size_t bytes)
+{
+	VectorCoreTraceEvent event;
+
+	counters = vector_core_trace_shared(counters, type_name);
+	if (kind == VECTOR_TRACE_REALLOC) {
+		VECTOR_COUNTER_ADD(&counters->reallocs, 1);
+		VECTOR_COUNTER_ADD(&counters->realloc_bytes, bytes);
+	} else if (kind == VECTOR_TRACE_FREE) {
+		VECTOR_COUNTER_ADD(&counters->frees, 1);
+		VECTOR_COUNTER_ADD(&counters->free_bytes, bytes);
+	} else {
+		VECTOR_COUNTER_ADD(&counters->copies, 1);
+		VECTOR_COUNTER_ADD(&counters->copy_bytes, bytes);
+	}
+
+	if (vector_core_trace_callback == NULL) {
+		return;
+	}
+
+	event.type_name = type_name;
+	event.function = function;
+	event.kind = kind;
+	event.old_capacity = old_capacity;
+	event.new_capacity = new_capacity;
+	event.bytes = bytes;
+	vector_core_trace_callback(&event);
+}
+
+void vector_core_trace_dump(VectorCoreTraceCounters *counters,
+			    const char *type_name, FILE *stream)
+{
+	counters = vector_core_trace_shared(counters, type_name);
+	(void)fprintf(stream,
+		      "%s: %lu reallocs (%lu bytes), %lu frees (%lu bytes), "
+		      "%lu copies (%lu bytes)\n",
+		      type_name,
+		      (unsigned long)VECTOR_COUNTER_LOAD(&counters->reallocs),
+		      (unsigned long)VECTOR_COUNTER_LOAD(
+			      &counters->realloc_bytes),
+		      (unsigned long)VECTOR_COUNTER_LOAD(&counters->frees),
+		      (unsigned long)VECTOR_COUNTER_LOAD(&counters->free_bytes),
+		      (unsigned long)VECTOR_COUNTER_LOAD(&counters->copies),
+		      (unsigned long)VECTOR_COUNTER_LOAD(
+			      &counters->copy_bytes));
+}
+
+VECTOR_COUNTER(VectorCoreAccountStats *) vector_core_account_registry = NULL;
+
+static size_t vector_core_slack_bucket(size_t slack_bytes)
+{
+	size_t bucket = 0;
+
+	while (slack_bytes) {
+		slack_bytes >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+VectorCoreAccountStats *
+vector_core_account_shared(VectorCoreAccountStats *stats)
+{
+	VectorCoreAccountStats *shared = NULL;
+
+	shared = VECTOR_COUNTER_LOAD(&stats->shared);
+	if (VECTOR_LIKELY(shared != NULL)) {
+		return shared;
+	}
+
+	vector_core_registry_acquire();
+	shared = VECTOR_COUNTER_LOAD(&stats->shared);
+	if (shared == NULL) {
+		shared = VECTOR_COUNTER_LOAD(&vector_core_account_registry);
+		for (; shared; shared = shared->next) {
+			if (strcmp(shared->type_name, stats->type_name) == 0) {
+				break;
+			}
+		}
+	}
+	if (shared == NULL) {
+		stats->next =
+			VECTOR_COUNTER_LOAD(&vector_core_account_registry);
+		VECTOR_COUNTER_STORE(&vector_core_account_registry, stats);
+		shared = stats;
+	}
+	VECTOR_COUNTER_STORE(&stats->shared, shared);
+	vector_core_registry_release();
+	return shared;
+}
+
+void vector_core_account(VectorCoreAccountStats *stats, size_t element_size,
+			 size_t old_capacity, size_t old_size,
+			 size_t new_capacity, size_t new_size)
+{
+	size_t bucket = 0;
+
+	stats = vector_core_account_shared(stats);
+
+	/* Subtractions add the unsigned negation */
+	if (old_capacity) {
+		bucket = vector_core_slack_bucket((old_capacity - old_size)
+						  * element_size);
+		VECTOR_COUNTER_ADD(&stats->live, (size_t)-1);
+		VECTOR_COUNTER_ADD(&stats->capacity_bytes,
+				   0 - old_capacity * element_size);
+		VECTOR_COUNTER_ADD(&stats->size_bytes,
+				   0 - old_size * element_size);
+		VECTOR_COUNTER_ADD(&stats->slack[bucket], (size_t)-1);
+	}
+
+	if (new_capacity) {
+		bucket = vector_core_slack_bucket((new_capacity - new_size)
+						  * element_size);
+		VECTOR_COUNTER_ADD(&stats->live, 1);
+		VECTOR_COUNTER_ADD(&stats->capacity_bytes,
+				   new_capacity * element_size);
+		VECTOR_COUNTER_ADD(&stats->size_bytes, new_size * element_size);
+		VECTOR_COUNTER_ADD(&stats->slack[bucket], 1);
+	}
+}
+
+void vector_core_account_print(FILE *stream)
+{
+	VectorCoreAccountStats *stats = NULL;
+	size_t capacity_bytes = 0;
+	size_t size_bytes = 0;
+	size_t count = 0;
+	size_t bucket = 0;
+
+	for (stats = VECTOR_COUNTER_LOAD(&vector_core_account_registry); stats;
+	     stats = stats->next) {
+		capacity_bytes = VECTOR_COUNTER_LOAD(&stats->capacity_bytes);
+		size_bytes = VECTOR_COUNTER_LOAD(&stats->size_bytes);
+		(void)fprintf(stream,
+			      "%s: %lu live, %lu capacity bytes, %lu size bytes, "
+			      "%lu slack bytes\n",
+			      stats->type_name,
+			      (unsigned long)VECTOR_COUNTER_LOAD(&stats->live),
+			      (unsigned long)capacity_bytes,
+			      (unsigned long)size_bytes,
+			      (unsigned long)(capacity_bytes - size_bytes));
+
+		count = VECTOR_COUNTER_LOAD(&stats->slack[0]);
+		if (count) {
+			(void)fprintf(stream, "  no slack: %lu\n",
+				      (unsigned long)count);
+		}
+		for (bucket = 1; bucket < VECTOR_ACCOUNT_BUCKETS; bucket++) {
+			count = VECTOR_COUNTER_LOAD(&stats->slack[bucket]);
+			if (count == 0) {
+				continue;
+			}
+			(void)fprintf(stream, "  slack [%lu, %lu) bytes: %lu\n",
+				      (unsigned long)1 << (bucket - 1),
+				      bucket < sizeof(long) * 8
+					      ? (unsigned long)1 << bucket
+					      : (unsigned long)-1,
+				      (unsigned long)count);
+		}
+	}
+}
+
+unsigned long vector_core_checksum_update(unsigned long hash, const void *data,
+					  size_t size)
+{
+	const unsigned char *byte = (const unsigned char *)data;
+
+	while (size--) {
+		hash ^= *byte++;
+		hash = (hash * 16777619UL) & 0xffffffffUL;
+	}
+	return hash;
+}
+
+unsigned long vector_core_checksum(const void *data, size_t size)
+{
+	return vector_core_checksum_update(VECTOR_CHECKSUM_INIT, data, size);
+}
+
+static int vector_core_store_le(unsigned char *dest, size_t value,
+				size_t bytes)
+{
+	size_t i = 0;
+
+	for (i = 0; i < bytes; i++) {
+		dest[i] = (unsigned char)(value & 0xff);
+		value >>= 8;
+	}
+	return value == 0;
+}
+
+static int vector_core_load_le(const unsigned char *src, size_t bytes,
+			       size_t *value)
+{
+	*value = 0;
+	while (bytes--) {
+		if (*value > ((size_t)-1) >> 8) {
+			return 0;
+		}
+		*value = (*value << 8) | src[bytes];
+	}
+	return 1;
+}
+
+static unsigned char vector_core_byte_order(void)
+{
+	const unsigned int one = 1;
+
+	return *(const unsigned char *)&one ? 'L' : 'B';
+}
+
+int vector_core_serial_header(unsigned char *header, size_t element_size,
+			      size_t count, unsigned long checksum)
+{
+	memset(header, 0, VECTOR_SERIAL_HEADER_SIZE);
+	memcpy(header, "VECTOR", 6);
+	header[6] = VECTOR_SERIAL_VERSION;
+	header[7] = vector_core_byte_order();
+
+	return vector_core_store_le(header + 8, element_size, 4)
+	       && vector_core_store_le(header + 12, (size_t)checksum, 4)
+	       && vector_core_store_le(header + 16, count, 8);
+}
+
+int vector_core_serial_parse(const unsigned char *header, size_t element_size,
+			     size_t *count, unsigned long *checksum)
+{
+	size_t stored_size = 0;
+	size_t stored_checksum = 0;
+	size_t i = 0;
+
+	if (memcmp(header, "VECTOR", 6) != 0
+	    || header[6] != VECTOR_SERIAL_VERSION
+	    || header[7] != vector_core_byte_order()) {
+		return 0;
+	}
+	for (i = 24; i < VECTOR_SERIAL_HEADER_SIZE; i++) {
+		if (header[i]) {
+			return 0;
+		}
+	}
+
+	if (!vector_core_load_le(header + 8, 4, &stored_size)
+	    || stored_size != element_size
+	    || !vector_core_load_le(header + 12, 4, &stored_checksum)
+	    || !vector_core_load_le(header + 16, 8, count)
+	    || *count > ((size_t)-1) / element_size) {
+		return 0;
+	}
+	*checksum = (unsigned long)stored_checksum;
+	return 1;
+}
+
+int vector_core_spill_init(VectorCoreSpill *spill, size_t element_size,
+			   size_t budget_bytes)
+{
+	size_t block_bytes = 0;
+	size_t slot = 0;
+
+	memset(spill, 0, sizeof(*spill));
+	spill->element_size = element_size;
+	spill->block_elements = VECTOR_SPILL_BLOCK_BYTES / element_size;
+	if (spill->block_elements == 0) {
+		spill->block_elements = 1;
+	}
+	block_bytes = spill->block_elements * element_size;
+	/* One block being filled or scanned, and one to read ahead into */
+	spill->slot_count = budget_bytes / block_bytes;
+	if (spill->slot_count < 2) {
+		spill->slot_count = 2;
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_core_panic("Allocation inside a no-alloc region.");
+	}
+
+	spill->slots = (unsigned char *)VECTOR_REALLOC(
+		NULL, spill->slot_count * block_bytes);
+	spill->slot_block = (size_t *)VECTOR_REALLOC(
+		NULL, spill->slot_count * sizeof(size_t));
+	spill->slot_used = (unsigned long *)VECTOR_REALLOC(
+		NULL, spill->slot_count * sizeof(unsigned long));
+	spill->slot_dirty = (unsigned char *)VECTOR_REALLOC(
+		NULL, spill->slot_count);
+	if (spill->slots == NULL || spill->slot_block == NULL
+	    || spill->slot_used == NULL || spill->slot_dirty == NULL) {
+		vector_core_spill_free(spill);
+		return 0;
+	}
+
+	for (slot = 0; slot < spill->slot_count; slot++) {
+		spill->slot_block[slot] = (size_t)-1;
+		spill->slot_used[slot] = 0;
+		spill->slot_dirty[slot] = 0;
+	}
+	spill->last_miss = (size_t)-1;
+	return 1;
+}
+
+void vector_core_spill_free(VectorCoreSpill *spill)
+{
+	if (spill->file) {
+		(void)fclose(spill->file);
+	}
+	VECTOR_FREE(spill->slots);
+	VECTOR_FREE(spill->slot_block);
+	VECTOR_FREE(spill->slot_used);
+	VECTOR_FREE(spill->slot_dirty);
+	memset(spill, 0, sizeof(*spill));
+}
+
+/* Seek to offset from the start of file, failing if VECTOR_OFFSET cannot
+ * hold it */
+static int vector_core_seek(FILE *file, size_t offset)
+{
+	VECTOR_OFFSET position = (VECTOR_OFFSET)offset;
+
+	if (position < 0 || (size_t)position != offset) {
+		return 0;
+	}
+	return VECTOR_FSEEK(file, position) == 0;
+}
+
+static int vector_core_spill_seek(VectorCoreSpill *spill, size_t block)
+{
+	size_t block_bytes = spill->block_elements * spill->element_size;
+
+	if (block > ((size_t)-1) / block_bytes) {
+		return 0;
+	}
+	return vector_core_seek(spill->file, block * block_bytes);
+}
+
+/* Load block into the least recently used slot, writing back the block it
+ * held if dirty. Blocks never written to the file start zeroed. Returns
+ * slot_count on I/O failure */
+static size_t vector_core_spill_load(VectorCoreSpill *spill, size_t block)
+{
+	size_t block_bytes = spill->block_elements * spill->element_size;
+	size_t victim = 0;
+	size_t slot = 0;
+	unsigned char *data = NULL;
+
+	for (slot = 1; slot < spill->slot_count; slot++) {
+		if (spill->slot_used[slot] < spill->slot_used[victim]) {
+			victim = slot;
+		}
+	}
+	data = spill->slots + victim * block_bytes;
+
+	if (spill->slot_dirty[victim]) {
+		if (spill->file == NULL) {
+			spill->file = tmpfile();
+		}
+		if (spill->file == NULL
+		    || !vector_core_spill_seek(spill, spill->slot_block[victim])
+		    || fwrite(data, 1, block_bytes, spill->file)
+			       != block_bytes) {
+			return spill->slot_count;
+		}
+		if (spill->slot_block[victim] >= spill->disk_blocks) {
+			spill->disk_blocks = spill->slot_block[victim] + 1;
+		}
+		spill->slot_dirty[victim] = 0;
+	}
+
+	spill->slot_block[victim] = (size_t)-1;
+	if (block < spill->disk_blocks) {
+		if (!vector_core_spill_seek(spill, block)
+		    || fread(data, 1, block_bytes, spill->file)
+			       != block_bytes) {
+			return spill->slot_count;
+		}
+	} else {
+		memset(data, 0, block_bytes);
+		spill->slot_dirty[victim] = 1;
+	}
+
+	spill->slot_block[victim] = block;
+	spill->slot_used[victim] = ++spill->clock;
+	return victim;
+}
+
+static int vector_core_spill_is_resident(const VectorCoreSpill *spill,
+					 size_t block)
+{
+	size_t slot = 0;
+
+	for (slot = 0; slot < spill->slot_count; slot++) {
+		if (spill->slot_block[slot] == block) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Load up to half of the slots with the blocks following block, and return
+ * the last block loaded */
+static size_t vector_core_spill_read_ahead(VectorCoreSpill *spill,
+					   size_t block)
+{
+	size_t last = block;
+
+	while (last + 1 < spill->disk_blocks
+	       && last + 1 - block <= spill->slot_count / 2) {
+		if (!vector_core_spill_is_resident(spill, last + 1)
+		    && vector_core_spill_load(spill, last + 1)
+			       == spill->slot_count) {
+			break;
+		}
+		last++;
+	}
+	return last;
+}
+
+unsigned char *vector_core_spill_at(VectorCoreSpill *spill, size_t idx,
+				    int dirty)
+{
+	size_t block_bytes = spill->block_elements * spill->element_size;
+	size_t block = idx / spill->block_elements;
+	size_t slot = spill->last_slot;
+
+	if (spill->slot_block[slot] != block) {
+		for (slot = 0; slot < spill->slot_count; slot++) {
+			if (spill->slot_block[slot] == block) {
+				break;
+			}
+		}
+
+		if (slot == spill->slot_count) {
+			slot = vector_core_spill_load(spill, block);
+			if (slot == spill->slot_count) {
+				return NULL;
+			}
+
+			/* A sequential scan reads the following blocks in the
+			 * same pass over the file */
+			if (block == spill->last_miss + 1) {
+				spill->last_miss = vector_core_spill_read_ahead(
+					spill, block);
+			} else {
+				spill->last_miss = block;
+			}
+		}
+
+		spill->last_slot = slot;
+		spill->slot_used[slot] = ++spill->clock;
+	}
+
+	spill->slot_dirty[slot] |= (unsigned char)dirty;
+	return spill->slots + slot * block_bytes
+	       + (idx % spill->block_elements) * spill->element_size;
+}
+
+int vector_core_run_refill(FILE *file, VectorCoreRun *run, void *buffer,
+			   size_t buffer_elements, size_t element_size)
+{
+	size_t count = run->end - run->next;
+
+	if (count > buffer_elements) {
+		count = buffer_elements;
+	}
+	run->pos = 0;
+	run->len = count;
+	if (count == 0) {
+		return 1;
+	}
+
+	if (run->next > ((size_t)-1) / element_size
+	    || !vector_core_seek(file, run->next * element_size)
+	    || fread(buffer, element_size, count, file) != count) {
+		run->len = 0;
+		return 0;
+	}
+	run->next += count;
+	return 1;
+}
+
+char *vector_core_temp_path(const char *path)
+{
+	size_t length = strlen(path);
+	char *temp_path = NULL;
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_core_panic("Allocation inside a no-alloc region.");
+	}
+
+	temp_path = (char *)VECTOR_REALLOC(
+		NULL, length + sizeof(VECTOR_SORT_TEMP_SUFFIX));
+	if (temp_path == NULL) {
+		return NULL;
+	}
+	memcpy(temp_path, path, length);
+	memcpy(temp_path + length, VECTOR_SORT_TEMP_SUFFIX,
+	       sizeof(VECTOR_SORT_TEMP_SUFFIX));
+	return temp_path;
+}
+
+int vector_core_replace(const char *temp_path, const char *path)
+{
+	if (rename(temp_path, path) == 0) {
+		return 1;
+	}
+	/* Windows does not rename over an existing file. The data is complete
+	 * in temp_path by now, so only the old file is lost if this fails */
+	return remove(path) == 0 && rename(temp_path, path) == 0;
+}
+
+size_t vector_core_concurrent_locate(size_t idx, size_t *offset)
+{
+	size_t blocks = idx / VECTOR_CONCURRENT_FIRST_SEGMENT + 1;
+	size_t segment = 0;
+	size_t shift = 0;
+
+	/* floor(log2(blocks)), halving the shift at each step */
+	for (shift = sizeof(size_t) * 4; shift; shift /= 2) {
+		if (blocks >> shift) {
+			blocks >>= shift;
+			segment += shift;
+		}
+	}
+
+	*offset = idx
+		  - (((size_t)1 << segment) - 1)
+			    * VECTOR_CONCURRENT_FIRST_SEGMENT;
+	return segment;
+}
+
+/* Power of two of at least capacity and 2, or 0 on overflow */
+size_t vector_core_ring_capacity(size_t capacity)
+{
+	size_t ring = 2;
+
+	while (ring < capacity) {
+		if (ring > ((size_t)-1) / 2) {
+			return 0;
+		}
+		ring *= 2;
+	}
+	return ring;
+}
+
+int vector_core_simd_level = 2;
+
+size_t vector_core_find_scalar(const void *begin, size_t size,
+			       const void *value, size_t element_size)
+{
+	const unsigned char *i = (const unsigned char *)begin;
+	size_t idx = 0;
+
+	/* Constant sizes turn memcmp(3) into a single integer compare */
+	if (element_size == 4) {
+		for (; idx < size; idx++, i += 4) {
+			if (memcmp(i, value, 4) == 0) {
+				return idx;
+			}
+		}
+	} else {
+		for (; idx < size; idx++, i += 8) {
+			if (memcmp(i, value, 8) == 0) {
+				return idx;
+			}
+		}
+	}
+	return VECTOR_NOT_FOUND;
+}
+
+size_t vector_core_count_scalar(const void *begin, size_t size,
+				const void *value, size_t element_size)
+{
+	const unsigned char *i = (const unsigned char *)begin;
+	const unsigned char *end = i + size * element_size;
+	size_t count = 0;
+
+	if (element_size == 4) {
+		for (; i < end; i += 4) {
+			count += memcmp(i, value, 4) == 0;
+		}
+	} else {
+		for (; i < end; i += 8) {
+			count += memcmp(i, value, 8) == 0;
+		}
+	}
+	return count;
+}
+
+/* Floating point values equal to elements with other bits: returns 0 for NaN,
+ * equal to none, 2 for zeros, setting other to the zero of the other sign, 1
+ * otherwise, including integers */
+static int vector_core_float_keys(int kind, const void *value, void *other)
+{
+	float single = 0;
+	double twice = 0;
+
+	if (kind == VECTOR_F32) {
+		memcpy(&single, value, sizeof(single));
+		if (single != single) {
+			return 0;
+		}
+		if (single != 0) {
+			return 1;
+		}
+		single = -single;
+		memcpy(other, &single, sizeof(single));
+		return 2;
+	}
+	if (kind == VECTOR_F64) {
+		memcpy(&twice, value, sizeof(twice));
+		if (twice != twice) {
+			return 0;
+		}
+		if (twice != 0) {
+			return 1;
+		}
+		twice = -twice;
+		memcpy(other, &twice, sizeof(twice));
+		return 2;
+	}
+	return 1;
+}
+
+size_t vector_core_find(int kind, const void *begin, size_t size,
+			const void *value)
+{
+	size_t element_size = VECTOR_KIND_SIZE(kind);
+	unsigned char other[8];
+	size_t found = 0;
+	size_t other_found = 0;
+
+	if (size == 0) {
+		return VECTOR_NOT_FOUND;
+	}
+	switch (vector_core_float_keys(kind, value, other)) {
+	case 0:
+		return VECTOR_NOT_FOUND;
+	case 2:
+		/* Only the elements before the first match of value can
+		 * match other first */
+		found = vector_core_find_bits(begin, size, value, element_size);
+		other_found = vector_core_find_bits(
+			begin, found == VECTOR_NOT_FOUND ? size : found, other,
+			element_size);
+		return other_found == VECTOR_NOT_FOUND ? found : other_found;
+	default:
+		return vector_core_find_bits(begin, size, value, element_size);
+	}
+}
+
+size_t vector_core_count(int kind, const void *begin, size_t size,
+			 const void *value)
+{
+	size_t element_size = VECTOR_KIND_SIZE(kind);
+	unsigned char other[8];
+
+	if (size == 0) {
+		return 0;
+	}
+	switch (vector_core_float_keys(kind, value, other)) {
+	case 0:
+		return 0;
+	case 2:
+		return vector_core_count_bits(begin, size, value,
+					      element_size)
+		       + vector_core_count_bits(begin, size, other,
+						element_size);
+	default:
+		return vector_core_count_bits(begin, size, value,
+					      element_size);
+	}
+}
+
+int vector_core_is_nan(int kind, const void *value)
+{
+	float single = 0;
+	double twice = 0;
+
+	if (kind == VECTOR_F32) {
+		memcpy(&single, value, sizeof(single));
+		return single != single;
+	}
+	if (kind == VECTOR_F64) {
+		memcpy(&twice, value, sizeof(twice));
+		return twice != twice;
+	}
+	return 0;
+}
+
+void vector_core_sum(int kind, const void *a, const void *b, size_t size,
+		     void *result)
+{
+	float single = 0;
+	double twice = 0;
+
+	if (kind == VECTOR_F32) {
+		single = vector_core_sum_f32((const float *)a,
+					     (const float *)b, size);
+		memcpy(result, &single, sizeof(single));
+	} else {
+		twice = vector_core_sum_f64((const double *)a,
+					    (const double *)b, size);
+		memcpy(result, &twice, sizeof(twice));
+	}
+}
+
+/* The elements past the last full round of lanes, added in order to the
+ * folded lanes */
+float vector_core_sum_f32_tail(float sum, const float *a, const float *b,
+			       size_t count)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < count; idx++) {
+		sum += b ? a[idx] * b[idx] : a[idx];
+	}
+	return sum;
+}
+
+double vector_core_sum_f64_tail(double sum, const double *a, const double *b,
+				size_t count)
+{
+	size_t idx = 0;
+
+	for (idx = 0; idx < count; idx++) {
+		sum += b ? a[idx] * b[idx] : a[idx];
+	}
+	return sum;
+}
+
+float vector_core_sum_f32_scalar(const float *a, const float *b, size_t size)
+{
+	float lanes[VECTOR_REDUCE_LANES];
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+	size_t lane = 0;
+	size_t width = 0;
+
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[lane] = 0;
+	}
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane] * b[lane];
+			}
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane];
+			}
+		}
+	}
+	/* Halving folds, lane j adding lane j + width, as SIMD registers do */
+	for (width = VECTOR_REDUCE_LANES / 2; width > 0; width /= 2) {
+		for (lane = 0; lane < width; lane++) {
+			lanes[lane] += lanes[lane + width];
+		}
+	}
+	return vector_core_sum_f32_tail(lanes[0], a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+
+double vector_core_sum_f64_scalar(const double *a, const double *b,
+				  size_t size)
+{
+	double lanes[VECTOR_REDUCE_LANES];
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+	size_t lane = 0;
+	size_t width = 0;
+
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[lane] = 0;
+	}
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane] * b[lane];
+			}
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane];
+			}
+		}
+	}
+	for (width = VECTOR_REDUCE_LANES / 2; width > 0; width /= 2) {
+		for (lane = 0; lane < width; lane++) {
+			lanes[lane] += lanes[lane + width];
+		}
+	}
+	return vector_core_sum_f64_tail(lanes[0], a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+/* Macro VECTOR_DEFINE_SHARED_CORE_BASE stop here */
+
+#if VECTOR_MMAP
+/* Macro VECTOR_DEFINE_SHARED_MMAP() start here */
+const void *vector_core_map(const char *path, size_t *size)
+{
+	struct stat file_stat;
+	void *mapping = NULL;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0
+	    || (unsigned long)file_stat.st_size > (size_t)-1) {
+		(void)close(fd);
+		return NULL;
+	}
+
+	*size = (size_t)file_stat.st_size;
+	mapping = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+	/* The mapping keeps its own reference to the file */
+	(void)close(fd);
+
+	return mapping == MAP_FAILED ? NULL : mapping;
+}
+
+void vector_core_unmap(const void *mapping, size_t size)
+{
+	(void)munmap((void *)mapping, size);
+}
+
+unsigned char *vector_core_file_open(const char *path, size_t element_size,
+				     int *fd, size_t *count, size_t *capacity)
+{
+	struct stat file_stat;
+	unsigned char *mapping = NULL;
+	size_t bytes = 0;
+	unsigned long checksum = 0;
+
+	*fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (*fd < 0) {
+		return NULL;
+	}
+	if (fstat(*fd, &file_stat) != 0
+	    || (unsigned long)file_stat.st_size > (size_t)-1) {
+		(void)close(*fd);
+		return NULL;
+	}
+
+	bytes = (size_t)file_stat.st_size;
+	if (bytes == 0) {
+		bytes = VECTOR_SERIAL_HEADER_SIZE;
+		if (ftruncate(*fd, (off_t)bytes) != 0) {
+			(void)close(*fd);
+			return NULL;
+		}
+	}
+
+	mapping = (unsigned char *)mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+					MAP_SHARED, *fd, 0);
+	if (mapping == MAP_FAILED) {
+		(void)close(*fd);
+		return NULL;
+	}
+
+	if (file_stat.st_size == 0) {
+		(void)vector_core_serial_header(mapping, element_size, 0,
+						VECTOR_CHECKSUM_INIT);
+	}
+
+	if (bytes < VECTOR_SERIAL_HEADER_SIZE
+	    || !vector_core_serial_parse(mapping, element_size, count,
+					 &checksum)
+	    || *count > (bytes - VECTOR_SERIAL_HEADER_SIZE) / element_size) {
+		(void)munmap(mapping, bytes);
+		(void)close(*fd);
+		return NULL;
+	}
+	*capacity = (bytes - VECTOR_SERIAL_HEADER_SIZE) / element_size;
+	return mapping;
+}
+
+unsigned char *vector_core_file_resize(int fd, unsigned char *mapping,
+				       size_t old_bytes, size_t new_bytes)
+{
+	void *new_mapping = NULL;
+
+	if (ftruncate(fd, (off_t)new_bytes) != 0) {
+		return NULL;
+	}
+
+	new_mapping = VECTOR_REMAP(fd, mapping, old_bytes, new_bytes);
+	return new_mapping == MAP_FAILED ? NULL : (unsigned char *)new_mapping;
+}
+
+int vector_core_file_sync(unsigned char *mapping, size_t bytes,
+			  size_t element_size, size_t count, int checksum)
+{
+	size_t stored_count = 0;
+	unsigned long stored_checksum = 0;
+
+	if (!vector_core_serial_parse(mapping, element_size, &stored_count,
+				      &stored_checksum)) {
+		return 0;
+	}
+	if (checksum) {
+		stored_checksum = vector_core_checksum(
+			mapping + VECTOR_SERIAL_HEADER_SIZE,
+			count * element_size);
+	}
+
+	return vector_core_serial_header(mapping, element_size, count,
+					 stored_checksum)
+	       && msync(mapping, bytes, MS_SYNC) == 0;
+}
+
+int vector_core_file_close(int fd, unsigned char *mapping, size_t bytes)
+{
+	int unmapped = munmap(mapping, bytes) == 0;
+
+	return close(fd) == 0 && unmapped;
+}
+/* Macro VECTOR_DEFINE_SHARED_MMAP stop here */
+#else
+/* Macro VECTOR_DEFINE_SHARED_MMAP() start here */
+const void *vector_core_map(const char *path, size_t *size)
+{
+	(void)path;
+	(void)size;
+	return NULL;
+}
+
+void vector_core_unmap(const void *mapping, size_t size)
+{
+	(void)mapping;
+	(void)size;
+}
+
+unsigned char *vector_core_file_open(const char *path, size_t element_size,
+				     int *fd, size_t *count, size_t *capacity)
+{
+	(void)path;
+	(void)element_size;
+	*fd = -1;
+	*count = 0;
+	*capacity = 0;
+	return NULL;
+}
+
+unsigned char *vector_core_file_resize(int fd, unsigned char *mapping,
+				       size_t old_bytes, size_t new_bytes)
+{
+	(void)fd;
+	(void)mapping;
+	(void)old_bytes;
+	(void)new_bytes;
+	return NULL;
+}
+
+int vector_core_file_sync(unsigned char *mapping, size_t bytes,
+			  size_t element_size, size_t count, int checksum)
+{
+	(void)mapping;
+	(void)bytes;
+	(void)element_size;
+	(void)count;
+	(void)checksum;
+	return 0;
+}
+
+int vector_core_file_close(int fd, unsigned char *mapping, size_t bytes)
+{
+	(void)fd;
+	(void)mapping;
+	(void)bytes;
+	return 0;
+}
+/* Macro VECTOR_DEFINE_SHARED_MMAP stop here */
+#endif
+
+#if VECTOR_PARALLEL
+/* Macro VECTOR_DEFINE_SHARED_PARALLEL() start here */
+/* The chunks [next, end) a thread runs first, alone on its cache line. Once
+ * they are done, the thread steals from the others through the same counter,
+ * so every chunk is claimed exactly once */
+typedef struct VectorCoreParallelWorker {
+	VECTOR_ATOMIC(size_t) next;
+	size_t end;
+	char padding[VECTOR_CACHE_LINE - 2 * sizeof(size_t)];
+} VectorCoreParallelWorker;
+
+/* One job at a time: job_lock serializes the callers, lock guards the rest */
+static pthread_mutex_t vector_core_pool_job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t vector_core_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vector_core_pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t vector_core_pool_done = PTHREAD_COND_INITIALIZER;
+static pthread_t *vector_core_pool_threads = NULL;
+static size_t vector_core_pool_size = 0;
+static size_t vector_core_pool_wanted = 0;
+static unsigned long vector_core_pool_generation = 0;
+static size_t vector_core_pool_running = 0;
+static int vector_core_pool_stopping = 0;
+static VectorCoreParallelWorker *vector_core_pool_workers = NULL;
+static VectorCoreParallelTask vector_core_pool_task = NULL;
+static void *vector_core_pool_context = NULL;
+static size_t vector_core_pool_count = 0;
+static size_t vector_core_pool_grain = 0;
+/* Set in pool threads and during a job, where nested loops run serially */
+static VECTOR_THREAD_LOCAL int vector_core_pool_inside = 0;
+
+static void vector_core_pool_work(size_t self)
+{
+	VectorCoreParallelWorker *worker = NULL;
+	size_t workers = vector_core_pool_size + 1;
+	size_t victim = 0;
+	size_t chunk = 0;
+	size_t end = 0;
+
+	for (victim = 0; victim < workers; victim++) {
+		worker = &vector_core_pool_workers[(self + victim) % workers];
+		for (;;) {
+			chunk = VECTOR_ATOMIC_FETCH_ADD(&worker->next, 1);
+			if (chunk >= worker->end) {
+				break;
+			}
+			end = chunk * vector_core_pool_grain
+			      + vector_core_pool_grain;
+			if (end > vector_core_pool_count) {
+				end = vector_core_pool_count;
+			}
+			vector_core_pool_task(vector_core_pool_context, chunk,
+					      chunk * vector_core_pool_grain,
+					      end);
+		}
+	}
+}
+
+/* Threads start at generation 0: none can be running when it is reset */
+static void *vector_core_pool_main(void *arg)
+{
+	size_t self = (size_t)((VectorCoreParallelWorker *)arg
+			       - vector_core_pool_workers);
+	unsigned long generation = 0;
+
+	vector_core_pool_inside = 1;
+	(void)pthread_mutex_lock(&vector_core_pool_lock);
+	for (;;) {
+		while (generation == vector_core_pool_generation
+		       && !vector_core_pool_stopping) {
+			(void)pthread_cond_wait(&vector_core_pool_wake,
+						&vector_core_pool_lock);
+		}
+		if (vector_core_pool_stopping) {
+			break;
+		}
+		generation = vector_core_pool_generation;
+		(void)pthread_mutex_unlock(&vector_core_pool_lock);
+
+		vector_core_pool_work(self);
+
+		(void)pthread_mutex_lock(&vector_core_pool_lock);
+		if (--vector_core_pool_running == 0) {
+			(void)pthread_cond_signal(&vector_core_pool_done);
+		}
+	}
+	(void)pthread_mutex_unlock(&vector_core_pool_lock);
+	return NULL;
+}
+
+/* Called with job_lock held */
+static void vector_core_pool_stop(void)
+{
+	size_t thread = 0;
+
+	(void)pthread_mutex_lock(&vector_core_pool_lock);
+	vector_core_pool_stopping = 1;
+	(void)pthread_cond_broadcast(&vector_core_pool_wake);
+	(void)pthread_mutex_unlock(&vector_core_pool_lock);
+	for (thread = 0; thread < vector_core_pool_size; thread++) {
+		(void)pthread_join(vector_core_pool_threads[thread], NULL);
+	}
+
+	free(vector_core_pool_threads);
+	free(vector_core_pool_workers);
+	vector_core_pool_threads = NULL;
+	vector_core_pool_workers = NULL;
+	vector_core_pool_size = 0;
+	vector_core_pool_generation = 0;
+	vector_core_pool_stopping = 0;
+}
+
+/* Called with job_lock held. Starts as many threads as possible up to
+ * threads - 1, the caller being the last worker */
+static void vector_core_pool_start(size_t threads)
+{
+	vector_core_pool_workers = (VectorCoreParallelWorker *)calloc(
+		threads, sizeof(VectorCoreParallelWorker));
+	vector_core_pool_threads =
+		(pthread_t *)calloc(threads, sizeof(pthread_t));
+	if (vector_core_pool_workers == NULL
+	    || vector_core_pool_threads == NULL) {
+		vector_core_pool_stop();
+		return;
+	}
+
+	while (vector_core_pool_size + 1 < threads
+	       && pthread_create(
+			  &vector_core_pool_threads[vector_core_pool_size],
+			  NULL, vector_core_pool_main,
+			  &vector_core_pool_workers[vector_core_pool_size + 1])
+			  == 0) {
+		vector_core_pool_size++;
+	}
+}
+
+static void vector_core_pool_serial(size_t count, size_t grain,
+				    VectorCoreParallelTask task, void *context)
+{
+	size_t chunk = 0;
+	size_t begin = 0;
+
+	for (chunk = 0, begin = 0; begin < count; chunk++, begin += grain) {
+		task(context, chunk, begin,
+		     count - begin > grain ? begin + grain : count);
+	}
+}
+
+void vector_core_parallel_run(size_t count, size_t grain,
+			      VectorCoreParallelTask task, void *context)
+{
+	size_t chunks = 0;
+	size_t threads = 0;
+	size_t worker = 0;
+
+	if (grain == 0) {
+		grain = 1;
+	}
+	if (count <= grain || vector_core_pool_inside) {
+		vector_core_pool_serial(count, grain, task, context);
+		return;
+	}
+
+	(void)pthread_mutex_lock(&vector_core_pool_job_lock);
+	threads = vector_core_parallel_threads();
+	if (vector_core_pool_workers == NULL
+	    || vector_core_pool_size + 1 != threads) {
+		vector_core_pool_stop();
+		vector_core_pool_start(threads);
+	}
+	if (vector_core_pool_size == 0) {
+		(void)pthread_mutex_unlock(&vector_core_pool_job_lock);
+		vector_core_pool_serial(count, grain, task, context);
+		return;
+	}
+
+	/* Contiguous ranges of chunks keep neighbouring chunks on one thread
+	 * until it starts stealing */
+	chunks = (count - 1) / grain + 1;
+	threads = vector_core_pool_size + 1;
+	for (worker = 0; worker < threads; worker++) {
+		VECTOR_ATOMIC_STORE(&vector_core_pool_workers[worker].next,
+				    chunks * worker / threads);
+		vector_core_pool_workers[worker].end =
+			chunks * (worker + 1) / threads;
+	}
+	vector_core_pool_task = task;
+	vector_core_pool_context = context;
+	vector_core_pool_count = count;
+	vector_core_pool_grain = grain;
+
+	(void)pthread_mutex_lock(&vector_core_pool_lock);
+	vector_core_pool_running = vector_core_pool_size;
+	vector_core_pool_generation++;
+	(void)pthread_cond_broadcast(&vector_core_pool_wake);
+	(void)pthread_mutex_unlock(&vector_core_pool_lock);
+
+	vector_core_pool_inside = 1;
+	vector_core_pool_work(0);
+	vector_core_pool_inside = 0;
+
+	(void)pthread_mutex_lock(&vector_core_pool_lock);
+	while (vector_core_pool_running != 0) {
+		(void)pthread_cond_wait(&vector_core_pool_done,
+					&vector_core_pool_lock);
+	}
+	(void)pthread_mutex_unlock(&vector_core_pool_lock);
+	(void)pthread_mutex_unlock(&vector_core_pool_job_lock);
+}
+
+size_t vector_core_parallel_threads(void)
+{
+	long online = 1;
+
+	if (vector_core_pool_wanted != 0) {
+		return vector_core_pool_wanted;
+	}
+	online = VECTOR_ONLINE_CPUS();
+	return online > 1 ? (size_t)online : 1;
+}
+
+void vector_core_parallel_set_threads(size_t threads)
+{
+	(void)pthread_mutex_lock(&vector_core_pool_job_lock);
+	vector_core_pool_wanted = threads;
+	(void)pthread_mutex_unlock(&vector_core_pool_job_lock);
+}
+
+void vector_core_parallel_shutdown(void)
+{
+	(void)pthread_mutex_lock(&vector_core_pool_job_lock);
+	vector_core_pool_stop();
+	(void)pthread_mutex_unlock(&vector_core_pool_job_lock);
+}
+/* Macro VECTOR_DEFINE_SHARED_PARALLEL stop here */
+#else
+/* Macro VECTOR_DEFINE_SHARED_PARALLEL() start here */
+void vector_core_parallel_run(size_t count, size_t grain,
+			      VectorCoreParallelTask task, void *context)
+{
+	size_t chunk = 0;
+	size_t begin = 0;
+
+	if (grain == 0) {
+		grain = 1;
+	}
+	for (chunk = 0, begin = 0; begin < count; chunk++, begin += grain) {
+		task(context, chunk, begin,
+		     count - begin > grain ? begin + grain : count);
+	}
+}
+
+size_t vector_core_parallel_threads(void)
+{
+	return 1;
+}
+
+void vector_core_parallel_set_threads(size_t threads)
+{
+	(void)threads;
+}
+
+void vector_core_parallel_shutdown(void)
+{
+}
+/* Macro VECTOR_DEFINE_SHARED_PARALLEL stop here */
+#endif
+
+#if VECTOR_STREAM
+/* Macro VECTOR_DEFINE_SHARED_STREAM() start here */
+void vector_core_stream_copy(void *dest, const void *src, size_t bytes)
+{
+	unsigned char *out = (unsigned char *)dest;
+	const unsigned char *in = (const unsigned char *)src;
+	size_t head = (16 - (size_t)out % 16) % 16;
+
+	if (bytes < head + 64) {
+		memcpy(dest, src, bytes);
+		return;
+	}
+
+	/* Streaming stores need 16 bytes aligned destinations */
+	memcpy(out, in, head);
+	out += head;
+	in += head;
+	bytes -= head;
+	for (; bytes >= 64; bytes -= 64, out += 64, in += 64) {
+		_mm_stream_si128((__m128i *)out,
+				 _mm_loadu_si128((const __m128i *)in));
+		_mm_stream_si128((__m128i *)(out + 16),
+				 _mm_loadu_si128((const __m128i *)(in + 16)));
+		_mm_stream_si128((__m128i *)(out + 32),
+				 _mm_loadu_si128((const __m128i *)(in + 32)));
+		_mm_stream_si128((__m128i *)(out + 48),
+				 _mm_loadu_si128((const __m128i *)(in + 48)));
+	}
+	_mm_sfence();
+	memcpy(out, in, bytes);
+}
+/* Macro VECTOR_DEFINE_SHARED_STREAM stop here */
+#else
+/* Macro VECTOR_DEFINE_SHARED_STREAM() start here */
+void vector_core_stream_copy(void *dest, const void *src, size_t bytes)
+{
+	memcpy(dest, src, bytes);
+}
+/* Macro VECTOR_DEFINE_SHARED_STREAM stop here */
+#endif
+
+#if VECTOR_SIMD == 1
+/* Macro VECTOR_DEFINE_SHARED_SIMD() start here */
+static __m128i vector_core_key_sse2(const void *value, size_t element_size)
+{
+	int bits = 0;
+	__m128i key;
+
+	if (element_size == 4) {
+		memcpy(&bits, value, sizeof(bits));
+		return _mm_set1_epi32(bits);
+	}
+	key = _mm_loadl_epi64((const __m128i *)value);
+	return _mm_unpacklo_epi64(key, key);
+}
+
+/* Lanes of 4 or 8 bytes at at equal to key, all ones or all zeros. SSE2 has
+ * no 64 bits compare, both halves must be equal */
+static __m128i vector_core_equal_sse2(const unsigned char *at, __m128i key,
+				      size_t element_size)
+{
+	__m128i equal =
+		_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)at), key);
+
+	if (element_size == 4) {
+		return equal;
+	}
+	return _mm_and_si128(equal, _mm_shuffle_epi32(equal, 0xb1));
+}
+
+static size_t vector_core_find_sse2(const unsigned char *begin, size_t size,
+				    const void *value, size_t element_size)
+{
+	__m128i key = vector_core_key_sse2(value, element_size);
+	__m128i equal;
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t found = 0;
+	int mask = 0;
+
+	/* 64 bytes per iteration until a match, located 16 bytes at a time */
+	for (; offset + 64 <= bytes; offset += 64) {
+		equal = _mm_or_si128(
+			_mm_or_si128(
+				vector_core_equal_sse2(begin + offset, key,
+						       element_size),
+				vector_core_equal_sse2(begin + offset + 16,
+						       key, element_size)),
+			_mm_or_si128(
+				vector_core_equal_sse2(begin + offset + 32,
+						       key, element_size),
+				vector_core_equal_sse2(begin + offset + 48,
+						       key, element_size)));
+		if (_mm_movemask_epi8(equal) != 0) {
+			break;
+		}
+	}
+	for (; offset + 16 <= bytes; offset += 16) {
+		mask = _mm_movemask_epi8(
+			vector_core_equal_sse2(begin + offset, key,
+					       element_size));
+		if (mask != 0) {
+			return (offset + (size_t)__builtin_ctz((unsigned)mask))
+			       / element_size;
+		}
+	}
+	found = vector_core_find_scalar(begin + offset,
+					(bytes - offset) / element_size, value,
+					element_size);
+	return found == VECTOR_NOT_FOUND ? found
+					 : offset / element_size + found;
+}
+
+/* Every match subtracts -1 from its lanes of 4 bytes, two of them for
+ * elements of 8 bytes. Lanes are added up every block of 2^30 bytes, before
+ * they could overflow */
+static size_t vector_core_count_sse2(const unsigned char *begin, size_t size,
+				     const void *value, size_t element_size)
+{
+	__m128i key = vector_core_key_sse2(value, element_size);
+	__m128i counts;
+	unsigned int lanes[4];
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t block_end = 0;
+	size_t count = 0;
+
+	while (offset + 16 <= bytes) {
+		counts = _mm_setzero_si128();
+		block_end = bytes - offset > ((size_t)1 << 30)
+				    ? offset + ((size_t)1 << 30)
+				    : bytes;
+		for (; offset + 16 <= block_end; offset += 16) {
+			counts = _mm_sub_epi32(
+				counts, vector_core_equal_sse2(begin + offset,
+							       key,
+							       element_size));
+		}
+		_mm_storeu_si128((__m128i *)lanes, counts);
+		count += ((size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3])
+			 / (element_size / 4);
+	}
+	return count
+	       + vector_core_count_scalar(begin + offset,
+					  (bytes - offset) / element_size,
+					  value, element_size);
+}
+
+static VECTOR_TARGET_AVX2 __m256i vector_core_key_avx2(const void *value,
+						       size_t element_size)
+{
+	int bits = 0;
+
+	if (element_size == 4) {
+		memcpy(&bits, value, sizeof(bits));
+		return _mm256_set1_epi32(bits);
+	}
+	return _mm256_broadcastq_epi64(
+		_mm_loadl_epi64((const __m128i *)value));
+}
+
+static VECTOR_TARGET_AVX2 __m256i vector_core_equal_avx2(
+	const unsigned char *at, __m256i key, size_t element_size)
+{
+	__m256i lanes = _mm256_loadu_si256((const __m256i *)at);
+
+	if (element_size == 4) {
+		return _mm256_cmpeq_epi32(lanes, key);
+	}
+	return _mm256_cmpeq_epi64(lanes, key);
+}
+
+/* Same as the SSE2 kernels, twice as wide, the last 32 bytes left to them */
+static VECTOR_TARGET_AVX2 size_t vector_core_find_avx2(
+	const unsigned char *begin, size_t size, const void *value,
+	size_t element_size)
+{
+	__m256i key = vector_core_key_avx2(value, element_size);
+	__m256i equal;
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t found = 0;
+	unsigned int mask = 0;
+
+	for (; offset + 128 <= bytes; offset += 128) {
+		equal = _mm256_or_si256(
+			_mm256_or_si256(
+				vector_core_equal_avx2(begin + offset, key,
+						       element_size),
+				vector_core_equal_avx2(begin + offset + 32,
+						       key, element_size)),
+			_mm256_or_si256(
+				vector_core_equal_avx2(begin + offset + 64,
+						       key, element_size),
+				vector_core_equal_avx2(begin + offset + 96,
+						       key, element_size)));
+		if (_mm256_movemask_epi8(equal) != 0) {
+			break;
+		}
+	}
+	for (; offset + 32 <= bytes; offset += 32) {
+		mask = (unsigned int)_mm256_movemask_epi8(
+			vector_core_equal_avx2(begin + offset, key,
+					       element_size));
+		if (mask != 0) {
+			return (offset + (size_t)__builtin_ctz(mask))
+			       / element_size;
+		}
+	}
+	found = vector_core_find_sse2(begin + offset,
+				      (bytes - offset) / element_size, value,
+				      element_size);
+	return found == VECTOR_NOT_FOUND ? found
+					 : offset / element_size + found;
+}
+
+static VECTOR_TARGET_AVX2 size_t vector_core_count_avx2(
+	const unsigned char *begin, size_t size, const void *value,
+	size_t element_size)
+{
+	__m256i key = vector_core_key_avx2(value, element_size);
+	__m256i counts;
+	unsigned int lanes[8];
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t block_end = 0;
+	size_t count = 0;
+	size_t block_count = 0;
+	size_t lane = 0;
+
+	while (offset + 32 <= bytes) {
+		counts = _mm256_setzero_si256();
+		block_end = bytes - offset > ((size_t)1 << 30)
+				    ? offset + ((size_t)1 << 30)
+				    : bytes;
+		for (; offset + 32 <= block_end; offset += 32) {
+			counts = _mm256_sub_epi32(
+				counts, vector_core_equal_avx2(begin + offset,
+							       key,
+							       element_size));
+		}
+		_mm256_storeu_si256((__m256i *)lanes, counts);
+		block_count = 0;
+		for (lane = 0; lane < 8; lane++) {
+			block_count += lanes[lane];
+		}
+		count += block_count / (element_size / 4);
+	}
+	return count
+	       + vector_core_count_sse2(begin + offset,
+					(bytes - offset) / element_size, value,
+					element_size);
+}
+
+size_t vector_core_find_bits(const void *begin, size_t size, const void *value,
+			     size_t element_size)
+{
+	if (vector_core_simd_level >= 2 && __builtin_cpu_supports("avx2")) {
+		return vector_core_find_avx2((const unsigned char *)begin,
+					     size, value, element_size);
+	}
+	if (vector_core_simd_level >= 1) {
+		return vector_core_find_sse2((const unsigned char *)begin,
+					     size, value, element_size);
+	}
+	return vector_core_find_scalar(begin, size, value, element_size);
+}
+
+size_t vector_core_count_bits(const void *begin, size_t size, const void *value,
+			      size_t element_size)
+{
+	if (vector_core_simd_level >= 2 && __builtin_cpu_supports("avx2")) {
+		return vector_core_count_avx2((const unsigned char *)begin,
+					      size, value, element_size);
+	}
+	if (vector_core_simd_level >= 1) {
+		return vector_core_count_sse2((const unsigned char *)begin,
+					      size, value, element_size);
+	}
+	return vector_core_count_scalar(begin, size, value, element_size);
+}
+
+/* The sums of the scalar kernels, one SIMD register holding several
+ * consecutive lanes, folded by halves the same way */
+static float vector_core_sum_f32_sse2(const float *a, const float *b,
+				      size_t size)
+{
+	__m128 lanes[4];
+	__m128 value;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = _mm_setzero_ps();
+	lanes[1] = _mm_setzero_ps();
+	lanes[2] = _mm_setzero_ps();
+	lanes[3] = _mm_setzero_ps();
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+			lanes[0] = _mm_add_ps(lanes[0], value);
+			value = _mm_mul_ps(_mm_loadu_ps(a + 4),
+					   _mm_loadu_ps(b + 4));
+			lanes[1] = _mm_add_ps(lanes[1], value);
+			value = _mm_mul_ps(_mm_loadu_ps(a + 8),
+					   _mm_loadu_ps(b + 8));
+			lanes[2] = _mm_add_ps(lanes[2], value);
+			value = _mm_mul_ps(_mm_loadu_ps(a + 12),
+					   _mm_loadu_ps(b + 12));
+			lanes[3] = _mm_add_ps(lanes[3], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = _mm_add_ps(lanes[0], _mm_loadu_ps(a));
+			lanes[1] = _mm_add_ps(lanes[1], _mm_loadu_ps(a + 4));
+			lanes[2] = _mm_add_ps(lanes[2], _mm_loadu_ps(a + 8));
+			lanes[3] = _mm_add_ps(lanes[3], _mm_loadu_ps(a + 12));
+		}
+	}
+	lanes[0] = _mm_add_ps(lanes[0], lanes[2]);
+	lanes[1] = _mm_add_ps(lanes[1], lanes[3]);
+	lanes[0] = _mm_add_ps(lanes[0], lanes[1]);
+	lanes[0] = _mm_add_ps(lanes[0], _mm_movehl_ps(lanes[0], lanes[0]));
+	lanes[0] = _mm_add_ss(lanes[0], _mm_shuffle_ps(lanes[0], lanes[0], 1));
+	return vector_core_sum_f32_tail(_mm_cvtss_f32(lanes[0]), a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+
+static double vector_core_sum_f64_sse2(const double *a, const double *b,
+				       size_t size)
+{
+	__m128d lanes[8];
+	__m128d value;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = _mm_setzero_pd();
+	lanes[1] = _mm_setzero_pd();
+	lanes[2] = _mm_setzero_pd();
+	lanes[3] = _mm_setzero_pd();
+	lanes[4] = _mm_setzero_pd();
+	lanes[5] = _mm_setzero_pd();
+	lanes[6] = _mm_setzero_pd();
+	lanes[7] = _mm_setzero_pd();
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b));
+			lanes[0] = _mm_add_pd(lanes[0], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 2),
+					   _mm_loadu_pd(b + 2));
+			lanes[1] = _mm_add_pd(lanes[1], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 4),
+					   _mm_loadu_pd(b + 4));
+			lanes[2] = _mm_add_pd(lanes[2], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 6),
+					   _mm_loadu_pd(b + 6));
+			lanes[3] = _mm_add_pd(lanes[3], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 8),
+					   _mm_loadu_pd(b + 8));
+			lanes[4] = _mm_add_pd(lanes[4], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 10),
+					   _mm_loadu_pd(b + 10));
+			lanes[5] = _mm_add_pd(lanes[5], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 12),
+					   _mm_loadu_pd(b + 12));
+			lanes[6] = _mm_add_pd(lanes[6], value);
+			value = _mm_mul_pd(_mm_loadu_pd(a + 14),
+					   _mm_loadu_pd(b + 14));
+			lanes[7] = _mm_add_pd(lanes[7], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = _mm_add_pd(lanes[0], _mm_loadu_pd(a));
+			lanes[1] = _mm_add_pd(lanes[1], _mm_loadu_pd(a + 2));
+			lanes[2] = _mm_add_pd(lanes[2], _mm_loadu_pd(a + 4));
+			lanes[3] = _mm_add_pd(lanes[3], _mm_loadu_pd(a + 6));
+			lanes[4] = _mm_add_pd(lanes[4], _mm_loadu_pd(a + 8));
+			lanes[5] = _mm_add_pd(lanes[5], _mm_loadu_pd(a + 10));
+			lanes[6] = _mm_add_pd(lanes[6], _mm_loadu_pd(a + 12));
+			lanes[7] = _mm_add_pd(lanes[7], _mm_loadu_pd(a + 14));
+		}
+	}
+	lanes[0] = _mm_add_pd(lanes[0], lanes[4]);
+	lanes[1] = _mm_add_pd(lanes[1], lanes[5]);
+	lanes[2] = _mm_add_pd(lanes[2], lanes[6]);
+	lanes[3] = _mm_add_pd(lanes[3], lanes[7]);
+	lanes[0] = _mm_add_pd(lanes[0], lanes[2]);
+	lanes[1] = _mm_add_pd(lanes[1], lanes[3]);
+	lanes[0] = _mm_add_pd(lanes[0], lanes[1]);
+	lanes[0] = _mm_add_sd(lanes[0], _mm_unpackhi_pd(lanes[0], lanes[0]));
+	return vector_core_sum_f64_tail(_mm_cvtsd_f64(lanes[0]), a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+
+static VECTOR_TARGET_AVX2 float vector_core_sum_f32_avx2(const float *a,
+							 const float *b,
+							 size_t size)
+{
+	__m256 lanes[2];
+	__m256 value;
+	__m128 half;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = _mm256_setzero_ps();
+	lanes[1] = _mm256_setzero_ps();
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = _mm256_mul_ps(_mm256_loadu_ps(a),
+					      _mm256_loadu_ps(b));
+			lanes[0] = _mm256_add_ps(lanes[0], value);
+			value = _mm256_mul_ps(_mm256_loadu_ps(a + 8),
+					      _mm256_loadu_ps(b + 8));
+			lanes[1] = _mm256_add_ps(lanes[1], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = _mm256_add_ps(lanes[0], _mm256_loadu_ps(a));
+			lanes[1] = _mm256_add_ps(lanes[1],
+						 _mm256_loadu_ps(a + 8));
+		}
+	}
+	lanes[0] = _mm256_add_ps(lanes[0], lanes[1]);
+	half = _mm_add_ps(_mm256_castps256_ps128(lanes[0]),
+			  _mm256_extractf128_ps(lanes[0], 1));
+	half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+	half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+	return vector_core_sum_f32_tail(_mm_cvtss_f32(half), a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+
+static VECTOR_TARGET_AVX2 double vector_core_sum_f64_avx2(const double *a,
+							  const double *b,
+							  size_t size)
+{
+	__m256d lanes[4];
+	__m256d value;
+	__m128d half;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = _mm256_setzero_pd();
+	lanes[1] = _mm256_setzero_pd();
+	lanes[2] = _mm256_setzero_pd();
+	lanes[3] = _mm256_setzero_pd();
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = _mm256_mul_pd(_mm256_loadu_pd(a),
+					      _mm256_loadu_pd(b));
+			lanes[0] = _mm256_add_pd(lanes[0], value);
+			value = _mm256_mul_pd(_mm256_loadu_pd(a + 4),
+					      _mm256_loadu_pd(b + 4));
+			lanes[1] = _mm256_add_pd(lanes[1], value);
+			value = _mm256_mul_pd(_mm256_loadu_pd(a + 8),
+					      _mm256_loadu_pd(b + 8));
+			lanes[2] = _mm256_add_pd(lanes[2], value);
+			value = _mm256_mul_pd(_mm256_loadu_pd(a + 12),
+					      _mm256_loadu_pd(b + 12));
+			lanes[3] = _mm256_add_pd(lanes[3], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = _mm256_add_pd(lanes[0], _mm256_loadu_pd(a));
+			lanes[1] = _mm256_add_pd(lanes[1],
+						 _mm256_loadu_pd(a + 4));
+			lanes[2] = _mm256_add_pd(lanes[2],
+						 _mm256_loadu_pd(a + 8));
+			lanes[3] = _mm256_add_pd(lanes[3],
+						 _mm256_loadu_pd(a + 12));
+		}
+	}
+	lanes[0] = _mm256_add_pd(lanes[0], lanes[2]);
+	lanes[1] = _mm256_add_pd(lanes[1], lanes[3]);
+	lanes[0] = _mm256_add_pd(lanes[0], lanes[1]);
+	half = _mm_add_pd(_mm256_castpd256_pd128(lanes[0]),
+			  _mm256_extractf128_pd(lanes[0], 1));
+	half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+	return vector_core_sum_f64_tail(_mm_cvtsd_f64(half), a, b,
+					size % VECTOR_REDUCE_LANES);
+}
+
+float vector_core_sum_f32(const float *a, const float *b, size_t size)
+{
+	if (vector_core_simd_level >= 2 && __builtin_cpu_supports("avx2")) {
+		return vector_core_sum_f32_avx2(a, b, size);
+	}
+	if (vector_core_simd_level >= 1) {
+		return vector_core_sum_f32_sse2(a, b, size);
+	}
+	return vector_core_sum_f32_scalar(a, b, size);
+}
+
+double vector_core_sum_f64(const double *a, const double *b, size_t size)
+{
+	if (vector_core_simd_level >= 2 && __builtin_cpu_supports("avx2")) {
+		return vector_core_sum_f64_avx2(a, b, size);
+	}
+	if (vector_core_simd_level >= 1) {
+		return vector_core_sum_f64_sse2(a, b, size);
+	}
+	return vector_core_sum_f64_scalar(a, b, size);
+}
+/* Macro VECTOR_DEFINE_SHARED_SIMD stop here */
+#elif VECTOR_SIMD == 2
+/* Macro VECTOR_DEFINE_SHARED_SIMD() start here */
+/* Lanes of 4 or 8 bytes at at equal to key32 or key64, all ones or zeros */
+static uint32x4_t vector_core_equal_neon(const unsigned char *at,
+					 uint32x4_t key32, uint64x2_t key64,
+					 size_t element_size)
+{
+	uint8x16_t lanes = vld1q_u8(at);
+
+	if (element_size == 4) {
+		return vceqq_u32(vreinterpretq_u32_u8(lanes), key32);
+	}
+	return vreinterpretq_u32_u64(
+		vceqq_u64(vreinterpretq_u64_u8(lanes), key64));
+}
+
+static size_t vector_core_find_neon(const unsigned char *begin, size_t size,
+				    const void *value, size_t element_size)
+{
+	uint32_t bits32 = 0;
+	uint64_t bits64 = 0;
+	uint32x4_t key32;
+	uint64x2_t key64;
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t found = 0;
+
+	memcpy(element_size == 4 ? (void *)&bits32 : (void *)&bits64, value,
+	       element_size);
+	key32 = vdupq_n_u32(bits32);
+	key64 = vdupq_n_u64(bits64);
+	/* 16 bytes per iteration until a match, located by the scalar loop */
+	for (; offset + 16 <= bytes; offset += 16) {
+		if (vmaxvq_u32(vector_core_equal_neon(begin + offset, key32,
+						      key64, element_size))
+		    != 0) {
+			break;
+		}
+	}
+	found = vector_core_find_scalar(begin + offset,
+					(bytes - offset) / element_size, value,
+					element_size);
+	return found == VECTOR_NOT_FOUND ? found
+					 : offset / element_size + found;
+}
+
+/* Every match subtracts -1 from its lanes of 4 bytes, two of them for
+ * elements of 8 bytes. Lanes are added up every block of 2^30 bytes, before
+ * they could overflow */
+static size_t vector_core_count_neon(const unsigned char *begin, size_t size,
+				     const void *value, size_t element_size)
+{
+	uint32_t bits32 = 0;
+	uint64_t bits64 = 0;
+	uint32x4_t key32;
+	uint64x2_t key64;
+	uint32x4_t counts;
+	size_t bytes = size * element_size;
+	size_t offset = 0;
+	size_t block_end = 0;
+	size_t count = 0;
+
+	memcpy(element_size == 4 ? (void *)&bits32 : (void *)&bits64, value,
+	       element_size);
+	key32 = vdupq_n_u32(bits32);
+	key64 = vdupq_n_u64(bits64);
+	while (offset + 16 <= bytes) {
+		counts = vdupq_n_u32(0);
+		block_end = bytes - offset > ((size_t)1 << 30)
+				    ? offset + ((size_t)1 << 30)
+				    : bytes;
+		for (; offset + 16 <= block_end; offset += 16) {
+			counts = vsubq_u32(
+				counts, vector_core_equal_neon(begin + offset,
+							       key32, key64,
+							       element_size));
+		}
+		count += (size_t)vaddvq_u32(counts) / (element_size / 4);
+	}
+	return count
+	       + vector_core_count_scalar(begin + offset,
+					  (bytes - offset) / element_size,
+					  value, element_size);
+}
+
+size_t vector_core_find_bits(const void *begin, size_t size, const void *value,
+			     size_t element_size)
+{
+	if (vector_core_simd_level >= 1) {
+		return vector_core_find_neon((const unsigned char *)begin,
+					     size, value, element_size);
+	}
+	return vector_core_find_scalar(begin, size, value, element_size);
+}
+
+size_t vector_core_count_bits(const void *begin, size_t size, const void *value,
+			      size_t element_size)
+{
+	if (vector_core_simd_level >= 1) {
+		return vector_core_count_neon((const unsigned char *)begin,
+					      size, value, element_size);
+	}
+	return vector_core_count_scalar(begin, size, value, element_size);
+}
+
+/* The sums of the scalar kernels, one SIMD register holding several
+ * consecutive lanes, folded by halves the same way */
+static float vector_core_sum_f32_neon(const float *a, const float *b,
+				      size_t size)
+{
+	float32x4_t lanes[4];
+	float32x4_t value;
+	float32x2_t half;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = vdupq_n_f32(0);
+	lanes[1] = vdupq_n_f32(0);
+	lanes[2] = vdupq_n_f32(0);
+	lanes[3] = vdupq_n_f32(0);
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = vmulq_f32(vld1q_f32(a), vld1q_f32(b));
+			lanes[0] = vaddq_f32(lanes[0], value);
+			value = vmulq_f32(vld1q_f32(a + 4), vld1q_f32(b + 4));
+			lanes[1] = vaddq_f32(lanes[1], value);
+			value = vmulq_f32(vld1q_f32(a + 8), vld1q_f32(b + 8));
+			lanes[2] = vaddq_f32(lanes[2], value);
+			value = vmulq_f32(vld1q_f32(a + 12), vld1q_f32(b + 12));
+			lanes[3] = vaddq_f32(lanes[3], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = vaddq_f32(lanes[0], vld1q_f32(a));
+			lanes[1] = vaddq_f32(lanes[1], vld1q_f32(a + 4));
+			lanes[2] = vaddq_f32(lanes[2], vld1q_f32(a + 8));
+			lanes[3] = vaddq_f32(lanes[3], vld1q_f32(a + 12));
+		}
+	}
+	lanes[0] = vaddq_f32(lanes[0], lanes[2]);
+	lanes[1] = vaddq_f32(lanes[1], lanes[3]);
+	lanes[0] = vaddq_f32(lanes[0], lanes[1]);
+	half = vadd_f32(vget_low_f32(lanes[0]), vget_high_f32(lanes[0]));
+	return vector_core_sum_f32_tail(vget_lane_f32(half, 0)
+						+ vget_lane_f32(half, 1),
+					a, b, size % VECTOR_REDUCE_LANES);
+}
+
+static double vector_core_sum_f64_neon(const double *a, const double *b,
+				       size_t size)
+{
+	float64x2_t lanes[8];
+	float64x2_t value;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+
+	lanes[0] = vdupq_n_f64(0);
+	lanes[1] = vdupq_n_f64(0);
+	lanes[2] = vdupq_n_f64(0);
+	lanes[3] = vdupq_n_f64(0);
+	lanes[4] = vdupq_n_f64(0);
+	lanes[5] = vdupq_n_f64(0);
+	lanes[6] = vdupq_n_f64(0);
+	lanes[7] = vdupq_n_f64(0);
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			value = vmulq_f64(vld1q_f64(a), vld1q_f64(b));
+			lanes[0] = vaddq_f64(lanes[0], value);
+			value = vmulq_f64(vld1q_f64(a + 2), vld1q_f64(b + 2));
+			lanes[1] = vaddq_f64(lanes[1], value);
+			value = vmulq_f64(vld1q_f64(a + 4), vld1q_f64(b + 4));
+			lanes[2] = vaddq_f64(lanes[2], value);
+			value = vmulq_f64(vld1q_f64(a + 6), vld1q_f64(b + 6));
+			lanes[3] = vaddq_f64(lanes[3], value);
+			value = vmulq_f64(vld1q_f64(a + 8), vld1q_f64(b + 8));
+			lanes[4] = vaddq_f64(lanes[4], value);
+			value = vmulq_f64(vld1q_f64(a + 10), vld1q_f64(b + 10));
+			lanes[5] = vaddq_f64(lanes[5], value);
+			value = vmulq_f64(vld1q_f64(a + 12), vld1q_f64(b + 12));
+			lanes[6] = vaddq_f64(lanes[6], value);
+			value = vmulq_f64(vld1q_f64(a + 14), vld1q_f64(b + 14));
+			lanes[7] = vaddq_f64(lanes[7], value);
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			lanes[0] = vaddq_f64(lanes[0], vld1q_f64(a));
+			lanes[1] = vaddq_f64(lanes[1], vld1q_f64(a + 2));
+			lanes[2] = vaddq_f64(lanes[2], vld1q_f64(a + 4));
+			lanes[3] = vaddq_f64(lanes[3], vld1q_f64(a + 6));
+			lanes[4] = vaddq_f64(lanes[4], vld1q_f64(a + 8));
+			lanes[5] = vaddq_f64(lanes[5], vld1q_f64(a + 10));
+			lanes[6] = vaddq_f64(lanes[6], vld1q_f64(a + 12));
+			lanes[7] = vaddq_f64(lanes[7], vld1q_f64(a + 14));
+		}
+	}
+	lanes[0] = vaddq_f64(lanes[0], lanes[4]);
+	lanes[1] = vaddq_f64(lanes[1], lanes[5]);
+	lanes[2] = vaddq_f64(lanes[2], lanes[6]);
+	lanes[3] = vaddq_f64(lanes[3], lanes[7]);
+	lanes[0] = vaddq_f64(lanes[0], lanes[2]);
+	lanes[1] = vaddq_f64(lanes[1], lanes[3]);
+	lanes[0] = vaddq_f64(lanes[0], lanes[1]);
+	return vector_core_sum_f64_tail(vgetq_lane_f64(lanes[0], 0)
+						+ vgetq_lane_f64(lanes[0], 1),
+					a, b, size % VECTOR_REDUCE_LANES);
+}
+
+float vector_core_sum_f32(const float *a, const float *b, size_t size)
+{
+	if (vector_core_simd_level >= 1) {
+		return vector_core_sum_f32_neon(a, b, size);
+	}
+	return vector_core_sum_f32_scalar(a, b, size);
+}
+
+double vector_core_sum_f64(const double *a, const double *b, size_t size)
+{
+	if (vector_core_simd_level >= 1) {
+		return vector_core_sum_f64_neon(a, b, size);
+	}
+	return vector_core_sum_f64_scalar(a, b, size);
+}
+/* Macro VECTOR_DEFINE_SHARED_SIMD stop here */
+#else
+/* Macro VECTOR_DEFINE_SHARED_SIMD() start here */
+size_t vector_core_find_bits(const void *begin, size_t size, const void *value,
+			     size_t element_size)
+{
+	return vector_core_find_scalar(begin, size, value, element_size);
+}
+
+size_t vector_core_count_bits(const void *begin, size_t size, const void *value,
+			      size_t element_size)
+{
+	return vector_core_count_scalar(begin, size, value, element_size);
+}
+
+float vector_core_sum_f32(const float *a, const float *b, size_t size)
+{
+	return vector_core_sum_f32_scalar(a, b, size);
+}
+
+double vector_core_sum_f64(const double *a, const double *b, size_t size)
+{
+	return vector_core_sum_f64_scalar(a, b, size);
+}
+/* Macro VECTOR_DEFINE_SHARED_SIMD stop here */
+#endif
+
+#define VECTOR_DEFINE_SHARED_CORE()                                   \
+	VECTOR_DEFINE_SHARED_CORE_BASE() VECTOR_DEFINE_SHARED_MMAP()  \
+	VECTOR_DEFINE_SHARED_PARALLEL() VECTOR_DEFINE_SHARED_STREAM() \
+	VECTOR_DEFINE_SHARED_SIMD()
+
+#if VECTOR_ACCOUNTING
+/* Macro VECTOR_DEFINE_ACCOUNT(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+static VectorCoreAccountStats vector_account_entry = {
+	"Vector", NULL, NULL, 0, 0, 0, { 0 }
+};
+
+SampleLinkage void vector_account(size_t old_capacity, size_t old_size,
+				  size_t new_capacity, size_t new_size)
+{
+	vector_core_account(&vector_account_entry, sizeof(SampleType),
+			    old_capacity, old_size, new_capacity, new_size);
+}
+
+SampleLinkage const VectorCoreAccountStats *vector_account_stats(void)
+{
+	return vector_core_account_shared(&vector_account_entry);
+}
+/* Macro VECTOR_DEFINE_ACCOUNT stop here */
+#else
+/* Macro VECTOR_DEFINE_ACCOUNT(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_account(size_t old_capacity, size_t old_size,
+				  size_t new_capacity, size_t new_size)
+{
+	(void)old_capacity;
+	(void)old_size;
+	(void)new_capacity;
+	(void)new_size;
+}
+
+SampleLinkage const VectorCoreAccountStats *vector_account_stats(void)
+{
+	return NULL;
+}
+/* Macro VECTOR_DEFINE_ACCOUNT stop here */
+#endif
+
+#if VECTOR_TRACE
+/* Macro VECTOR_DEFINE_TRACE(Struct_Name_=Vector, Functions_Prefix_=vector, Linkage_=SampleLinkage) start here */
+static VectorCoreTraceCounters vector_trace_counters;
+
+SampleLinkage void vector_trace_dump(FILE *stream)
+{
+	vector_core_trace_dump(&vector_trace_counters, "Vector", stream);
+}
+/* Macro VECTOR_DEFINE_TRACE stop here */
+#else
+/* Macro VECTOR_DEFINE_TRACE(Struct_Name_=Vector, Functions_Prefix_=vector, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_trace_dump(FILE *stream)
+{
+	(void)stream;
+}
+/* Macro VECTOR_DEFINE_TRACE stop here */
+#endif
+
+/* Macro VECTOR_DEFINE_CORE_BASE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage, Panic_Linkage_=SamplePanicLinkage) start here */
+struct Vector;
+VECTOR_DEFINE_PANIC(vector, SamplePanicLinkage)
+
+VECTOR_INLINE void vector_assert(const struct Vector *vec)
+{
+	if (VECTOR_NO_CHECKS) {
+		return;
+	}
+
+	if (vec->begin == NULL) {
+		assert(vec->end == NULL && vec->end_of_storage == NULL);
+		return;
+	}
+
+	assert(vec->end && vec->end_of_storage);
+	assert(vec->begin <= vec->end && vec->end <= vec->end_of_storage);
+}
+
+SampleLinkage void vector_resize(Vector *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_resize but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_UNLIKELY(element_count != 0
+			    && sizeof(SampleType)
+				       > ((size_t)-1) / element_count)) {
+		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+			return;
+		}
+		vector_panic("Requested capacity would cause size overflow.");
+	}
+
+	if (vec->begin == NULL) {
+		vector_init(vec, element_count);
+	}
+
+	if (element_count > VECTOR_CAPACITY(vec)) {
+		vector_grow(vec, element_count);
+	}
+
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec), VECTOR_SIZE(vec),
+		       VECTOR_CAPACITY(vec), element_count);
+	vec->end = vec->begin + element_count;
+}
+
+SampleLinkage void vector_free(struct Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_free but non-null argument expected.");
+	}
+
+	vector_assert(vec);
+
+	if (vec->begin) {
+		VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_FREE,
+				   "Vector", "vector_free",
+				   VECTOR_CAPACITY(vec), 0,
+				   VECTOR_CAPACITY(vec) * sizeof(SampleType));
+		VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+			       VECTOR_SIZE(vec), 0, 0);
+	}
+	VECTOR_FREE(vec->begin);
+	vec->begin = NULL;
+	vec->end = NULL;
+	vec->end_of_storage = NULL;
+}
+
+SampleLinkage void vector_push(struct Vector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_push but non-null argument expected.");
+	}
+
+	vector_assert(vec);
+
+	if (vec->begin == NULL) {
+		vector_init(vec, VECTOR_DEFAULT_CAPACITY);
+	}
+
+	if (VECTOR_UNLIKELY(VECTOR_SIZE(vec) >= VECTOR_CAPACITY(vec))) {
+		vector_grow(vec, VECTOR_CAPACITY(vec) * VECTOR_GROWTH_FACTOR);
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+}
+
+SampleLinkage int vector_try_push(struct Vector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_try_push but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (vec->end == vec->end_of_storage) {
+		return 0;
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+
+	return 1;
+}
+
+SampleLinkage SampleType vector_pop(struct Vector *vec)
+{
+	SampleType nothing = { 0 };
+	SampleType ret = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_pop but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(vec))) {
+		vector_panic("Cannot pop from empty vector.");
+	}
+
+	ret = vec->end[-1];
+	vec->end--;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) + 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+
+	return ret;
+}
+
+SampleLinkage void vector_clear(struct Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_clear but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec), VECTOR_SIZE(vec),
+		       VECTOR_CAPACITY(vec), 0);
+	vec->end = vec->begin;
+}
+/* Macro VECTOR_DEFINE_CORE_BASE stop here */
+
+#if VECTOR_SHARED_CORE
+/* Macro VECTOR_DEFINE_CORE_GROW(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_grow(struct Vector *vec, size_t element_count)
+{
+	void *begin = NULL;
+	size_t old_size = 0;
+	size_t capacity = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_grow but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	begin = vec->begin;
+	old_size = VECTOR_SIZE(vec);
+	capacity = vector_core_grow(&begin, VECTOR_CAPACITY(vec),
+				    element_count, sizeof(SampleType));
+	if (begin == (void *)vec->begin && capacity == VECTOR_CAPACITY(vec)) {
+		return;
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_grow", VECTOR_CAPACITY(vec),
+			   capacity, capacity * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec), old_size, capacity,
+		       old_size);
+
+	vec->begin = (SampleType *)begin;
+	vec->end = vec->begin + old_size;
+	vec->end_of_storage = vec->begin + capacity;
+}
+
+SampleLinkage void vector_init(struct Vector *vec, size_t element_count)
+{
+	void *begin = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_init but non-null argument expected.");
+	}
+
+	if (element_count == 0) {
+		return;
+	}
+
+	element_count = vector_core_grow(&begin, 0, element_count,
+					 sizeof(SampleType));
+	if (begin == NULL) {
+		return;
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_init", 0, element_count,
+			   element_count * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, 0, 0, element_count, 0);
+
+	vec->begin = (SampleType *)begin;
+	vec->end = vec->begin;
+	vec->end_of_storage = vec->begin + element_count;
+
+	vector_assert(vec);
+}
+/* Macro VECTOR_DEFINE_CORE_GROW stop here */
+#else
+/* Macro VECTOR_DEFINE_CORE_GROW(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_grow(struct Vector *vec, size_t element_count)
+{
+	size_t old_size = 0;
+	SampleType *new_begin = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_grow but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_UNLIKELY(element_count != 0
+			    && sizeof(SampleType)
+				       > ((size_t)-1) / element_count)) {
+		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+			return;
+		}
+		vector_panic("Requested capacity would cause size overflow.");
+	}
+
+	if (vec->begin) {
+		if (VECTOR_CAPACITY(vec) == element_count) {
+			return;
+		}
+		if (VECTOR_CAPACITY(vec) > element_count) {
+			vector_panic("Vector shrinking not supported.");
+		}
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	old_size = VECTOR_SIZE(vec);
 
 	new_begin = VECTOR_REALLOC(vec->begin, element_count
 				   * sizeof(SampleType));
-	if (new_begin == NULL) {
+	if (VECTOR_UNLIKELY(new_begin == NULL)) {
 		vector_panic("Out of memory. Panic.");
 	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_grow", VECTOR_CAPACITY(vec),
+			   element_count, element_count * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec), old_size,
+		       element_count, old_size);
+
+	vec->begin = new_begin;
+	vec->end = new_begin + old_size;
+	vec->end_of_storage = new_begin + element_count;
+}
+
+SampleLinkage void vector_init(struct Vector *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_init but non-null argument expected.");
+	}
+
+	if (element_count == 0) {
+		return;
+	}
+
+	if (VECTOR_UNLIKELY(sizeof(SampleType)
+			    > ((size_t)-1) / element_count)) {
+		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+			return;
+		}
+		vector_panic("Requested element_count would cause size overflow.");
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	vec->begin = VECTOR_REALLOC(NULL, element_count * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(vec->begin == NULL)) {
+		vector_panic("Out of memory. Panic.");
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_init", 0, element_count,
+			   element_count * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, 0, 0, element_count, 0);
+
+	vec->end = vec->begin;
+	vec->end_of_storage = vec->begin + element_count;
+
+	vector_assert(vec);
+}
+/* Macro VECTOR_DEFINE_CORE_GROW stop here */
+#endif
+
+/* Macro VECTOR_DEFINE_ACCESS_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage SampleType vector_get(const struct Vector *vec, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_get but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		vector_panic("Out of range.");
+	}
+
+	return vec->begin[idx];
+}
+
+SampleLinkage void vector_set(struct Vector *vec, size_t idx, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_set but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	vec->begin[idx] = value;
+}
+/* Macro VECTOR_DEFINE_ACCESS_LINKAGE stop here */
+
+#if VECTOR_SHARED_CORE
+/* Macro VECTOR_DEFINE_EDIT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_insert(struct Vector *vec, size_t idx,
+				 SampleType value)
+{
+	size_t capacity = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_insert but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	capacity = VECTOR_CAPACITY(vec);
+	if (VECTOR_SIZE(vec) >= capacity) {
+		/* Set a minimum multiplicand of 1 */
+		vector_grow(vec, (capacity | (capacity == 0)) *
+					 VECTOR_GROWTH_FACTOR);
+	}
+
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_insert", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec),
+			   (VECTOR_SIZE(vec) - idx) * sizeof(SampleType));
+	vector_core_insert(vec->begin, VECTOR_SIZE(vec), idx,
+			   sizeof(SampleType));
+	vec->begin[idx] = value;
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+}
+
+SampleLinkage int vector_try_insert(struct Vector *vec, size_t idx,
+				   SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_try_insert but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return 0;
+		}
+		vector_panic("Out of range.");
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		return 0;
+	}
+
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_try_insert", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec),
+			   (VECTOR_SIZE(vec) - idx) * sizeof(SampleType));
+	vector_core_insert(vec->begin, VECTOR_SIZE(vec), idx,
+			   sizeof(SampleType));
+	vec->begin[idx] = value;
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+
+	return 1;
+}
+
+SampleLinkage void vector_delete(struct Vector *vec, size_t idx)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_delete but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_delete", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec),
+			   (VECTOR_SIZE(vec) - idx - 1) * sizeof(SampleType));
+	vector_core_delete(vec->begin, VECTOR_SIZE(vec), idx,
+			   sizeof(SampleType));
+	vec->end--;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) + 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+}
+/* Macro VECTOR_DEFINE_EDIT_LINKAGE stop here */
+#else
+/* Macro VECTOR_DEFINE_EDIT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_insert(struct Vector *vec, size_t idx,
+				 SampleType value)
+{
+	SampleType *middle = NULL;
+	size_t delete_size = 0;
+	size_t capacity = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_insert but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	capacity = VECTOR_CAPACITY(vec);
+	if (VECTOR_SIZE(vec) >= capacity) {
+		/* Set a minimum multiplicand of 1 */
+		vector_grow(vec, (capacity | (capacity == 0)) *
+					 VECTOR_GROWTH_FACTOR);
+	}
+
+	if (vec->begin + idx == vec->end) {
+		vec->end[0] = value;
+		vec->end++;
+		VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+			       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+			       VECTOR_SIZE(vec));
+		return;
+	}
+
+	middle = vec->begin + idx;
+	delete_size = (vec->end - middle) * sizeof(SampleType);
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_insert", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec), delete_size);
+	memmove(middle + 1, middle, delete_size);
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+	middle[0] = value;
+}
+
+SampleLinkage int vector_try_insert(struct Vector *vec, size_t idx,
+				   SampleType value)
+{
+	SampleType *middle = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_try_insert but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return 0;
+		}
+		vector_panic("Out of range.");
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		return 0;
+	}
+
+	middle = vec->begin + idx;
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_try_insert", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec),
+			   (vec->end - middle) * sizeof(SampleType));
+	memmove(middle + 1, middle, (vec->end - middle) * sizeof(SampleType));
+	vec->end++;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) - 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+	middle[0] = value;
+
+	return 1;
+}
+
+SampleLinkage void vector_delete(struct Vector *vec, size_t idx)
+{
+	SampleType *middle = NULL;
+	size_t delete_size = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_delete but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	/* Delete last element */
+	if (idx == VECTOR_SIZE(vec) - 1) {
+		vec->end--;
+		VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+			       VECTOR_SIZE(vec) + 1, VECTOR_CAPACITY(vec),
+			       VECTOR_SIZE(vec));
+		return;
+	}
+
+	middle = vec->begin + idx;
+	delete_size = (vec->end - middle - 1) * sizeof(SampleType);
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_delete", VECTOR_CAPACITY(vec),
+			   VECTOR_CAPACITY(vec), delete_size);
+	memmove(middle, middle + 1, delete_size);
+	vec->end--;
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec) + 1, VECTOR_CAPACITY(vec),
+		       VECTOR_SIZE(vec));
+}
+/* Macro VECTOR_DEFINE_EDIT_LINKAGE stop here */
+#endif
+
+#if VECTOR_SHARED_CORE
+/* Macro VECTOR_DEFINE_DUPLICATE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_duplicate(struct Vector *RESTRICT dest,
+		      const struct Vector *RESTRICT src)
+{
+	if (VECTOR_CHECK(dest == NULL || src == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_duplicate but non-null argument expected.");
+	}
+	vector_assert(src);
+
+	dest->begin = (SampleType *)vector_core_duplicate(
+		src->begin, VECTOR_SIZE(src), VECTOR_CAPACITY(src),
+		sizeof(SampleType));
+	if (dest->begin == NULL) {
+		dest->end = NULL;
+		dest->end_of_storage = NULL;
+		return;
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_duplicate", 0,
+			   VECTOR_CAPACITY(src),
+			   VECTOR_CAPACITY(src) * sizeof(SampleType));
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_duplicate", 0,
+			   VECTOR_CAPACITY(src),
+			   VECTOR_SIZE(src) * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, 0, 0, VECTOR_CAPACITY(src),
+		       VECTOR_SIZE(src));
+
+	dest->end = dest->begin + VECTOR_SIZE(src);
+	dest->end_of_storage = dest->begin + VECTOR_CAPACITY(src);
+
+	vector_assert(dest);
+}
+/* Macro VECTOR_DEFINE_DUPLICATE_LINKAGE stop here */
+#else
+/* Macro VECTOR_DEFINE_DUPLICATE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_duplicate(struct Vector *RESTRICT dest,
+		      const struct Vector *RESTRICT src)
+{
+	if (VECTOR_CHECK(dest == NULL || src == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_duplicate but non-null argument expected.");
+	}
+	vector_assert(src);
+
+	if (VECTOR_CAPACITY(src) == 0) {
+		dest->begin = NULL;
+		dest->end = NULL;
+		dest->end_of_storage = NULL;
+		return;
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	dest->begin =
+		VECTOR_REALLOC(NULL, VECTOR_CAPACITY(src) * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(dest->begin == NULL)) {
+		vector_panic("Out of memory.");
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_duplicate", 0,
+			   VECTOR_CAPACITY(src),
+			   VECTOR_CAPACITY(src) * sizeof(SampleType));
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_duplicate", 0,
+			   VECTOR_CAPACITY(src),
+			   VECTOR_SIZE(src) * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, 0, 0, VECTOR_CAPACITY(src),
+		       VECTOR_SIZE(src));
+
+	dest->end = dest->begin + VECTOR_SIZE(src);
+	dest->end_of_storage = dest->begin + VECTOR_CAPACITY(src);
+
+	memcpy(dest->begin, src->begin, VECTOR_SIZE(src) * sizeof(SampleType));
+
+	vector_assert(dest);
+}
+/* Macro VECTOR_DEFINE_DUPLICATE_LINKAGE stop here */
+#endif
+
+/* Macro VECTOR_DECLARE_SERIAL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Linkage_=SampleLinkage) start here */
+SampleLinkage size_t vector_serialized_size(const Vector *vec);
+SampleLinkage int vector_save(const Vector *vec, FILE *stream);
+SampleLinkage int vector_load(Vector *vec, FILE *stream);
+SampleLinkage int vector_save_buffer(const Vector *vec, void *buffer,
+				     size_t buffer_size);
+SampleLinkage int vector_span_save(VectorSpan span, FILE *stream);
+SampleLinkage int vector_span_save_buffer(VectorSpan span, void *buffer,
+					  size_t buffer_size);
+SampleLinkage int vector_load_buffer(Vector *vec, const void *buffer,
+				     size_t buffer_size);
+/* Macro VECTOR_DECLARE_SERIAL_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_SERIAL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage size_t vector_serialized_size(const Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_serialized_size but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	return VECTOR_SERIAL_HEADER_SIZE
+	       + VECTOR_SIZE(vec) * sizeof(SampleType);
+}
+
+SampleLinkage int vector_save(const Vector *vec, FILE *stream)
+{
+	if (VECTOR_CHECK(vec == NULL || stream == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_save but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	return vector_span_save(vector_span(vec), stream);
+}
+
+SampleLinkage int vector_span_save(VectorSpan span, FILE *stream)
+{
+	unsigned char header[VECTOR_SERIAL_HEADER_SIZE];
+	unsigned long checksum = 0;
+
+	if (VECTOR_CHECK(stream == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_span_save but non-null argument expected.");
+	}
+
+	checksum = vector_core_checksum(
+		span.begin, VECTOR_SIZE(&span) * sizeof(SampleType));
+	if (!vector_core_serial_header(header, sizeof(SampleType),
+				       VECTOR_SIZE(&span), checksum)) {
+		return 0;
+	}
+
+	if (fwrite(header, 1, sizeof(header), stream) != sizeof(header)) {
+		return 0;
+	}
+	return VECTOR_IS_SIZE_ZERO(&span)
+	       || fwrite(span.begin, sizeof(SampleType), VECTOR_SIZE(&span),
+			 stream)
+			  == VECTOR_SIZE(&span);
+}
+
+/* Grows vec to capacity elements for vector_load, failing instead of
+ * panicking when out of memory */
+static int vector_load_grow(Vector *vec, size_t capacity)
+{
+	size_t size = VECTOR_SIZE(vec);
+	SampleType *new_begin = NULL;
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	new_begin = VECTOR_REALLOC(vec->begin, capacity * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(new_begin == NULL)) {
+		return 0;
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_load", VECTOR_CAPACITY(vec),
+			   capacity, capacity * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, VECTOR_CAPACITY(vec), size, capacity,
+		       size);
+
+	vec->begin = new_begin;
+	vec->end = new_begin + size;
+	vec->end_of_storage = new_begin + capacity;
+	return 1;
+}
+
+SampleLinkage int vector_load(Vector *vec, FILE *stream)
+{
+	unsigned char header[VECTOR_SERIAL_HEADER_SIZE];
+	size_t count = 0;
+	size_t size = 0;
+	size_t step = 0;
+	size_t chunk = VECTOR_SERIAL_CHUNK_BYTES / sizeof(SampleType);
+	unsigned long checksum = 0;
+
+	if (VECTOR_CHECK(vec == NULL || stream == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_load but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (fread(header, 1, sizeof(header), stream) != sizeof(header)
+	    || !vector_core_serial_parse(header, sizeof(SampleType), &count,
+					 &checksum)) {
+		vector_clear(vec);
+		return 0;
+	}
+
+	vector_clear(vec);
+	if (chunk == 0) {
+		chunk = 1;
+	}
+	while (VECTOR_SIZE(vec) < count) {
+		size = VECTOR_SIZE(vec);
+		if (size == VECTOR_CAPACITY(vec)) {
+			step = size > chunk ? size : chunk;
+			step = count - size > step ? step : count - size;
+			if (!vector_load_grow(vec, size + step)) {
+				vector_clear(vec);
+				return 0;
+			}
+		}
+
+		step = (VECTOR_CAPACITY(vec) < count ? VECTOR_CAPACITY(vec)
+						     : count)
+		       - size;
+		vector_resize(vec, size + step);
+		if (fread(vec->begin + size, sizeof(SampleType), step, stream)
+		    != step) {
+			vector_clear(vec);
+			return 0;
+		}
+	}
+
+	if (vector_core_checksum(vec->begin, count * sizeof(SampleType))
+	    != checksum) {
+		vector_clear(vec);
+		return 0;
+	}
+	return 1;
+}
+
+SampleLinkage int vector_save_buffer(const Vector *vec, void *buffer,
+				     size_t buffer_size)
+{
+	if (VECTOR_CHECK(vec == NULL || buffer == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_save_buffer but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	return vector_span_save_buffer(vector_span(vec), buffer, buffer_size);
+}
+
+SampleLinkage int vector_span_save_buffer(VectorSpan span, void *buffer,
+					  size_t buffer_size)
+{
+	unsigned char *header = (unsigned char *)buffer;
+	unsigned long checksum = 0;
+
+	if (VECTOR_CHECK(buffer == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_span_save_buffer but non-null argument expected.");
+	}
+
+	if (buffer_size < VECTOR_SERIAL_HEADER_SIZE
+	    || (buffer_size - VECTOR_SERIAL_HEADER_SIZE) / sizeof(SampleType)
+		       < VECTOR_SIZE(&span)) {
+		return 0;
+	}
+	checksum = vector_core_checksum(
+		span.begin, VECTOR_SIZE(&span) * sizeof(SampleType));
+	if (!vector_core_serial_header(header, sizeof(SampleType),
+				       VECTOR_SIZE(&span), checksum)) {
+		return 0;
+	}
+
+	if (!VECTOR_IS_SIZE_ZERO(&span)) {
+		memcpy(header + VECTOR_SERIAL_HEADER_SIZE, span.begin,
+		       VECTOR_SIZE(&span) * sizeof(SampleType));
+	}
+	return 1;
+}
+
+SampleLinkage int vector_load_buffer(Vector *vec, const void *buffer,
+				     size_t buffer_size)
+{
+	const unsigned char *header = (const unsigned char *)buffer;
+	size_t count = 0;
+	unsigned long checksum = 0;
+
+	if (VECTOR_CHECK(vec == NULL || buffer == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_load_buffer but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	if (buffer_size < VECTOR_SERIAL_HEADER_SIZE
+	    || !vector_core_serial_parse(header, sizeof(SampleType), &count,
+					 &checksum)
+	    || count > (buffer_size - VECTOR_SERIAL_HEADER_SIZE)
+			       / sizeof(SampleType)
+	    || vector_core_checksum(header + VECTOR_SERIAL_HEADER_SIZE,
+				    count * sizeof(SampleType))
+		       != checksum) {
+		vector_clear(vec);
+		return 0;
+	}
+
+	vector_resize(vec, count);
+	if (VECTOR_SIZE(vec) != count) {
+		vector_clear(vec);
+		return 0;
+	}
+	if (count) {
+		memcpy(vec->begin, header + VECTOR_SERIAL_HEADER_SIZE,
+		       count * sizeof(SampleType));
+	}
+	return 1;
+}
+/* Macro VECTOR_DEFINE_SERIAL_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_VIEW_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+typedef struct VectorView {
+	const SampleType *begin;
+	const SampleType *end;
+	const void *mapping;
+	size_t mapping_size;
+	unsigned long checksum;
+} VectorView;
+
+SampleLinkage int vector_view_init(VectorView *view, const void *buffer,
+				   size_t buffer_size);
+SampleLinkage int vector_view_open(VectorView *view, const char *path);
+SampleLinkage void vector_view_close(VectorView *view);
+SampleLinkage SampleType vector_view_get(const VectorView *view, size_t idx);
+SampleLinkage int vector_view_verify(const VectorView *view);
+/* Macro VECTOR_DECLARE_VIEW_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_VIEW_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage int vector_view_init(VectorView *view, const void *buffer,
+				   size_t buffer_size)
+{
+	/* The alignment of SampleType is the offset of a member after a char */
+	struct vector_view_layout {
+		char first;
+		SampleType value;
+	};
+	const unsigned char *header = (const unsigned char *)buffer;
+	size_t count = 0;
+	unsigned long checksum = 0;
+
+	if (VECTOR_CHECK(view == NULL || buffer == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_view_init but non-null argument expected.");
+	}
+
+	memset(view, 0, sizeof(*view));
+	if (buffer_size < VECTOR_SERIAL_HEADER_SIZE
+	    || !vector_core_serial_parse(header, sizeof(SampleType), &count,
+					 &checksum)
+	    || count > (buffer_size - VECTOR_SERIAL_HEADER_SIZE)
+			       / sizeof(SampleType)
+	    || (size_t)(header + VECTOR_SERIAL_HEADER_SIZE)
+			       % offsetof(struct vector_view_layout, value)
+		       != 0) {
+		return 0;
+	}
+
+	view->begin =
+		(const SampleType *)(header + VECTOR_SERIAL_HEADER_SIZE);
+	view->end = view->begin + count;
+	view->checksum = checksum;
+	return 1;
+}
+
+SampleLinkage int vector_view_open(VectorView *view, const char *path)
+{
+	const void *mapping = NULL;
+	size_t mapping_size = 0;
+
+	if (VECTOR_CHECK(view == NULL || path == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_view_open but non-null argument expected.");
+	}
+
+	memset(view, 0, sizeof(*view));
+	mapping = vector_core_map(path, &mapping_size);
+	if (mapping == NULL) {
+		return 0;
+	}
+	if (!vector_view_init(view, mapping, mapping_size)) {
+		vector_core_unmap(mapping, mapping_size);
+		return 0;
+	}
+
+	view->mapping = mapping;
+	view->mapping_size = mapping_size;
+	return 1;
+}
+
+SampleLinkage void vector_view_close(VectorView *view)
+{
+	if (VECTOR_CHECK(view == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_view_close but non-null argument expected.");
+	}
+
+	if (view->mapping) {
+		vector_core_unmap(view->mapping, view->mapping_size);
+	}
+	memset(view, 0, sizeof(*view));
+}
+
+SampleLinkage SampleType vector_view_get(const VectorView *view, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(view == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_view_get but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(view))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		vector_panic("Out of range.");
+	}
+
+	return view->begin[idx];
+}
+
+SampleLinkage int vector_view_verify(const VectorView *view)
+{
+	if (VECTOR_CHECK(view == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_view_verify but non-null argument expected.");
+	}
+
+	return vector_core_checksum(view->begin,
+				    VECTOR_SIZE(view) * sizeof(SampleType))
+	       == view->checksum;
+}
+/* Macro VECTOR_DEFINE_VIEW_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_FILE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+typedef struct VectorFile {
+	SampleType *begin;
+	SampleType *end;
+	SampleType *end_of_storage;
+	unsigned char *mapping;
+	int fd;
+} VectorFile;
+
+SampleLinkage int vector_file_open(VectorFile *vec, const char *path);
+SampleLinkage int vector_file_sync(VectorFile *vec);
+SampleLinkage int vector_file_close(VectorFile *vec);
+SampleLinkage void vector_file_grow(VectorFile *vec, size_t element_count);
+SampleLinkage void vector_file_resize(VectorFile *vec, size_t element_count);
+SampleLinkage void vector_file_push(VectorFile *vec, SampleType value);
+SampleLinkage SampleType vector_file_pop(VectorFile *vec);
+SampleLinkage SampleType vector_file_get(const VectorFile *vec, size_t idx);
+SampleLinkage void vector_file_set(VectorFile *vec, size_t idx,
+				   SampleType value);
+SampleLinkage void vector_file_clear(VectorFile *vec);
+/* Macro VECTOR_DECLARE_FILE_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_FILE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+static size_t vector_file_bytes(const VectorFile *vec)
+{
+	return VECTOR_SERIAL_HEADER_SIZE
+	       + VECTOR_CAPACITY(vec) * sizeof(SampleType);
+}
+
+SampleLinkage int vector_file_open(VectorFile *vec, const char *path)
+{
+	size_t count = 0;
+	size_t capacity = 0;
+
+	if (VECTOR_CHECK(vec == NULL || path == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_file_open but non-null argument expected.");
+	}
+
+	memset(vec, 0, sizeof(*vec));
+	vec->mapping = vector_core_file_open(path, sizeof(SampleType), &vec->fd,
+					     &count, &capacity);
+	if (vec->mapping == NULL) {
+		vec->fd = -1;
+		return 0;
+	}
+
+	vec->begin = (SampleType *)(vec->mapping + VECTOR_SERIAL_HEADER_SIZE);
+	vec->end = vec->begin + count;
+	vec->end_of_storage = vec->begin + capacity;
+	return 1;
+}
+
+SampleLinkage int vector_file_sync(VectorFile *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_file_sync but non-null argument expected.");
+	}
+
+	return vec->mapping
+	       && vector_core_file_sync(vec->mapping, vector_file_bytes(vec),
+					sizeof(SampleType), VECTOR_SIZE(vec),
+					0);
+}
+
+SampleLinkage int vector_file_close(VectorFile *vec)
+{
+	int closed = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_file_close but non-null argument expected.");
+	}
+
+	if (vec->mapping == NULL) {
+		return 0;
+	}
+
+	closed = vector_core_file_sync(vec->mapping, vector_file_bytes(vec),
+				       sizeof(SampleType), VECTOR_SIZE(vec), 1);
+	closed &= vector_core_file_close(vec->fd, vec->mapping,
+					 vector_file_bytes(vec));
+	memset(vec, 0, sizeof(*vec));
+	vec->fd = -1;
+	return closed;
+}
+
+SampleLinkage void vector_file_grow(VectorFile *vec, size_t element_count)
+{
+	unsigned char *mapping = NULL;
+	size_t old_size = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_file_grow but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(vec->mapping == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic("VectorFile used before vector_file_open.");
+	}
+
+	if (VECTOR_UNLIKELY(element_count
+			    > (((size_t)-1) - VECTOR_SERIAL_HEADER_SIZE)
+				      / sizeof(SampleType))) {
+		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+			return;
+		}
+		vector_panic("Requested capacity would cause size overflow.");
+	}
+
+	if (VECTOR_CAPACITY(vec) == element_count) {
+		return;
+	}
+	if (VECTOR_CAPACITY(vec) > element_count) {
+		vector_panic("Vector shrinking not supported.");
+	}
+
+	old_size = VECTOR_SIZE(vec);
+	mapping = vector_core_file_resize(
+		vec->fd, vec->mapping, vector_file_bytes(vec),
+		VECTOR_SERIAL_HEADER_SIZE + element_count * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(mapping == NULL)) {
+		vector_panic("Cannot grow the file mapping.");
+	}
+
+	vec->mapping = mapping;
+	vec->begin = (SampleType *)(mapping + VECTOR_SERIAL_HEADER_SIZE);
+	vec->end = vec->begin + old_size;
+	vec->end_of_storage = vec->begin + element_count;
+}
+
+SampleLinkage void vector_file_resize(VectorFile *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_file_resize but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(vec->mapping == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic("VectorFile used before vector_file_open.");
+	}
+
+	if (element_count > VECTOR_CAPACITY(vec)) {
+		vector_file_grow(vec, element_count);
+		if (element_count > VECTOR_CAPACITY(vec)) {
+			return;
+		}
+	}
+
+	vec->end = vec->begin + element_count;
+}
+
+SampleLinkage void vector_file_push(VectorFile *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_file_push but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(vec->mapping == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic("VectorFile used before vector_file_open.");
+	}
+
+	if (VECTOR_UNLIKELY(vec->end == vec->end_of_storage)) {
+		vector_file_grow(vec, VECTOR_CAPACITY(vec)
+					      ? VECTOR_CAPACITY(vec)
+							* VECTOR_GROWTH_FACTOR
+					      : VECTOR_DEFAULT_CAPACITY);
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+}
+
+SampleLinkage SampleType vector_file_pop(VectorFile *vec)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_file_pop but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(vec))) {
+		vector_panic("Cannot pop from empty vector.");
+	}
+
+	vec->end--;
+	return vec->end[0];
+}
+
+SampleLinkage SampleType vector_file_get(const VectorFile *vec, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_file_get but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		vector_panic("Out of range.");
+	}
+
+	return vec->begin[idx];
+}
+
+SampleLinkage void vector_file_set(VectorFile *vec, size_t idx,
+				   SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_file_set but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	vec->begin[idx] = value;
+}
+
+SampleLinkage void vector_file_clear(VectorFile *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_file_clear but non-null argument expected.");
+	}
+
+	vec->end = vec->begin;
+}
+/* Macro VECTOR_DEFINE_FILE_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_SPILL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+typedef struct VectorSpill {
+	VectorCoreSpill core;
+} VectorSpill;
+
+SampleLinkage int vector_spill_init(VectorSpill *vec, size_t budget_bytes);
+SampleLinkage void vector_spill_free(VectorSpill *vec);
+SampleLinkage size_t vector_spill_size(const VectorSpill *vec);
+SampleLinkage void vector_spill_push(VectorSpill *vec, SampleType value);
+SampleLinkage SampleType vector_spill_pop(VectorSpill *vec);
+SampleLinkage SampleType vector_spill_get(VectorSpill *vec, size_t idx);
+SampleLinkage void vector_spill_set(VectorSpill *vec, size_t idx,
+				    SampleType value);
+SampleLinkage const SampleType *vector_spill_span(VectorSpill *vec, size_t idx,
+						  size_t *count);
+/* Macro VECTOR_DECLARE_SPILL_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_SPILL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+static SampleType *vector_spill_at(VectorSpill *vec, size_t idx, int dirty)
+{
+	unsigned char *element = vector_core_spill_at(&vec->core, idx, dirty);
+
+	if (VECTOR_UNLIKELY(element == NULL)) {
+		vector_panic("Cannot access the spill file.");
+	}
+	return (SampleType *)(void *)element;
+}
+
+SampleLinkage int vector_spill_init(VectorSpill *vec, size_t budget_bytes)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_spill_init but non-null argument expected.");
+	}
+
+	return vector_core_spill_init(&vec->core, sizeof(SampleType),
+				      budget_bytes);
+}
+
+SampleLinkage void vector_spill_free(VectorSpill *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_spill_free but non-null argument expected.");
+	}
+
+	vector_core_spill_free(&vec->core);
+}
+
+SampleLinkage size_t vector_spill_size(const VectorSpill *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_spill_size but non-null argument expected.");
+	}
+
+	return vec->core.size;
+}
+
+SampleLinkage void vector_spill_push(VectorSpill *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_spill_push but non-null argument expected.");
+	}
+
+	*vector_spill_at(vec, vec->core.size, 1) = value;
+	vec->core.size++;
+}
+
+SampleLinkage SampleType vector_spill_pop(VectorSpill *vec)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_spill_pop but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(vec->core.size == 0)) {
+		vector_panic("Cannot pop from empty vector.");
+	}
+
+	vec->core.size--;
+	return *vector_spill_at(vec, vec->core.size, 0);
+}
+
+SampleLinkage SampleType vector_spill_get(VectorSpill *vec, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_spill_get but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= vec->core.size)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		vector_panic("Out of range.");
+	}
+
+	return *vector_spill_at(vec, idx, 0);
+}
+
+SampleLinkage void vector_spill_set(VectorSpill *vec, size_t idx,
+				    SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_spill_set but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= vec->core.size)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		vector_panic("Out of range.");
+	}
+
+	*vector_spill_at(vec, idx, 1) = value;
+}
+
+SampleLinkage const SampleType *vector_spill_span(VectorSpill *vec, size_t idx,
+						  size_t *count)
+{
+	size_t block_left = 0;
+
+	if (VECTOR_CHECK(vec == NULL || count == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return NULL;
+		}
+		vector_panic(
+			"Null passed to vector_spill_span but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(idx >= vec->core.size)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			*count = 0;
+			return NULL;
+		}
+		vector_panic("Out of range.");
+	}
+
+	block_left = vec->core.block_elements - idx % vec->core.block_elements;
+	*count = vec->core.size - idx < block_left ? vec->core.size - idx
+						   : block_left;
+	return vector_spill_at(vec, idx, 0);
+}
+/* Macro VECTOR_DEFINE_SPILL_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_SORT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_sort(Vector *vec);
+SampleLinkage int vector_is_sorted(const Vector *vec);
+SampleLinkage void vector_span_sort(VectorSpan span);
+SampleLinkage int vector_span_is_sorted(VectorSpan span);
+SampleLinkage void vector_parallel_sort(Vector *vec);
+SampleLinkage void vector_span_parallel_sort(VectorSpan span,
+					     VectorSpan scratch);
+SampleLinkage int vector_sort_file(const char *input_path,
+				   const char *output_path,
+				   size_t budget_bytes);
+/* Macro VECTOR_DECLARE_SORT_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_SORT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Less_=SampleLess, Linkage_=SampleLinkage) start here */
+static void vector_sort_insertion(SampleType *begin, size_t size)
+{
+	SampleType value;
+	size_t i = 0;
+	size_t j = 0;
+
+	for (i = 1; i < size; i++) {
+		value = begin[i];
+		for (j = i; j > 0 && SampleLess(value, begin[j - 1]); j--) {
+			begin[j] = begin[j - 1];
+		}
+		begin[j] = value;
+	}
+}
+
+static void vector_sort_sift(SampleType *begin, size_t root, size_t size)
+{
+	SampleType value = begin[root];
+	size_t child = 0;
+
+	while ((child = 2 * root + 1) < size) {
+		if (child + 1 < size
+		    && SampleLess(begin[child], begin[child + 1])) {
+			child++;
+		}
+		if (!SampleLess(value, begin[child])) {
+			break;
+		}
+		begin[root] = begin[child];
+		root = child;
+	}
+	begin[root] = value;
+}
+
+static void vector_sort_heap(SampleType *begin, size_t size)
+{
+	SampleType value;
+	size_t i = size / 2;
+
+	while (i-- > 0) {
+		vector_sort_sift(begin, i, size);
+	}
+	while (size-- > 1) {
+		value = begin[0];
+		begin[0] = begin[size];
+		begin[size] = value;
+		vector_sort_sift(begin, 0, size);
+	}
+}
+
+/* Introsort: quicksort with a median of three pivot, falling back to
+ * heapsort past depth, and leaving ranges below VECTOR_SORT_INSERTION_SIZE to
+ * a final insertion sort */
+static void vector_sort_intro(SampleType *begin, size_t size, size_t depth)
+{
+	SampleType pivot;
+	SampleType value;
+	size_t i = 0;
+	size_t j = 0;
+
+	while (size > VECTOR_SORT_INSERTION_SIZE) {
+		if (depth-- == 0) {
+			vector_sort_heap(begin, size);
+			return;
+		}
+
+		if (SampleLess(begin[size / 2], begin[0])) {
+			value = begin[0];
+			begin[0] = begin[size / 2];
+			begin[size / 2] = value;
+		}
+		if (SampleLess(begin[size - 1], begin[size / 2])) {
+			value = begin[size - 1];
+			begin[size - 1] = begin[size / 2];
+			begin[size / 2] = value;
+			if (SampleLess(begin[size / 2], begin[0])) {
+				value = begin[0];
+				begin[0] = begin[size / 2];
+				begin[size / 2] = value;
+			}
+		}
+		pivot = begin[size / 2];
+
+		/* Hoare partition: [0, j] <= pivot <= [j + 1, size) */
+		i = 0;
+		j = size - 1;
+		for (;;) {
+			while (SampleLess(begin[i], pivot)) {
+				i++;
+			}
+			while (SampleLess(pivot, begin[j])) {
+				j--;
+			}
+			if (i >= j) {
+				break;
+			}
+			value = begin[i];
+			begin[i] = begin[j];
+			begin[j] = value;
+			i++;
+			j--;
+		}
+
+		/* Recurse into the smaller side to bound the stack */
+		if (j + 1 < size - j - 1) {
+			vector_sort_intro(begin, j + 1, depth);
+			begin += j + 1;
+			size -= j + 1;
+		} else {
+			vector_sort_intro(begin + j + 1, size - j - 1, depth);
+			size = j + 1;
+		}
+	}
+}
+
+static void vector_sort_range(SampleType *begin, size_t size)
+{
+	size_t depth = 0;
+	size_t i = 0;
+
+	for (i = size; i > 1; i >>= 1) {
+		depth += 2;
+	}
+	vector_sort_intro(begin, size, depth);
+	vector_sort_insertion(begin, size);
+}
+
+SampleLinkage void vector_sort(Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_sort but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	vector_sort_range(vec->begin, VECTOR_SIZE(vec));
+}
+
+SampleLinkage void vector_span_sort(VectorSpan span)
+{
+	vector_sort_range(span.begin, VECTOR_SIZE(&span));
+}
+
+SampleLinkage int vector_is_sorted(const Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_is_sorted but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	return vector_span_is_sorted(vector_span(vec));
+}
+
+SampleLinkage int vector_span_is_sorted(VectorSpan span)
+{
+	const SampleType *i = NULL;
+
+	for (i = span.begin; i + 1 < span.end; i++) {
+		if (SampleLess(i[1], i[0])) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Arguments of a level of the parallel merge sort, merging pairs of sorted
+ * runs of width elements from src into dest */
+typedef struct VectorSortJob {
+	SampleType *src;
+	SampleType *dest;
+	size_t size;
+	size_t width;
+} VectorSortJob;
+
+static void vector_sort_block_task(void *job, size_t chunk, size_t begin,
+				   size_t end)
+{
+	VectorSortJob *args = (VectorSortJob *)job;
+
+	(void)chunk;
+	vector_sort_range(args->src + begin, end - begin);
+}
+
+/* Number of elements of a among the first count of the merge of a and b,
+ * ties going to a (merge path) */
+static size_t vector_sort_corank(const SampleType *a, size_t a_size,
+				 const SampleType *b, size_t b_size,
+				 size_t count)
+{
+	size_t low = count > b_size ? count - b_size : 0;
+	size_t high = count < a_size ? count : a_size;
+	size_t mid = 0;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		if (!SampleLess(b[count - mid - 1], a[mid])) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low;
+}
+
+/* Writes elements [begin, end) of dest, which may span several merges: each
+ * part is located in both runs by its corank, so threads split merges too */
+static void vector_sort_merge_task(void *job, size_t chunk, size_t begin,
+				   size_t end)
+{
+	VectorSortJob *args = (VectorSortJob *)job;
+	const SampleType *a = NULL;
+	const SampleType *a_end = NULL;
+	const SampleType *b = NULL;
+	const SampleType *b_end = NULL;
+	SampleType *out = NULL;
+	size_t first = 0;
+	size_t middle = 0;
+	size_t last = 0;
+	size_t stop = 0;
+	size_t a_begin = 0;
+	size_t a_stop = 0;
+
+	(void)chunk;
+	while (begin < end) {
+		first = begin - begin % (2 * args->width);
+		middle = args->size - first > args->width ? first + args->width
+							  : args->size;
+		last = args->size - middle > args->width ? middle + args->width
+							 : args->size;
+		stop = end < last ? end : last;
+
+		a_begin = vector_sort_corank(args->src + first, middle - first,
+					     args->src + middle, last - middle,
+					     begin - first);
+		a_stop = vector_sort_corank(args->src + first, middle - first,
+					    args->src + middle, last - middle,
+					    stop - first);
+		a = args->src + first + a_begin;
+		a_end = args->src + first + a_stop;
+		b = args->src + middle + (begin - first - a_begin);
+		b_end = args->src + middle + (stop - first - a_stop);
+
+		out = args->dest + begin;
+		while (a < a_end && b < b_end) {
+			*out++ = SampleLess(*b, *a) ? *b++ : *a++;
+		}
+		memcpy(out, a, (size_t)(a_end - a) * sizeof(SampleType));
+		out += a_end - a;
+		memcpy(out, b, (size_t)(b_end - b) * sizeof(SampleType));
+		begin = stop;
+	}
+}
+
+static void vector_sort_copy_task(void *job, size_t chunk, size_t begin,
+				  size_t end)
+{
+	VectorSortJob *args = (VectorSortJob *)job;
+
+	(void)chunk;
+	memcpy(args->dest + begin, args->src + begin,
+	       (end - begin) * sizeof(SampleType));
+}
+
+SampleLinkage void vector_parallel_sort(Vector *vec)
+{
+	VectorSpan scratch = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_sort but non-null argument expected.");
+	}
+	vector_assert(vec);
+
+	vector_span_parallel_sort(vector_span(vec), scratch);
+}
+
+SampleLinkage void vector_span_parallel_sort(VectorSpan span,
+					     VectorSpan scratch)
+{
+	VectorSortJob job;
+	SampleType *allocated = NULL;
+	SampleType *swap = NULL;
+	size_t size = VECTOR_SIZE(&span);
+	size_t threads = vector_core_parallel_threads();
+	size_t grain = VECTOR_PARALLEL_GRAIN(sizeof(SampleType));
+
+	/* Four blocks per thread leave some to steal */
+	if (size == 0) {
+		return;
+	}
+	job.width = (size - 1) / (4 * threads) + 1;
+	if (job.width < grain) {
+		job.width = grain;
+	}
+	if (threads == 1 || job.width >= size) {
+		vector_sort_range(span.begin, size);
+		return;
+	}
+
+	if (VECTOR_SIZE(&scratch) < size) {
+		if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+			vector_panic("Allocation inside a no-alloc region.");
+		}
+		allocated = (SampleType *)VECTOR_REALLOC(
+			NULL, size * sizeof(SampleType));
+		if (allocated == NULL) {
+			vector_sort_range(span.begin, size);
+			return;
+		}
+		scratch.begin = allocated;
+	}
+
+	job.src = span.begin;
+	job.dest = scratch.begin;
+	job.size = size;
+	vector_core_parallel_run(size, job.width, vector_sort_block_task, &job);
+	for (; job.width < size; job.width *= 2) {
+		vector_core_parallel_run(size, grain, vector_sort_merge_task,
+					 &job);
+		swap = job.src;
+		job.src = job.dest;
+		job.dest = swap;
+	}
+	if (job.src != span.begin) {
+		job.dest = span.begin;
+		vector_core_parallel_run(size, grain, vector_sort_copy_task,
+					 &job);
+	}
+
+	VECTOR_FREE(allocated);
+}
+
+/* Whether run a wins over run b in the loser tree. run_count is the
+ * sentinel winning every match while the tree is built, exhausted runs lose
+ * every match */
+static int vector_sort_wins(const VectorCoreRun *runs, const SampleType *heads,
+			    size_t buffer_elements, size_t run_count, size_t a,
+			    size_t b)
+{
+	if (a == run_count || b == run_count) {
+		return a == run_count;
+	}
+	if (runs[a].pos == runs[a].len || runs[b].pos == runs[b].len) {
+		return runs[b].pos == runs[b].len;
+	}
+	return !SampleLess(heads[b * buffer_elements + runs[b].pos],
+			   heads[a * buffer_elements + runs[a].pos]);
+}
+
+/* Replay the matches from the leaf of run winner up to the root, leaving
+ * the loser of each match in its node and the overall winner in tree[0] */
+static void vector_sort_adjust(size_t *tree, const VectorCoreRun *runs,
+			       const SampleType *heads, size_t buffer_elements,
+			       size_t run_count, size_t winner)
+{
+	size_t node = (winner + run_count) / 2;
+	size_t loser = 0;
+
+	for (; node > 0; node /= 2) {
+		if (vector_sort_wins(runs, heads, buffer_elements, run_count,
+				     tree[node], winner)) {
+			loser = winner;
+			winner = tree[node];
+			tree[node] = loser;
+		}
+	}
+	tree[0] = winner;
+}
+
+/* Sort every run_elements elements of input into runs_file, checking the
+ * checksum of the whole input */
+static int vector_sort_runs(FILE *input, FILE *runs_file, Vector *chunk,
+			    size_t count, size_t run_elements,
+			    unsigned long checksum)
+{
+	unsigned long hash = VECTOR_CHECKSUM_INIT;
+	size_t done = 0;
+	size_t size = 0;
+
+	for (done = 0; done < count; done += size) {
+		size = count - done;
+		if (size > run_elements) {
+			size = run_elements;
+		}
+		vector_resize(chunk, size);
+		if (VECTOR_SIZE(chunk) != size
+		    || fread(chunk->begin, sizeof(SampleType), size, input)
+			       != size) {
+			return 0;
+		}
+		hash = vector_core_checksum_update(hash, chunk->begin,
+						   size * sizeof(SampleType));
+
+		vector_sort_range(chunk->begin, size);
+		if (fwrite(chunk->begin, sizeof(SampleType), size, runs_file)
+		    != size) {
+			return 0;
+		}
+	}
+	return hash == checksum;
+}
+
+/* k-way merge of the runs through a loser tree. chunk is split in one
+ * buffer per run plus one for the output, each read or written whole */
+static int vector_sort_merge(FILE *runs_file, FILE *output, Vector *chunk,
+			     size_t count, size_t run_elements,
+			     unsigned long *checksum)
+{
+	size_t run_count = (count + run_elements - 1) / run_elements;
+	size_t buffer_elements = run_elements / (run_count + 1);
+	VectorCoreRun *runs = NULL;
+	size_t *tree = NULL;
+	SampleType *out = NULL;
+	size_t out_size = 0;
+	size_t done = 0;
+	size_t run = 0;
+	int merged = 1;
+
+	if (count == 0) {
+		return 1;
+	}
+	if (buffer_elements == 0) {
+		buffer_elements = 1;
+	}
+
+	vector_resize(chunk, (run_count + 1) * buffer_elements);
+	if (VECTOR_SIZE(chunk) != (run_count + 1) * buffer_elements) {
+		return 0;
+	}
+	out = chunk->begin + run_count * buffer_elements;
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	runs = (VectorCoreRun *)VECTOR_REALLOC(NULL,
+					       run_count * sizeof(*runs));
+	tree = (size_t *)VECTOR_REALLOC(NULL, run_count * sizeof(*tree));
+	if (runs == NULL || tree == NULL) {
+		VECTOR_FREE(runs);
+		VECTOR_FREE(tree);
+		return 0;
+	}
+
+	for (run = 0; run < run_count; run++) {
+		runs[run].next = run * run_elements;
+		runs[run].end = count - runs[run].next < run_elements
+					? count
+					: runs[run].next + run_elements;
+		merged &= vector_core_run_refill(
+			runs_file, &runs[run],
+			chunk->begin + run * buffer_elements, buffer_elements,
+			sizeof(SampleType));
+		tree[run] = run_count;
+	}
+	for (run = run_count; run-- > 0;) {
+		vector_sort_adjust(tree, runs, chunk->begin, buffer_elements,
+				   run_count, run);
+	}
+
+	for (done = 0; merged && done < count; done++) {
+		run = tree[0];
+		out[out_size++] =
+			chunk->begin[run * buffer_elements + runs[run].pos++];
+		if (runs[run].pos == runs[run].len) {
+			merged = vector_core_run_refill(
+				runs_file, &runs[run],
+				chunk->begin + run * buffer_elements,
+				buffer_elements, sizeof(SampleType));
+		}
+
+		if (out_size == buffer_elements || done + 1 == count) {
+			*checksum = vector_core_checksum_update(
+				*checksum, out, out_size * sizeof(SampleType));
+			merged = merged
+				 && fwrite(out, sizeof(SampleType), out_size,
+					   output)
+					    == out_size;
+			out_size = 0;
+		}
+		vector_sort_adjust(tree, runs, chunk->begin, buffer_elements,
+				   run_count, run);
+	}
+
+	VECTOR_FREE(runs);
+	VECTOR_FREE(tree);
+	return merged;
+}
+
+SampleLinkage int vector_sort_file(const char *input_path,
+				   const char *output_path, size_t budget_bytes)
+{
+	unsigned char header[VECTOR_SERIAL_HEADER_SIZE];
+	Vector chunk = { 0 };
+	FILE *input = NULL;
+	FILE *runs_file = NULL;
+	FILE *output = NULL;
+	char *temp_path = NULL;
+	size_t count = 0;
+	size_t run_elements = budget_bytes / sizeof(SampleType);
+	unsigned long checksum = 0;
+	int sorted = 0;
+
+	if (VECTOR_CHECK(input_path == NULL || output_path == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_sort_file but non-null argument expected.");
+	}
+
+	if (run_elements == 0) {
+		run_elements = 1;
+	}
+
+	input = fopen(input_path, "rb");
+	if (input == NULL) {
+		return 0;
+	}
+	runs_file = tmpfile();
+	sorted = runs_file
+		 && fread(header, 1, sizeof(header), input) == sizeof(header)
+		 && vector_core_serial_parse(header, sizeof(SampleType), &count,
+					     &checksum)
+		 && vector_sort_runs(input, runs_file, &chunk, count,
+				     run_elements, checksum);
+	(void)fclose(input);
+
+	/* The output is complete before it replaces output_path, so
+	 * output_path may be input_path and a failure leaves both untouched */
+	if (sorted) {
+		temp_path = vector_core_temp_path(output_path);
+		output = temp_path ? fopen(temp_path, "wb") : NULL;
+		checksum = VECTOR_CHECKSUM_INIT;
+		sorted = output
+			 && fwrite(header, 1, sizeof(header), output)
+				    == sizeof(header)
+			 && vector_sort_merge(runs_file, output, &chunk, count,
+					      run_elements, &checksum)
+			 && vector_core_serial_header(header,
+						      sizeof(SampleType), count,
+						      checksum)
+			 && fseek(output, 0, SEEK_SET) == 0
+			 && fwrite(header, 1, sizeof(header), output)
+				    == sizeof(header);
+		if (output && fclose(output) != 0) {
+			sorted = 0;
+		}
+		if (output && !sorted) {
+			(void)remove(temp_path);
+		}
+		sorted = sorted && vector_core_replace(temp_path, output_path);
+		VECTOR_FREE(temp_path);
+	}
+
+	if (runs_file) {
+		(void)fclose(runs_file);
+	}
+	vector_free(&chunk);
+	return sorted;
+}
+/* Macro VECTOR_DEFINE_SORT_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_CONCURRENT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+/* Each segment is followed by one ready flag per element */
+typedef struct VectorConcurrent {
+	VECTOR_ATOMIC(size_t) size;
+	VECTOR_ATOMIC(SampleType *) segments[VECTOR_CONCURRENT_SEGMENTS];
+} VectorConcurrent;
+
+SampleLinkage void vector_concurrent_init(VectorConcurrent *vec);
+SampleLinkage void vector_concurrent_free(VectorConcurrent *vec);
+SampleLinkage size_t vector_concurrent_push(VectorConcurrent *vec,
+					    SampleType value);
+SampleLinkage size_t vector_concurrent_size(const VectorConcurrent *vec);
+SampleLinkage int vector_concurrent_try_get(const VectorConcurrent *vec,
+					    size_t idx, SampleType *value);
+SampleLinkage SampleType vector_concurrent_get(const VectorConcurrent *vec,
+					       size_t idx);
+/* Macro VECTOR_DECLARE_CONCURRENT_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_CONCURRENT_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_concurrent_init(VectorConcurrent *vec)
+{
+	size_t segment = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_init but non-null argument expected.");
+	}
+
+	VECTOR_ATOMIC_STORE(&vec->size, 0);
+	for (segment = 0; segment < VECTOR_CONCURRENT_SEGMENTS; segment++) {
+		VECTOR_ATOMIC_STORE(&vec->segments[segment], NULL);
+	}
+}
+
+SampleLinkage void vector_concurrent_free(VectorConcurrent *vec)
+{
+	size_t segment = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_free but non-null argument expected.");
+	}
+
+	for (segment = 0; segment < VECTOR_CONCURRENT_SEGMENTS; segment++) {
+		VECTOR_FREE(VECTOR_ATOMIC_LOAD(&vec->segments[segment]));
+	}
+	vector_concurrent_init(vec);
+}
+
+/* Ready flag of the element at offset of segment */
+static VECTOR_ATOMIC(unsigned char) *vector_concurrent_ready(
+	const SampleType *begin, size_t segment, size_t offset)
+{
+	const SampleType *end =
+		begin + ((size_t)VECTOR_CONCURRENT_FIRST_SEGMENT << segment);
+
+	return (VECTOR_ATOMIC(unsigned char) *)end + offset;
+}
+
+/* Allocate segment with its cleared ready flags, unless another push
+ * installed it first */
+static SampleType *vector_concurrent_segment(VectorConcurrent *vec,
+					     size_t segment)
+{
+	size_t count = (size_t)VECTOR_CONCURRENT_FIRST_SEGMENT << segment;
+	SampleType *expected = NULL;
+	SampleType *begin = NULL;
+
+	if (VECTOR_UNLIKELY(sizeof(SampleType) + 1
+			    > (((size_t)-1) >> segment)
+				      / VECTOR_CONCURRENT_FIRST_SEGMENT)) {
+		vector_panic("Requested capacity would cause size overflow.");
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	begin = (SampleType *)VECTOR_REALLOC(
+		NULL, count * (sizeof(SampleType) + 1));
+	if (VECTOR_UNLIKELY(begin == NULL)) {
+		vector_panic("Out of memory.");
+	}
+	memset((void *)vector_concurrent_ready(begin, segment, 0), 0, count);
+
+	if (!VECTOR_ATOMIC_CAS(&vec->segments[segment], &expected, begin)) {
+		VECTOR_FREE(begin);
+		return expected;
+	}
+	return begin;
+}
+
+SampleLinkage size_t vector_concurrent_push(VectorConcurrent *vec,
+					    SampleType value)
+{
+	SampleType *begin = NULL;
+	size_t idx = 0;
+	size_t segment = 0;
+	size_t offset = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_push but non-null argument expected.");
+	}
+
+	idx = VECTOR_ATOMIC_FETCH_ADD(&vec->size, 1);
+	segment = vector_core_concurrent_locate(idx, &offset);
+	begin = VECTOR_ATOMIC_LOAD(&vec->segments[segment]);
+	if (VECTOR_UNLIKELY(begin == NULL)) {
+		begin = vector_concurrent_segment(vec, segment);
+	}
+
+	begin[offset] = value;
+	VECTOR_ATOMIC_STORE(vector_concurrent_ready(begin, segment, offset), 1);
+	return idx;
+}
+
+SampleLinkage size_t vector_concurrent_size(const VectorConcurrent *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_size but non-null argument expected.");
+	}
+
+	return VECTOR_ATOMIC_LOAD(&vec->size);
+}
+
+SampleLinkage int vector_concurrent_try_get(const VectorConcurrent *vec,
+					    size_t idx, SampleType *value)
+{
+	const SampleType *begin = NULL;
+	size_t segment = 0;
+	size_t offset = 0;
+
+	if (VECTOR_CHECK(vec == NULL || value == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_try_get but non-null argument expected.");
+	}
+
+	if (idx >= VECTOR_ATOMIC_LOAD(&vec->size)) {
+		return 0;
+	}
+	segment = vector_core_concurrent_locate(idx, &offset);
+	begin = VECTOR_ATOMIC_LOAD(&vec->segments[segment]);
+	if (begin == NULL
+	    || !VECTOR_ATOMIC_LOAD(
+		    vector_concurrent_ready(begin, segment, offset))) {
+		return 0;
+	}
+
+	*value = begin[offset];
+	return 1;
+}
+
+SampleLinkage SampleType vector_concurrent_get(const VectorConcurrent *vec,
+					       size_t idx)
+{
+	SampleType value = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return value;
+		}
+		vector_panic(
+			"Null passed to vector_concurrent_get but non-null argument expected.");
+	}
+
+	if (VECTOR_CHECK(!vector_concurrent_try_get(vec, idx, &value))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return value;
+		}
+		vector_panic("Out of range.");
+	}
+	return value;
+}
+/* Macro VECTOR_DEFINE_CONCURRENT_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_RCU_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+typedef struct VectorRcu {
+	VectorCoreRcuReader readers[VECTOR_RCU_READERS];
+	VECTOR_ATOMIC(VectorCoreRcuBuffer *) current;
+	VECTOR_ATOMIC(size_t) epoch;
+	VectorCoreRcuBuffer *retired;
+} VectorRcu;
+
+SampleLinkage void vector_rcu_init(VectorRcu *vec);
+SampleLinkage void vector_rcu_free(VectorRcu *vec);
+SampleLinkage void vector_rcu_push(VectorRcu *vec, SampleType value);
+SampleLinkage size_t vector_rcu_size(const VectorRcu *vec);
+SampleLinkage size_t vector_rcu_reclaim(VectorRcu *vec);
+SampleLinkage VectorSpan vector_rcu_read_begin(VectorRcu *vec, size_t reader);
+SampleLinkage void vector_rcu_read_end(VectorRcu *vec, size_t reader);
+/* Macro VECTOR_DECLARE_RCU_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_RCU_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_rcu_init(VectorRcu *vec)
+{
+	size_t reader = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_init but non-null argument expected.");
+	}
+
+	for (reader = 0; reader < VECTOR_RCU_READERS; reader++) {
+		VECTOR_ATOMIC_STORE(&vec->readers[reader].epoch, 0);
+	}
+	VECTOR_ATOMIC_STORE(&vec->current, NULL);
+	VECTOR_ATOMIC_STORE(&vec->epoch, 1);
+	vec->retired = NULL;
+}
+
+static void vector_rcu_release(VectorCoreRcuBuffer *buffer)
+{
+	if (buffer) {
+		VECTOR_FREE(buffer->begin);
+		VECTOR_FREE(buffer);
+	}
+}
+
+SampleLinkage void vector_rcu_free(VectorRcu *vec)
+{
+	VectorCoreRcuBuffer *buffer = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_free but non-null argument expected.");
+	}
+
+	while (vec->retired) {
+		buffer = vec->retired;
+		vec->retired = buffer->next;
+		vector_rcu_release(buffer);
+	}
+	vector_rcu_release(VECTOR_ATOMIC_LOAD(&vec->current));
+	vector_rcu_init(vec);
+}
+
+SampleLinkage size_t vector_rcu_reclaim(VectorRcu *vec)
+{
+	VectorCoreRcuBuffer **link = NULL;
+	VectorCoreRcuBuffer *buffer = NULL;
+	size_t oldest = (size_t)-1;
+	size_t epoch = 0;
+	size_t reader = 0;
+	size_t retired = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_reclaim but non-null argument expected.");
+	}
+
+	for (reader = 0; reader < VECTOR_RCU_READERS; reader++) {
+		epoch = VECTOR_ATOMIC_LOAD(&vec->readers[reader].epoch);
+		if (epoch != 0 && epoch < oldest) {
+			oldest = epoch;
+		}
+	}
+
+	/* Readers which entered after a buffer was retired never saw it */
+	link = &vec->retired;
+	while (*link) {
+		buffer = *link;
+		if (buffer->retired_epoch < oldest) {
+			*link = buffer->next;
+			vector_rcu_release(buffer);
+		} else {
+			link = &buffer->next;
+			retired++;
+		}
+	}
+	return retired;
+}
+
+/* Publish a copy of the elements twice as large, then retire the old
+ * buffer and reclaim those no reader can hold anymore */
+static VectorCoreRcuBuffer *vector_rcu_grow(VectorRcu *vec,
+					    VectorCoreRcuBuffer *old)
+{
+	VectorCoreRcuBuffer *buffer = NULL;
+	size_t capacity = old ? old->capacity * VECTOR_GROWTH_FACTOR
+			      : VECTOR_DEFAULT_CAPACITY;
+	size_t size = old ? VECTOR_ATOMIC_LOAD(&old->size) : 0;
+
+	if (VECTOR_UNLIKELY(capacity < size
+			    || sizeof(SampleType) > ((size_t)-1) / capacity)) {
+		vector_panic("Requested capacity would cause size overflow.");
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+
+	buffer = (VectorCoreRcuBuffer *)VECTOR_REALLOC(NULL, sizeof(*buffer));
+	if (VECTOR_UNLIKELY(buffer == NULL)) {
+		vector_panic("Out of memory.");
+	}
+	buffer->begin = VECTOR_REALLOC(NULL, capacity * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(buffer->begin == NULL)) {
+		VECTOR_FREE(buffer);
+		vector_panic("Out of memory.");
+	}
+	if (size) {
+		memcpy(buffer->begin, old->begin, size * sizeof(SampleType));
+	}
+	VECTOR_ATOMIC_STORE(&buffer->size, size);
+	buffer->capacity = capacity;
+	buffer->retired_epoch = 0;
+	buffer->next = NULL;
+
+	VECTOR_ATOMIC_STORE(&vec->current, buffer);
+	if (old) {
+		/* The fences order the publication before the epoch bump, and
+		 * the bump before scanning the readers in vector_rcu_reclaim */
+		VECTOR_ATOMIC_FENCE();
+		old->retired_epoch = VECTOR_ATOMIC_FETCH_ADD(&vec->epoch, 1);
+		old->next = vec->retired;
+		vec->retired = old;
+		VECTOR_ATOMIC_FENCE();
+		(void)vector_rcu_reclaim(vec);
+	}
+	return buffer;
+}
+
+SampleLinkage void vector_rcu_push(VectorRcu *vec, SampleType value)
+{
+	VectorCoreRcuBuffer *buffer = NULL;
+	size_t size = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_push but non-null argument expected.");
+	}
+
+	buffer = VECTOR_ATOMIC_LOAD(&vec->current);
+	if (VECTOR_UNLIKELY(buffer == NULL
+			    || VECTOR_ATOMIC_LOAD(&buffer->size)
+				       == buffer->capacity)) {
+		buffer = vector_rcu_grow(vec, buffer);
+	}
+
+	size = VECTOR_ATOMIC_LOAD(&buffer->size);
+	((SampleType *)buffer->begin)[size] = value;
+	VECTOR_ATOMIC_STORE(&buffer->size, size + 1);
+}
+
+SampleLinkage size_t vector_rcu_size(const VectorRcu *vec)
+{
+	const VectorCoreRcuBuffer *buffer = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_size but non-null argument expected.");
+	}
+
+	buffer = VECTOR_ATOMIC_LOAD(&vec->current);
+	return buffer ? VECTOR_ATOMIC_LOAD(&buffer->size) : 0;
+}
+
+SampleLinkage VectorSpan vector_rcu_read_begin(VectorRcu *vec, size_t reader)
+{
+	VectorCoreRcuBuffer *buffer = NULL;
+	VectorSpan span = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return span;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_read_begin but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(reader >= VECTOR_RCU_READERS)) {
+		vector_panic("Reader slot out of range.");
+	}
+
+	/* Pairs with the fences of vector_rcu_grow: either the writer sees
+	 * this epoch when reclaiming, or this reader sees the new buffer */
+	VECTOR_ATOMIC_STORE(&vec->readers[reader].epoch,
+			    VECTOR_ATOMIC_LOAD(&vec->epoch));
+	VECTOR_ATOMIC_FENCE();
+
+	buffer = VECTOR_ATOMIC_LOAD(&vec->current);
+	if (buffer) {
+		span.begin = (SampleType *)buffer->begin;
+		span.end = span.begin + VECTOR_ATOMIC_LOAD(&buffer->size);
+	}
+	return span;
+}
+
+SampleLinkage void vector_rcu_read_end(VectorRcu *vec, size_t reader)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_rcu_read_end but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(reader >= VECTOR_RCU_READERS)) {
+		vector_panic("Reader slot out of range.");
+	}
+
+	VECTOR_ATOMIC_STORE(&vec->readers[reader].epoch, 0);
+}
+/* Macro VECTOR_DEFINE_RCU_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_QUEUE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+/* Each index shares its cache line with the copy of the other index cached
+ * by the same thread, and nothing else. As with VectorShard, groups are two
+ * cache lines apart so that this holds whatever the alignment of the queue */
+typedef struct VectorSpsc {
+	SampleType *begin;
+	size_t mask;
+	char padding[2 * VECTOR_CACHE_LINE - sizeof(void *) - sizeof(size_t)];
+	VECTOR_ATOMIC(size_t) head;
+	size_t cached_tail;
+	char head_padding[2 * VECTOR_CACHE_LINE - 2 * sizeof(size_t)];
+	VECTOR_ATOMIC(size_t) tail;
+	size_t cached_head;
+	char tail_padding[2 * VECTOR_CACHE_LINE - 2 * sizeof(size_t)];
+} VectorSpsc;
+
+typedef struct VectorMpmcCell {
+	VECTOR_ATOMIC(size_t) sequence;
+	SampleType value;
+} VectorMpmcCell;
+
+typedef struct VectorMpmc {
+	VectorMpmcCell *cells;
+	size_t mask;
+	char padding[2 * VECTOR_CACHE_LINE - sizeof(void *) - sizeof(size_t)];
+	VECTOR_ATOMIC(size_t) enqueue_pos;
+	char enqueue_padding[2 * VECTOR_CACHE_LINE - sizeof(size_t)];
+	VECTOR_ATOMIC(size_t) dequeue_pos;
+	char dequeue_padding[2 * VECTOR_CACHE_LINE - sizeof(size_t)];
+} VectorMpmc;
+
+SampleLinkage int vector_spsc_init(VectorSpsc *queue, size_t capacity);
+SampleLinkage void vector_spsc_free(VectorSpsc *queue);
+SampleLinkage int vector_spsc_push(VectorSpsc *queue, SampleType value);
+SampleLinkage int vector_spsc_pop(VectorSpsc *queue, SampleType *value);
+SampleLinkage size_t vector_spsc_push_batch(VectorSpsc *queue,
+					    const SampleType *values,
+					    size_t count);
+SampleLinkage size_t vector_spsc_pop_batch(VectorSpsc *queue,
+					   SampleType *values, size_t count);
+SampleLinkage int vector_mpmc_init(VectorMpmc *queue, size_t capacity);
+SampleLinkage void vector_mpmc_free(VectorMpmc *queue);
+SampleLinkage int vector_mpmc_push(VectorMpmc *queue, SampleType value);
+SampleLinkage int vector_mpmc_pop(VectorMpmc *queue, SampleType *value);
+SampleLinkage size_t vector_mpmc_push_batch(VectorMpmc *queue,
+					    const SampleType *values,
+					    size_t count);
+SampleLinkage size_t vector_mpmc_pop_batch(VectorMpmc *queue,
+					   SampleType *values, size_t count);
+/* Macro VECTOR_DECLARE_QUEUE_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_QUEUE_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage int vector_spsc_init(VectorSpsc *queue, size_t capacity)
+{
+	size_t ring = vector_core_ring_capacity(capacity);
+
+	if (VECTOR_CHECK(queue == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_spsc_init but non-null argument expected.");
+	}
+
+	queue->begin = NULL;
+	queue->mask = 0;
+	VECTOR_ATOMIC_STORE(&queue->head, 0);
+	queue->cached_tail = 0;
+	VECTOR_ATOMIC_STORE(&queue->tail, 0);
+	queue->cached_head = 0;
+
+	if (ring == 0 || sizeof(SampleType) > ((size_t)-1) / ring) {
+		return 0;
+	}
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	queue->begin = (SampleType *)VECTOR_REALLOC(NULL,
+						    ring * sizeof(SampleType));
+	if (queue->begin == NULL) {
+		return 0;
+	}
+	queue->mask = ring - 1;
+	return 1;
+}
+
+SampleLinkage void vector_spsc_free(VectorSpsc *queue)
+{
+	if (VECTOR_CHECK(queue == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_spsc_free but non-null argument expected.");
+	}
+
+	VECTOR_FREE(queue->begin);
+	queue->begin = NULL;
+	queue->mask = 0;
+}
+
+SampleLinkage int vector_spsc_push(VectorSpsc *queue, SampleType value)
+{
+	return vector_spsc_push_batch(queue, &value, 1) == 1;
+}
+
+SampleLinkage int vector_spsc_pop(VectorSpsc *queue, SampleType *value)
+{
+	return vector_spsc_pop_batch(queue, value, 1) == 1;
+}
+
+SampleLinkage size_t vector_spsc_push_batch(VectorSpsc *queue,
+					    const SampleType *values,
+					    size_t count)
+{
+	size_t tail = 0;
+	size_t free_slots = 0;
+	size_t before_end = 0;
+
+	if (VECTOR_CHECK(queue == NULL || values == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_spsc_push_batch but non-null argument expected.");
+	}
+
+	/* Only the producer writes tail, and the cached head is only
+	 * refreshed from the consumer line when it looks full */
+	tail = VECTOR_ATOMIC_LOAD(&queue->tail);
+	free_slots = queue->mask + 1 - (tail - queue->cached_head);
+	if (free_slots < count) {
+		queue->cached_head = VECTOR_ATOMIC_LOAD(&queue->head);
+		free_slots = queue->mask + 1 - (tail - queue->cached_head);
+	}
+	if (count > free_slots) {
+		count = free_slots;
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	/* At most two copies, the second one wrapping around the ring */
+	before_end = queue->mask + 1 - (tail & queue->mask);
+	if (before_end > count) {
+		before_end = count;
+	}
+	memcpy(queue->begin + (tail & queue->mask), values,
+	       before_end * sizeof(SampleType));
+	memcpy(queue->begin, values + before_end,
+	       (count - before_end) * sizeof(SampleType));
+	VECTOR_ATOMIC_STORE(&queue->tail, tail + count);
+	return count;
+}
+
+SampleLinkage size_t vector_spsc_pop_batch(VectorSpsc *queue,
+					   SampleType *values, size_t count)
+{
+	size_t head = 0;
+	size_t used_slots = 0;
+	size_t before_end = 0;
+
+	if (VECTOR_CHECK(queue == NULL || values == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_spsc_pop_batch but non-null argument expected.");
+	}
+
+	head = VECTOR_ATOMIC_LOAD(&queue->head);
+	used_slots = queue->cached_tail - head;
+	if (used_slots < count) {
+		queue->cached_tail = VECTOR_ATOMIC_LOAD(&queue->tail);
+		used_slots = queue->cached_tail - head;
+	}
+	if (count > used_slots) {
+		count = used_slots;
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	before_end = queue->mask + 1 - (head & queue->mask);
+	if (before_end > count) {
+		before_end = count;
+	}
+	memcpy(values, queue->begin + (head & queue->mask),
+	       before_end * sizeof(SampleType));
+	memcpy(values + before_end, queue->begin,
+	       (count - before_end) * sizeof(SampleType));
+	VECTOR_ATOMIC_STORE(&queue->head, head + count);
+	return count;
+}
+
+SampleLinkage int vector_mpmc_init(VectorMpmc *queue, size_t capacity)
+{
+	size_t ring = vector_core_ring_capacity(capacity);
+	size_t i = 0;
+
+	if (VECTOR_CHECK(queue == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_mpmc_init but non-null argument expected.");
+	}
+
+	queue->cells = NULL;
+	queue->mask = 0;
+	VECTOR_ATOMIC_STORE(&queue->enqueue_pos, 0);
+	VECTOR_ATOMIC_STORE(&queue->dequeue_pos, 0);
+
+	if (ring == 0 || sizeof(VectorMpmcCell) > ((size_t)-1) / ring) {
+		return 0;
+	}
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	queue->cells = (VectorMpmcCell *)VECTOR_REALLOC(
+		NULL, ring * sizeof(VectorMpmcCell));
+	if (queue->cells == NULL) {
+		return 0;
+	}
+	queue->mask = ring - 1;
+
+	/* Cell i is free for the push at position i */
+	for (i = 0; i < ring; i++) {
+		VECTOR_ATOMIC_STORE(&queue->cells[i].sequence, i);
+	}
+	return 1;
+}
+
+SampleLinkage void vector_mpmc_free(VectorMpmc *queue)
+{
+	if (VECTOR_CHECK(queue == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_mpmc_free but non-null argument expected.");
+	}
+
+	VECTOR_FREE(queue->cells);
+	queue->cells = NULL;
+	queue->mask = 0;
+}
+
+SampleLinkage int vector_mpmc_push(VectorMpmc *queue, SampleType value)
+{
+	return vector_mpmc_push_batch(queue, &value, 1) == 1;
+}
+
+SampleLinkage int vector_mpmc_pop(VectorMpmc *queue, SampleType *value)
+{
+	return vector_mpmc_pop_batch(queue, value, 1) == 1;
+}
+
+/* Claim up to count consecutive positions from *position whose cells have
+ * sequence position + lap, lap being 0 for pushes and 1 for pops. Return
+ * the number claimed, 0 if the first cell is not ready */
+static size_t vector_mpmc_claim(VectorMpmc *queue,
+				VECTOR_ATOMIC(size_t) *position, size_t lap,
+				size_t count, size_t *first)
+{
+	size_t claimed = 0;
+	size_t pos = VECTOR_ATOMIC_LOAD(position);
+	size_t sequence = 0;
+	size_t expected = 0;
+	int behind = 0;
+
+	if (count == 0) {
+		return 0;
+	}
+	for (;;) {
+		for (claimed = 0; claimed < count; claimed++) {
+			expected = pos + claimed + lap;
+			sequence = VECTOR_ATOMIC_LOAD(
+				&queue->cells[(pos + claimed) & queue->mask]
+					 .sequence);
+			if (sequence != expected) {
+				/* Wrapping difference: behind or ahead */
+				behind = expected - sequence
+					 < ((size_t)-1) / 2;
+				break;
+			}
+		}
+
+		if (claimed > 0) {
+			/* Ready cells stay ready until their position is
+			 * claimed, so the CAS is the only check left */
+			if (VECTOR_ATOMIC_CAS(position, &pos, pos + claimed)) {
+				*first = pos;
+				return claimed;
+			}
+		} else if (behind) {
+			/* Still holding the previous lap: full or empty */
+			return 0;
+		} else {
+			pos = VECTOR_ATOMIC_LOAD(position);
+		}
+	}
+}
+
+SampleLinkage size_t vector_mpmc_push_batch(VectorMpmc *queue,
+					    const SampleType *values,
+					    size_t count)
+{
+	VectorMpmcCell *cell = NULL;
+	size_t first = 0;
+	size_t i = 0;
+
+	if (VECTOR_CHECK(queue == NULL || values == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_mpmc_push_batch but non-null argument expected.");
+	}
+
+	if (count > queue->mask + 1) {
+		count = queue->mask + 1;
+	}
+	count = vector_mpmc_claim(queue, &queue->enqueue_pos, 0, count, &first);
+	for (i = 0; i < count; i++) {
+		cell = &queue->cells[(first + i) & queue->mask];
+		cell->value = values[i];
+		VECTOR_ATOMIC_STORE(&cell->sequence, first + i + 1);
+	}
+	return count;
+}
+
+SampleLinkage size_t vector_mpmc_pop_batch(VectorMpmc *queue,
+					   SampleType *values, size_t count)
+{
+	VectorMpmcCell *cell = NULL;
+	size_t first = 0;
+	size_t i = 0;
+
+	if (VECTOR_CHECK(queue == NULL || values == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_mpmc_pop_batch but non-null argument expected.");
+	}
+
+	if (count > queue->mask + 1) {
+		count = queue->mask + 1;
+	}
+	count = vector_mpmc_claim(queue, &queue->dequeue_pos, 1, count, &first);
+	for (i = 0; i < count; i++) {
+		cell = &queue->cells[(first + i) & queue->mask];
+		values[i] = cell->value;
+		VECTOR_ATOMIC_STORE(&cell->sequence,
+				    first + i + queue->mask + 1);
+	}
+	return count;
+}
+/* Macro VECTOR_DEFINE_QUEUE_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_SHARDED_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+/* Two cache lines apart, the headers of neighbouring shards never share a
+ * line, whatever the alignment of the shard array */
+typedef struct VectorShard {
+	Vector vec;
+	size_t offset;
+	char padding[2 * VECTOR_CACHE_LINE - sizeof(Vector) - sizeof(size_t)];
+} VectorShard;
+
+typedef struct VectorSharded {
+	VectorShard *shards;
+	size_t count;
+} VectorSharded;
+
+SampleLinkage int vector_sharded_init(VectorSharded *sharded,
+				      size_t shard_count);
+SampleLinkage void vector_sharded_free(VectorSharded *sharded);
+SampleLinkage Vector *vector_sharded_shard(VectorSharded *sharded,
+					   size_t shard);
+SampleLinkage size_t vector_sharded_size(const VectorSharded *sharded);
+SampleLinkage int vector_sharded_gather_begin(VectorSharded *sharded,
+					      Vector *out);
+SampleLinkage void vector_sharded_gather_shard(const VectorSharded *sharded,
+					       Vector *out, size_t shard);
+SampleLinkage int vector_sharded_gather(VectorSharded *sharded, Vector *out);
+/* Macro VECTOR_DECLARE_SHARDED_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_SHARDED_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage int vector_sharded_init(VectorSharded *sharded,
+				      size_t shard_count)
+{
+	size_t shard = 0;
+
+	if (VECTOR_CHECK(sharded == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_init but non-null argument expected.");
+	}
+
+	sharded->shards = NULL;
+	sharded->count = 0;
+	if (shard_count == 0) {
+		return 1;
+	}
+	if (shard_count > ((size_t)-1) / sizeof(VectorShard)) {
+		return 0;
+	}
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	sharded->shards = (VectorShard *)VECTOR_REALLOC(
+		NULL, shard_count * sizeof(VectorShard));
+	if (sharded->shards == NULL) {
+		return 0;
+	}
+
+	for (shard = 0; shard < shard_count; shard++) {
+		sharded->shards[shard].vec.begin = NULL;
+		sharded->shards[shard].vec.end = NULL;
+		sharded->shards[shard].vec.end_of_storage = NULL;
+		sharded->shards[shard].offset = 0;
+	}
+	sharded->count = shard_count;
+	return 1;
+}
+
+SampleLinkage void vector_sharded_free(VectorSharded *sharded)
+{
+	size_t shard = 0;
+
+	if (VECTOR_CHECK(sharded == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_free but non-null argument expected.");
+	}
+
+	for (shard = 0; shard < sharded->count; shard++) {
+		vector_free(&sharded->shards[shard].vec);
+	}
+	VECTOR_FREE(sharded->shards);
+	sharded->shards = NULL;
+	sharded->count = 0;
+}
+
+SampleLinkage Vector *vector_sharded_shard(VectorSharded *sharded,
+					   size_t shard)
+{
+	if (VECTOR_CHECK(sharded == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return NULL;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_shard but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(shard >= sharded->count)) {
+		vector_panic("Shard out of range.");
+	}
+
+	return &sharded->shards[shard].vec;
+}
+
+SampleLinkage size_t vector_sharded_size(const VectorSharded *sharded)
+{
+	size_t size = 0;
+	size_t shard = 0;
+
+	if (VECTOR_CHECK(sharded == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_size but non-null argument expected.");
+	}
+
+	for (shard = 0; shard < sharded->count; shard++) {
+		size += VECTOR_SIZE(&sharded->shards[shard].vec);
+	}
+	return size;
+}
+
+SampleLinkage int vector_sharded_gather_begin(VectorSharded *sharded,
+					      Vector *out)
+{
+	size_t offset = 0;
+	size_t shard = 0;
+
+	if (VECTOR_CHECK(sharded == NULL || out == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_gather_begin but non-null argument expected.");
+	}
+
+	/* Exclusive prefix sum of the shard sizes, after the elements already
+	 * in out */
+	offset = VECTOR_SIZE(out);
+	for (shard = 0; shard < sharded->count; shard++) {
+		sharded->shards[shard].offset = offset;
+		offset += VECTOR_SIZE(&sharded->shards[shard].vec);
+		if (VECTOR_UNLIKELY(offset < sharded->shards[shard].offset)) {
+			if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+				return 0;
+			}
+			vector_panic(
+				"Requested capacity would cause size overflow.");
+		}
+	}
+
+	vector_resize(out, offset);
+	return VECTOR_SIZE(out) == offset;
+}
+
+SampleLinkage void vector_sharded_gather_shard(const VectorSharded *sharded,
+					       Vector *out, size_t shard)
+{
+	const Vector *vec = NULL;
+
+	if (VECTOR_CHECK(sharded == NULL || out == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_sharded_gather_shard but non-null argument expected.");
+	}
+	if (VECTOR_CHECK(shard >= sharded->count)) {
+		vector_panic("Shard out of range.");
+	}
+
+	vec = &sharded->shards[shard].vec;
+	if (VECTOR_CHECK(sharded->shards[shard].offset + VECTOR_SIZE(vec)
+			 > VECTOR_SIZE(out))) {
+		vector_panic("Out of range.");
+	}
+	if (vec->begin != vec->end) {
+		memcpy(out->begin + sharded->shards[shard].offset, vec->begin,
+		       VECTOR_SIZE(vec) * sizeof(SampleType));
+	}
+}
+
+SampleLinkage int vector_sharded_gather(VectorSharded *sharded, Vector *out)
+{
+	size_t shard = 0;
+
+	if (!vector_sharded_gather_begin(sharded, out)) {
+		return 0;
+	}
+	for (shard = 0; shard < sharded->count; shard++) {
+		vector_sharded_gather_shard(sharded, out, shard);
+	}
+	return 1;
+}
+/* Macro VECTOR_DEFINE_SHARDED_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_PARALLEL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage void vector_parallel_for_each(
+	Vector *vec, void (*function)(SampleType *element, void *context),
+	void *context);
+SampleLinkage void vector_parallel_transform(
+	Vector *dest, const Vector *src,
+	SampleType (*function)(SampleType value, void *context), void *context);
+SampleLinkage SampleType vector_parallel_reduce(
+	const Vector *vec, SampleType identity,
+	SampleType (*combine)(SampleType a, SampleType b, void *context),
+	void *context);
+SampleLinkage void vector_parallel_fill(Vector *vec, SampleType value);
+SampleLinkage void vector_parallel_duplicate(Vector *RESTRICT dest,
+					     const Vector *RESTRICT src,
+					     int fit);
+/* Macro VECTOR_DECLARE_PARALLEL_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_PARALLEL_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+/* Arguments of a parallel loop, shared by the threads running its chunks */
+typedef struct VectorParallelJob {
+	SampleType *dest;
+	const SampleType *src;
+	SampleType *partials;
+	SampleType value;
+	void (*visit)(SampleType *element, void *context);
+	SampleType (*map)(SampleType value, void *context);
+	SampleType (*combine)(SampleType a, SampleType b, void *context);
+	void *context;
+	int stream;
+} VectorParallelJob;
+
+static void vector_parallel_for_each_task(void *job, size_t chunk,
+					  size_t begin, size_t end)
+{
+	VectorParallelJob *args = (VectorParallelJob *)job;
+	SampleType *i = args->dest + begin;
+	SampleType *last = args->dest + end;
+
+	(void)chunk;
+	for (; i < last; i++) {
+		args->visit(i, args->context);
+	}
+}
+
+static void vector_parallel_transform_task(void *job, size_t chunk,
+					   size_t begin, size_t end)
+{
+	VectorParallelJob *args = (VectorParallelJob *)job;
+	size_t idx = begin;
+
+	(void)chunk;
+	for (; idx < end; idx++) {
+		args->dest[idx] = args->map(args->src[idx], args->context);
+	}
+}
+
+static void vector_parallel_reduce_task(void *job, size_t chunk,
+					size_t begin, size_t end)
+{
+	VectorParallelJob *args = (VectorParallelJob *)job;
+	SampleType partial = args->value;
+	size_t idx = begin;
+
+	for (; idx < end; idx++) {
+		partial = args->combine(partial, args->src[idx], args->context);
+	}
+	args->partials[chunk] = partial;
+}
+
+static void vector_parallel_fill_task(void *job, size_t chunk, size_t begin,
+				      size_t end)
+{
+	VectorParallelJob *args = (VectorParallelJob *)job;
+	SampleType *i = args->dest + begin;
+	SampleType *last = args->dest + end;
+
+	(void)chunk;
+	for (; i < last; i++) {
+		*i = args->value;
+	}
+}
+
+static void vector_parallel_copy_task(void *job, size_t chunk, size_t begin,
+				      size_t end)
+{
+	VectorParallelJob *args = (VectorParallelJob *)job;
+
+	(void)chunk;
+	if (args->stream) {
+		vector_core_stream_copy(args->dest + begin, args->src + begin,
+					(end - begin) * sizeof(SampleType));
+	} else {
+		memcpy(args->dest + begin, args->src + begin,
+		       (end - begin) * sizeof(SampleType));
+	}
+}
+
+SampleLinkage void vector_parallel_for_each(
+	Vector *vec, void (*function)(SampleType *element, void *context),
+	void *context)
+{
+	VectorParallelJob job;
+
+	if (VECTOR_CHECK(vec == NULL || function == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_for_each but non-null argument expected.");
+	}
+
+	memset(&job, 0, sizeof(job));
+	job.dest = vec->begin;
+	job.visit = function;
+	job.context = context;
+	vector_core_parallel_run(VECTOR_SIZE(vec),
+				 VECTOR_PARALLEL_GRAIN(sizeof(SampleType)),
+				 vector_parallel_for_each_task, &job);
+}
+
+SampleLinkage void vector_parallel_transform(
+	Vector *dest, const Vector *src,
+	SampleType (*function)(SampleType value, void *context), void *context)
+{
+	VectorParallelJob job;
+
+	if (VECTOR_CHECK(dest == NULL || src == NULL || function == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_transform but non-null argument expected.");
+	}
+
+	if (dest != src) {
+		vector_resize(dest, VECTOR_SIZE(src));
+		if (VECTOR_SIZE(dest) != VECTOR_SIZE(src)) {
+			return;
+		}
+	}
+
+	memset(&job, 0, sizeof(job));
+	job.dest = dest->begin;
+	job.src = src->begin;
+	job.map = function;
+	job.context = context;
+	vector_core_parallel_run(VECTOR_SIZE(src),
+				 VECTOR_PARALLEL_GRAIN(sizeof(SampleType)),
+				 vector_parallel_transform_task, &job);
+}
+
+SampleLinkage SampleType vector_parallel_reduce(
+	const Vector *vec, SampleType identity,
+	SampleType (*combine)(SampleType a, SampleType b, void *context),
+	void *context)
+{
+	VectorParallelJob job;
+	size_t grain = VECTOR_PARALLEL_GRAIN(sizeof(SampleType));
+	size_t chunks = 0;
+	size_t chunk = 0;
+
+	if (VECTOR_CHECK(vec == NULL || combine == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return identity;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_reduce but non-null argument expected.");
+	}
+	if (VECTOR_IS_SIZE_ZERO(vec)) {
+		return identity;
+	}
+
+	memset(&job, 0, sizeof(job));
+	chunks = (VECTOR_SIZE(vec) - 1) / grain + 1;
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	job.partials =
+		(SampleType *)VECTOR_REALLOC(NULL, chunks * sizeof(SampleType));
+	if (job.partials == NULL) {
+		vector_panic("Out of memory.");
+	}
+	job.src = vec->begin;
+	job.value = identity;
+	job.combine = combine;
+	job.context = context;
+	vector_core_parallel_run(VECTOR_SIZE(vec), grain,
+				 vector_parallel_reduce_task, &job);
+
+	/* Partials are combined in chunk order, whatever the thread count */
+	for (chunk = 0; chunk < chunks; chunk++) {
+		identity = combine(identity, job.partials[chunk], context);
+	}
+	VECTOR_FREE(job.partials);
+	return identity;
+}
+
+SampleLinkage void vector_parallel_fill(Vector *vec, SampleType value)
+{
+	VectorParallelJob job;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_fill but non-null argument expected.");
+	}
+
+	memset(&job, 0, sizeof(job));
+	job.dest = vec->begin;
+	job.value = value;
+	vector_core_parallel_run(VECTOR_SIZE(vec),
+				 VECTOR_PARALLEL_GRAIN(sizeof(SampleType)),
+				 vector_parallel_fill_task, &job);
+}
+
+SampleLinkage void vector_parallel_duplicate(Vector *RESTRICT dest,
+					     const Vector *RESTRICT src,
+					     int fit)
+{
+	VectorParallelJob job;
+	size_t capacity = 0;
+
+	if (VECTOR_CHECK(dest == NULL || src == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		vector_panic(
+			"Null passed to vector_parallel_duplicate but non-null argument expected.");
+	}
+	vector_assert(src);
+
+	capacity = fit ? VECTOR_SIZE(src) : VECTOR_CAPACITY(src);
+	if (capacity == 0) {
+		dest->begin = NULL;
+		dest->end = NULL;
+		dest->end_of_storage = NULL;
+		return;
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		vector_panic("Allocation inside a no-alloc region.");
+	}
+	dest->begin = (SampleType *)VECTOR_REALLOC(
+		NULL, capacity * sizeof(SampleType));
+	if (VECTOR_UNLIKELY(dest->begin == NULL)) {
+		vector_panic("Out of memory.");
+	}
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_REALLOC,
+			   "Vector", "vector_parallel_duplicate", 0, capacity,
+			   capacity * sizeof(SampleType));
+	VECTOR_TRACE_EVENT(vector_trace_counters, VECTOR_TRACE_COPY,
+			   "Vector", "vector_parallel_duplicate", 0, capacity,
+			   VECTOR_SIZE(src) * sizeof(SampleType));
+	VECTOR_ACCOUNT(vector_account, 0, 0, capacity, VECTOR_SIZE(src));
+
+	dest->end = dest->begin + VECTOR_SIZE(src);
+	dest->end_of_storage = dest->begin + capacity;
+
+	memset(&job, 0, sizeof(job));
+	job.dest = dest->begin;
+	job.src = src->begin;
+	job.stream = VECTOR_SIZE(src)
+		     >= VECTOR_STREAM_BYTES / sizeof(SampleType);
+	vector_core_parallel_run(VECTOR_SIZE(src),
+				 VECTOR_PARALLEL_GRAIN(sizeof(SampleType)),
+				 vector_parallel_copy_task, &job);
+
+	vector_assert(dest);
+}
+/* Macro VECTOR_DEFINE_PARALLEL_LINKAGE stop here */
+
+/* Macro VECTOR_DECLARE_NUMERIC_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Linkage_=SampleLinkage) start here */
+SampleLinkage size_t vector_find(const Vector *vec, SampleType value);
+SampleLinkage size_t vector_count(const Vector *vec, SampleType value);
+SampleLinkage int vector_contains(const Vector *vec, SampleType value);
+SampleLinkage size_t vector_find_if_eq(const Vector *vec, SampleType value,
+				       int (*equal)(SampleType a,
+						    SampleType b));
+SampleLinkage size_t vector_span_find(VectorSpan span, SampleType value);
+SampleLinkage size_t vector_span_count(VectorSpan span, SampleType value);
+SampleLinkage int vector_span_contains(VectorSpan span, SampleType value);
+SampleLinkage size_t vector_span_find_if_eq(VectorSpan span, SampleType value,
+					    int (*equal)(SampleType a,
+							 SampleType b));
+SampleLinkage SampleType vector_sum(const Vector *vec);
+SampleLinkage SampleType vector_sum_kahan(const Vector *vec);
+SampleLinkage SampleType vector_dot(const Vector *a, const Vector *b);
+SampleLinkage SampleType vector_min(const Vector *vec);
+SampleLinkage SampleType vector_max(const Vector *vec);
+SampleLinkage size_t vector_argmin(const Vector *vec);
+SampleLinkage size_t vector_argmax(const Vector *vec);
+SampleLinkage SampleType vector_span_sum(VectorSpan span);
+SampleLinkage SampleType vector_span_sum_kahan(VectorSpan span);
+SampleLinkage SampleType vector_span_dot(VectorSpan a, VectorSpan b);
+SampleLinkage SampleType vector_span_min(VectorSpan span);
+SampleLinkage SampleType vector_span_max(VectorSpan span);
+SampleLinkage size_t vector_span_argmin(VectorSpan span);
+SampleLinkage size_t vector_span_argmax(VectorSpan span);
+/* Macro VECTOR_DECLARE_NUMERIC_LINKAGE stop here */
+
+/* Macro VECTOR_DEFINE_NUMERIC_LINKAGE(Struct_Name_=Vector, Functions_Prefix_=vector, Custom_Type_=SampleType, Kind_=SampleKind, Linkage_=SampleLinkage) start here */
+/* Fails to compile if the kind does not have the size of the elements */
+typedef char vector_numeric_kind_check
+	[sizeof(SampleType) == VECTOR_KIND_SIZE(SampleKind) ? 1 : -1];
+
+SampleLinkage size_t vector_find(const Vector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return VECTOR_NOT_FOUND;
+		}
+		vector_panic(
+			"Null passed to vector_find but non-null argument expected.");
+	}
+
+	return vector_span_find(vector_span(vec), value);
+}
+
+SampleLinkage size_t vector_span_find(VectorSpan span, SampleType value)
+{
+	return vector_core_find(SampleKind, span.begin, VECTOR_SIZE(&span),
+				&value);
+}
+
+SampleLinkage size_t vector_count(const Vector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		vector_panic(
+			"Null passed to vector_count but non-null argument expected.");
+	}
+
+	return vector_span_count(vector_span(vec), value);
+}
+
+SampleLinkage size_t vector_span_count(VectorSpan span, SampleType value)
+{
+	return vector_core_count(SampleKind, span.begin, VECTOR_SIZE(&span),
+				 &value);
+}
+
+SampleLinkage int vector_contains(const Vector *vec, SampleType value)
+{
+	return vector_find(vec, value) != VECTOR_NOT_FOUND;
+}
+
+SampleLinkage int vector_span_contains(VectorSpan span, SampleType value)
+{
+	return vector_span_find(span, value) != VECTOR_NOT_FOUND;
+}
+
+SampleLinkage size_t vector_find_if_eq(const Vector *vec, SampleType value,
+				       int (*equal)(SampleType a,
+						    SampleType b))
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return VECTOR_NOT_FOUND;
+		}
+		vector_panic(
+			"Null passed to vector_find_if_eq but non-null argument expected.");
+	}
+
+	return vector_span_find_if_eq(vector_span(vec), value, equal);
+}
+
+SampleLinkage size_t vector_span_find_if_eq(VectorSpan span, SampleType value,
+					    int (*equal)(SampleType a,
+							 SampleType b))
+{
+	const SampleType *i = NULL;
+
+	if (VECTOR_CHECK(equal == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return VECTOR_NOT_FOUND;
+		}
+		vector_panic(
+			"Null passed to vector_span_find_if_eq but non-null argument expected.");
+	}
+
+	for (i = span.begin; i < span.end; i++) {
+		if (equal(*i, value)) {
+			return (size_t)(i - span.begin);
+		}
+	}
+	return VECTOR_NOT_FOUND;
+}
+
+/* Integer sums, of the products with the elements of b if not NULL, in
+ * accumulators the compiler can keep in SIMD registers since their order does
+ * not matter */
+static SampleType vector_sum_lanes(const SampleType *a, const SampleType *b,
+				   size_t size)
+{
+	SampleType lanes[VECTOR_REDUCE_LANES];
+	SampleType sum = 0;
+	size_t rounds = size / VECTOR_REDUCE_LANES;
+	size_t lane = 0;
+
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[lane] = 0;
+	}
+	if (b) {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES,
+				   b += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane] * b[lane];
+			}
+		}
+	} else {
+		for (; rounds > 0; rounds--, a += VECTOR_REDUCE_LANES) {
+			for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+				lanes[lane] += a[lane];
+			}
+		}
+	}
+
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		sum += lanes[lane];
+	}
+	for (lane = 0; lane < size % VECTOR_REDUCE_LANES; lane++) {
+		sum += b ? a[lane] * b[lane] : a[lane];
+	}
+	return sum;
+}
+
+static void vector_kahan_add(SampleType *sum, SampleType *error,
+			     SampleType value)
+{
+	SampleType total = 0;
+
+	value -= *error;
+	total = *sum + value;
+	*error = (total - *sum) - value;
+	*sum = total;
+}
+
+SampleLinkage SampleType vector_sum(const Vector *vec)
+{
+	SampleType sum = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return sum;
+		}
+		vector_panic(
+			"Null passed to vector_sum but non-null argument expected.");
+	}
+
+	return vector_span_sum(vector_span(vec));
+}
+
+SampleLinkage SampleType vector_span_sum(VectorSpan span)
+{
+	SampleType sum = 0;
+
+	if (SampleKind == VECTOR_F32 || SampleKind == VECTOR_F64) {
+		vector_core_sum(SampleKind, span.begin, NULL,
+				VECTOR_SIZE(&span), &sum);
+		return sum;
+	}
+	return vector_sum_lanes(span.begin, NULL, VECTOR_SIZE(&span));
+}
+
+SampleLinkage SampleType vector_sum_kahan(const Vector *vec)
+{
+	SampleType sum = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return sum;
+		}
+		vector_panic(
+			"Null passed to vector_sum_kahan but non-null argument expected.");
+	}
+
+	return vector_span_sum_kahan(vector_span(vec));
+}
+
+SampleLinkage SampleType vector_span_sum_kahan(VectorSpan span)
+{
+	SampleType sums[VECTOR_REDUCE_LANES];
+	SampleType errors[VECTOR_REDUCE_LANES];
+	SampleType sum = 0;
+	SampleType error = 0;
+	const SampleType *i = NULL;
+	size_t rounds = 0;
+	size_t lane = 0;
+
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		sums[lane] = 0;
+		errors[lane] = 0;
+	}
+	i = span.begin;
+	for (rounds = VECTOR_SIZE(&span) / VECTOR_REDUCE_LANES; rounds > 0;
+	     rounds--, i += VECTOR_REDUCE_LANES) {
+		for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+			vector_kahan_add(&sums[lane], &errors[lane], i[lane]);
+		}
+	}
+
+	/* Then the accumulators, minus their errors, and the remaining
+	 * elements, in order */
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		vector_kahan_add(&sum, &error, sums[lane]);
+		vector_kahan_add(&sum, &error, -errors[lane]);
+	}
+	for (; i < span.end; i++) {
+		vector_kahan_add(&sum, &error, *i);
+	}
+	return sum;
+}
+
+SampleLinkage SampleType vector_dot(const Vector *a, const Vector *b)
+{
+	SampleType sum = 0;
+
+	if (VECTOR_CHECK(a == NULL || b == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return sum;
+		}
+		vector_panic(
+			"Null passed to vector_dot but non-null argument expected.");
+	}
+
+	return vector_span_dot(vector_span(a), vector_span(b));
+}
+
+SampleLinkage SampleType vector_span_dot(VectorSpan a, VectorSpan b)
+{
+	SampleType sum = 0;
+
+	if (VECTOR_SIZE(&a) != VECTOR_SIZE(&b)) {
+		vector_panic("Dot product of vectors of different sizes.");
+	}
+	if (SampleKind == VECTOR_F32 || SampleKind == VECTOR_F64) {
+		vector_core_sum(SampleKind, a.begin, b.begin, VECTOR_SIZE(&a),
+				&sum);
+		return sum;
+	}
+	return vector_sum_lanes(a.begin, b.begin, VECTOR_SIZE(&a));
+}
+
+SampleLinkage SampleType vector_min(const Vector *vec)
+{
+	SampleType nothing = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_min but non-null argument expected.");
+	}
+
+	return vector_span_min(vector_span(vec));
+}
+
+SampleLinkage SampleType vector_span_min(VectorSpan span)
+{
+	SampleType lanes[VECTOR_REDUCE_LANES];
+	const SampleType *first = NULL;
+	const SampleType *i = NULL;
+	size_t lane = 0;
+
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(&span))) {
+		vector_panic("Cannot take the minimum of an empty vector.");
+	}
+
+	/* NaN never compares less, nor wins once the lanes start from a
+	 * number */
+	first = span.begin;
+	while (first + 1 < span.end && vector_core_is_nan(SampleKind, first)) {
+		first++;
+	}
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[lane] = *first;
+	}
+	for (i = first; span.end - i >= VECTOR_REDUCE_LANES;
+	     i += VECTOR_REDUCE_LANES) {
+		for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+			lanes[lane] = i[lane] < lanes[lane] ? i[lane]
+							    : lanes[lane];
+		}
+	}
+
+	for (lane = 1; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[0] = lanes[lane] < lanes[0] ? lanes[lane] : lanes[0];
+	}
+	for (; i < span.end; i++) {
+		lanes[0] = *i < lanes[0] ? *i : lanes[0];
+	}
+	return lanes[0];
+}
+
+SampleLinkage SampleType vector_max(const Vector *vec)
+{
+	SampleType nothing = 0;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		vector_panic(
+			"Null passed to vector_max but non-null argument expected.");
+	}
+
+	return vector_span_max(vector_span(vec));
+}
+
+SampleLinkage SampleType vector_span_max(VectorSpan span)
+{
+	SampleType lanes[VECTOR_REDUCE_LANES];
+	const SampleType *first = NULL;
+	const SampleType *i = NULL;
+	size_t lane = 0;
+
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(&span))) {
+		vector_panic("Cannot take the maximum of an empty vector.");
+	}
+
+	first = span.begin;
+	while (first + 1 < span.end && vector_core_is_nan(SampleKind, first)) {
+		first++;
+	}
+	for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[lane] = *first;
+	}
+	for (i = first; span.end - i >= VECTOR_REDUCE_LANES;
+	     i += VECTOR_REDUCE_LANES) {
+		for (lane = 0; lane < VECTOR_REDUCE_LANES; lane++) {
+			lanes[lane] = lanes[lane] < i[lane] ? i[lane]
+							    : lanes[lane];
+		}
+	}
+
+	for (lane = 1; lane < VECTOR_REDUCE_LANES; lane++) {
+		lanes[0] = lanes[0] < lanes[lane] ? lanes[lane] : lanes[0];
+	}
+	for (; i < span.end; i++) {
+		lanes[0] = lanes[0] < *i ? *i : lanes[0];
+	}
+	return lanes[0];
+}
+
+SampleLinkage size_t vector_argmin(const Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return VECTOR_NOT_FOUND;
+		}
+		vector_panic(
+			"Null passed to vector_argmin but non-null argument expected.");
+	}
+
+	return vector_span_argmin(vector_span(vec));
+}
+
+SampleLinkage size_t vector_span_argmin(VectorSpan span)
+{
+	SampleType min = 0;
+
+	if (VECTOR_IS_SIZE_ZERO(&span)) {
+		return VECTOR_NOT_FOUND;
+	}
+
+	min = vector_span_min(span);
+	return vector_core_find(SampleKind, span.begin, VECTOR_SIZE(&span),
+				&min);
+}
+
+SampleLinkage size_t vector_argmax(const Vector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return VECTOR_NOT_FOUND;
+		}
+		vector_panic(
+			"Null passed to vector_argmax but non-null argument expected.");
+	}
+
+	return vector_span_argmax(vector_span(vec));
+}
+
+SampleLinkage size_t vector_span_argmax(VectorSpan span)
+{
+	SampleType max = 0;
+
+	if (VECTOR_IS_SIZE_ZERO(&span)) {
+		return VECTOR_NOT_FOUND;
+	}
+
+	max = vector_span_max(span);
+	return vector_core_find(SampleKind, span.begin, VECTOR_SIZE(&span),
+				&max);
+}
+/* Macro VECTOR_DEFINE_NUMERIC_LINKAGE stop here */
+
+#define VECTOR_DEFINE_CORE_LINKAGE(Struct_Name_, Functions_Prefix_,     \
+				   Custom_Type_, Linkage_, Panic_Linkage_) \
+	VECTOR_DEFINE_TRACE(Struct_Name_, Functions_Prefix_, Linkage_)   \
+	VECTOR_DEFINE_ACCOUNT(Struct_Name_, Functions_Prefix_,           \
+			      Custom_Type_, Linkage_)                    \
+	VECTOR_DEFINE_CORE_BASE(Struct_Name_, Functions_Prefix_,         \
+				Custom_Type_, Linkage_, Panic_Linkage_)    \
+	VECTOR_DEFINE_CORE_GROW(Struct_Name_, Functions_Prefix_,         \
+				Custom_Type_, Linkage_)
+#define VECTOR_DEFINE_LINKAGE(Struct_Name_, Functions_Prefix_, Custom_Type_,  \
+			      Linkage_, Panic_Linkage_)                       \
+	VECTOR_DEFINE_CORE_LINKAGE(Struct_Name_, Functions_Prefix_,           \
+				   Custom_Type_, Linkage_, Panic_Linkage_)    \
+	VECTOR_DEFINE_ACCESS_LINKAGE(Struct_Name_, Functions_Prefix_,         \
+				     Custom_Type_, Linkage_)                  \
+	VECTOR_DEFINE_EDIT_LINKAGE(Struct_Name_, Functions_Prefix_,           \
+				   Custom_Type_, Linkage_)                    \
+	VECTOR_DEFINE_DUPLICATE_LINKAGE(Struct_Name_, Functions_Prefix_,      \
+					Custom_Type_, Linkage_)
+
+#define VECTOR_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+			       Custom_Type_, VECTOR_EXTERN, VECTOR_EXTERN)
+#define VECTOR_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+			      Custom_Type_, VECTOR_EXTERN, VECTOR_EXTERN)
+#define VECTOR_DEFINE_CORE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_CORE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				   Custom_Type_, VECTOR_EXTERN, VECTOR_EXTERN)
+#define VECTOR_DEFINE_ACCESS(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_ACCESS_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				     Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_EDIT(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_EDIT_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				   Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_DUPLICATE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_DUPLICATE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+					Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_SERIAL(Struct_Name_, Functions_Prefix_) \
+	VECTOR_DECLARE_SERIAL_LINKAGE(Struct_Name_, Functions_Prefix_, \
+				      VECTOR_EXTERN)
+#define VECTOR_DEFINE_SERIAL(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_SERIAL_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				     Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_VIEW(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_VIEW_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				    Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_VIEW(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_VIEW_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				   Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_FILE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_FILE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				    Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_FILE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_FILE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				   Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_SPILL(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_SPILL_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				     Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_SPILL(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_SPILL_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				    Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_SORT(Struct_Name_, Functions_Prefix_) \
+	VECTOR_DECLARE_SORT_LINKAGE(Struct_Name_, Functions_Prefix_, \
+				    VECTOR_EXTERN)
+#define VECTOR_DEFINE_SORT(Struct_Name_, Functions_Prefix_, Custom_Type_, \
+			   Less_)                                              \
+	VECTOR_DEFINE_SORT_LINKAGE(Struct_Name_, Functions_Prefix_,        \
+				   Custom_Type_, Less_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_CONCURRENT(Struct_Name_, Functions_Prefix_,    \
+				  Custom_Type_)                         \
+	VECTOR_DECLARE_CONCURRENT_LINKAGE(Struct_Name_, Functions_Prefix_, \
+					  Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_CONCURRENT(Struct_Name_, Functions_Prefix_,    \
+				 Custom_Type_)                         \
+	VECTOR_DEFINE_CONCURRENT_LINKAGE(Struct_Name_, Functions_Prefix_, \
+					 Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_RCU(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_RCU_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				   Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_RCU(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_RCU_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				  Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_QUEUE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_QUEUE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				     Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_QUEUE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_QUEUE_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				    Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_SHARDED(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_SHARDED_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				       Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_SHARDED(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_SHARDED_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				      Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_PARALLEL(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_PARALLEL_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+					Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_PARALLEL(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_PARALLEL_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				       Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DECLARE_NUMERIC(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_NUMERIC_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				       Custom_Type_, VECTOR_EXTERN)
+#define VECTOR_DEFINE_NUMERIC(Struct_Name_, Functions_Prefix_, Custom_Type_, \
+			      Kind_)                                         \
+	VECTOR_DEFINE_NUMERIC_LINKAGE(Struct_Name_, Functions_Prefix_,       \
+				      Custom_Type_, Kind_, VECTOR_EXTERN)
+/* The panic function stays out of line, hence static but not inline */
+#define VECTOR_DEFINE_INLINE(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DECLARE_LINKAGE(Struct_Name_, Functions_Prefix_,             \
+			       Custom_Type_, VECTOR_STATIC_INLINE, static)  \
+	VECTOR_DEFINE_LINKAGE(Struct_Name_, Functions_Prefix_,              \
+			      Custom_Type_, VECTOR_STATIC_INLINE, static)
+
+/* Macro VECTOR_DECLARE_STATIC(Struct_Name_=StaticVector, Functions_Prefix_=static_vector, Custom_Type_=SampleType, Capacity_=SAMPLE_CAPACITY) start here */
+
+typedef struct StaticVector {
+	SampleType *begin;
+	SampleType *end;
+	SampleType *end_of_storage;
+	SampleType storage[SAMPLE_CAPACITY];
+} StaticVector;
+
+VECTOR_NORETURN VECTOR_COLD void static_vector_panic(const char *message);
+void static_vector_assert(const StaticVector *vec);
+void static_vector_grow(StaticVector *vec, size_t element_count);
+void static_vector_resize(StaticVector *vec, size_t element_count);
+void static_vector_free(StaticVector *vec);
+void static_vector_init(StaticVector *vec, size_t element_count);
+void static_vector_push(StaticVector *vec, SampleType value);
+int static_vector_try_push(StaticVector *vec, SampleType value);
+SampleType static_vector_pop(StaticVector *vec);
+SampleType static_vector_get(const StaticVector *vec, size_t idx);
+void static_vector_set(StaticVector *vec, size_t idx, SampleType value);
+void static_vector_insert(StaticVector *vec, size_t idx, SampleType value);
+int static_vector_try_insert(StaticVector *vec, size_t idx,
+			     SampleType value);
+void static_vector_delete(StaticVector *vec, size_t idx);
+void static_vector_duplicate(StaticVector *RESTRICT dest,
+			     const StaticVector *RESTRICT src);
+void static_vector_clear(StaticVector *vec);
+void static_vector_trace_dump(FILE *stream);
+/* Macro VECTOR_DECLARE_STATIC stop here */
+
+/* Macro VECTOR_DEFINE_STATIC_BASE(Struct_Name_=StaticVector, Functions_Prefix_=static_vector, Custom_Type_=SampleType) start here */
+struct StaticVector;
+VECTOR_DEFINE_PANIC(static_vector, VECTOR_EXTERN)
+
+VECTOR_INLINE void static_vector_assert(const struct StaticVector *vec)
+{
+	if (VECTOR_NO_CHECKS) {
+		return;
+	}
+
+	if (vec->begin == NULL) {
+		assert(vec->end == NULL && vec->end_of_storage == NULL);
+		return;
+	}
+
+	assert(vec->begin == vec->storage);
+	assert(vec->end_of_storage == vec->storage + VECTOR_STATIC_CAPACITY(vec));
+	assert(vec->begin <= vec->end && vec->end <= vec->end_of_storage);
+}
+
+void static_vector_grow(struct StaticVector *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_grow but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (element_count > VECTOR_STATIC_CAPACITY(vec)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Requested capacity exceeds static capacity.");
+	}
+
+	if (vec->begin == NULL) {
+		static_vector_init(vec, element_count);
+	}
+}
+
+void static_vector_resize(struct StaticVector *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_resize but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (element_count > VECTOR_STATIC_CAPACITY(vec)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Requested size exceeds static capacity.");
+	}
+
+	if (vec->begin == NULL) {
+		static_vector_init(vec, element_count);
+	}
+
+	vec->end = vec->begin + element_count;
+}
+
+void static_vector_free(struct StaticVector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_free but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	vec->begin = NULL;
+	vec->end = NULL;
+	vec->end_of_storage = NULL;
+}
+
+void static_vector_init(struct StaticVector *vec, size_t element_count)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_init but non-null argument expected.");
+	}
+
+	if (element_count > VECTOR_STATIC_CAPACITY(vec)) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Requested capacity exceeds static capacity.");
+	}
+
+	vec->begin = vec->storage;
+	vec->end = vec->storage;
+	vec->end_of_storage = vec->storage + VECTOR_STATIC_CAPACITY(vec);
+
+	static_vector_assert(vec);
+}
+
+void static_vector_push(struct StaticVector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_push but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (vec->begin == NULL) {
+		static_vector_init(vec, 0);
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Static vector is full.");
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+}
+
+int static_vector_try_push(struct StaticVector *vec, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_try_push but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (vec->begin == NULL) {
+		static_vector_init(vec, 0);
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		return 0;
+	}
+
+	vec->end[0] = value;
+	vec->end++;
+
+	return 1;
+}
+
+SampleType static_vector_pop(struct StaticVector *vec)
+{
+	SampleType nothing = { 0 };
+	SampleType ret = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_pop but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(vec))) {
+		static_vector_panic("Cannot pop from empty vector.");
+	}
+
+	ret = vec->end[-1];
+	vec->end--;
+
+	return ret;
+}
+
+SampleType static_vector_get(const struct StaticVector *vec, size_t idx)
+{
+	SampleType nothing = { 0 };
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return nothing;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_get but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return nothing;
+		}
+		static_vector_panic("Out of range.");
+	}
+
+	return vec->begin[idx];
+}
+
+void static_vector_set(struct StaticVector *vec, size_t idx, SampleType value)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_set but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Out of range.");
+	}
+
+	vec->begin[idx] = value;
+}
+
+void static_vector_insert(struct StaticVector *vec, size_t idx,
+			  SampleType value)
+{
+	SampleType *middle = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_insert but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Out of range.");
+	}
 
-	vec->begin = new_begin;
-	vec->end = new_begin + old_size;
-	vec->end_of_storage = new_begin + element_count;
+	if (vec->begin == NULL) {
+		static_vector_init(vec, 0);
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		static_vector_panic("Static vector is full.");
+	}
+
+	middle = vec->begin + idx;
+	VECTOR_TRACE_EVENT(static_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "StaticVector", "static_vector_insert",
+			   VECTOR_STATIC_CAPACITY(vec),
+			   VECTOR_STATIC_CAPACITY(vec),
+			   (vec->end - middle) * sizeof(SampleType));
+	memmove(middle + 1, middle, (vec->end - middle) * sizeof(SampleType));
+	vec->end++;
+	middle[0] = value;
+}
+
+int static_vector_try_insert(struct StaticVector *vec, size_t idx,
+			     SampleType value)
+{
+	SampleType *middle = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return 0;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_try_insert but non-null argument expected.");
+	}
+	static_vector_assert(vec);
+
+	if (VECTOR_CHECK(idx > VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return 0;
+		}
+		static_vector_panic("Out of range.");
+	}
+
+	if (vec->begin == NULL) {
+		static_vector_init(vec, 0);
+	}
+
+	if (vec->end == vec->end_of_storage) {
+		return 0;
+	}
+
+	middle = vec->begin + idx;
+	VECTOR_TRACE_EVENT(static_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "StaticVector", "static_vector_try_insert",
+			   VECTOR_STATIC_CAPACITY(vec),
+			   VECTOR_STATIC_CAPACITY(vec),
+			   (vec->end - middle) * sizeof(SampleType));
+	memmove(middle + 1, middle, (vec->end - middle) * sizeof(SampleType));
+	vec->end++;
+	middle[0] = value;
+
+	return 1;
 }
 
-void vector_resize(Vector *vec, size_t element_count)
+void static_vector_delete(struct StaticVector *vec, size_t idx)
 {
-	if (vec == NULL) {
+	SampleType *middle = NULL;
+
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
 			return;
 		}
-		vector_panic(
-			"Null passed to vector_resize but non-null argument expected.");
+		static_vector_panic(
+			"Null passed to static_vector_delete but non-null argument expected.");
 	}
-	vector_assert(vec);
+	static_vector_assert(vec);
 
-	if (element_count != 0
-		&& sizeof(SampleType) > ((size_t)-1) / element_count) {
-		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
 			return;
 		}
-		vector_panic("Requested capacity would cause size overflow.");
+		static_vector_panic("Out of range.");
 	}
 
-	if (vec->begin == NULL) {
-		vector_init(vec, element_count);
+	middle = vec->begin + idx;
+	VECTOR_TRACE_EVENT(static_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "StaticVector", "static_vector_delete",
+			   VECTOR_STATIC_CAPACITY(vec),
+			   VECTOR_STATIC_CAPACITY(vec),
+			   (vec->end - middle - 1) * sizeof(SampleType));
+	memmove(middle, middle + 1, (vec->end - middle - 1) * sizeof(SampleType));
+	vec->end--;
+}
+
+void static_vector_duplicate(struct StaticVector *RESTRICT dest,
+			     const struct StaticVector *RESTRICT src)
+{
+	if (VECTOR_CHECK(dest == NULL || src == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		static_vector_panic(
+			"Null passed to static_vector_duplicate but non-null argument expected.");
 	}
+	static_vector_assert(src);
 
-	if (element_count > VECTOR_CAPACITY(vec)) {
-		vector_grow(vec, element_count);
+	if (src->begin == NULL) {
+		dest->begin = NULL;
+		dest->end = NULL;
+		dest->end_of_storage = NULL;
+		return;
 	}
 
-	vec->end = vec->begin + element_count;
+	static_vector_init(dest, 0);
+	VECTOR_TRACE_EVENT(static_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "StaticVector", "static_vector_duplicate",
+			   VECTOR_STATIC_CAPACITY(src),
+			   VECTOR_STATIC_CAPACITY(src),
+			   VECTOR_SIZE(src) * sizeof(SampleType));
+	memcpy(dest->storage, src->begin, VECTOR_SIZE(src) * sizeof(SampleType));
+	dest->end = dest->begin + VECTOR_SIZE(src);
+
+	static_vector_assert(dest);
 }
 
-void vector_free(struct Vector *vec)
+void static_vector_clear(struct StaticVector *vec)
 {
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
 			return;
 		}
-		vector_panic(
-			"Null passed to vector_free but non-null argument expected.");
+		static_vector_panic(
+			"Null passed to static_vector_clear but non-null argument expected.");
 	}
+	static_vector_assert(vec);
 
-	vector_assert(vec);
+	vec->end = vec->begin;
+}
+/* Macro VECTOR_DEFINE_STATIC_BASE stop here */
+
+#define VECTOR_DEFINE_STATIC(Struct_Name_, Functions_Prefix_, Custom_Type_) \
+	VECTOR_DEFINE_TRACE(Struct_Name_, Functions_Prefix_, VECTOR_EXTERN) \
+	VECTOR_DEFINE_STATIC_BASE(Struct_Name_, Functions_Prefix_, Custom_Type_)
+
+/* Macro VECTOR_DECLARE_INCREMENTAL(Struct_Name_=IncrementalVector, Functions_Prefix_=incremental_vector, Custom_Type_=SampleType) start here */
+
+typedef struct IncrementalVector {
+	SampleType *begin;
+	SampleType *end;
+	SampleType *end_of_storage;
+	SampleType *old_begin;
+	size_t old_size;
+	size_t migrated;
+} IncrementalVector;
+
+VECTOR_NORETURN VECTOR_COLD void incremental_vector_panic(const char *message);
+void incremental_vector_assert(const IncrementalVector *vec);
+void incremental_vector_free(IncrementalVector *vec);
+void incremental_vector_init(IncrementalVector *vec, size_t element_count);
+int incremental_vector_migrate(IncrementalVector *vec);
+void incremental_vector_finish_migration(IncrementalVector *vec);
+void incremental_vector_push(IncrementalVector *vec, SampleType value);
+SampleType incremental_vector_pop(IncrementalVector *vec);
+SampleType incremental_vector_get(const IncrementalVector *vec, size_t idx);
+void incremental_vector_set(IncrementalVector *vec, size_t idx,
+			    SampleType value);
+void incremental_vector_clear(IncrementalVector *vec);
+void incremental_vector_trace_dump(FILE *stream);
+/* Macro VECTOR_DECLARE_INCREMENTAL stop here */
+
+/* Macro VECTOR_DEFINE_INCREMENTAL_BASE(Struct_Name_=IncrementalVector, Functions_Prefix_=incremental_vector, Custom_Type_=SampleType) start here */
+struct IncrementalVector;
+VECTOR_DEFINE_PANIC(incremental_vector, VECTOR_EXTERN)
+
+VECTOR_INLINE void incremental_vector_assert(
+	const struct IncrementalVector *vec)
+{
+	if (VECTOR_NO_CHECKS) {
+		return;
+	}
+
+	if (vec->begin == NULL) {
+		assert(vec->end == NULL && vec->end_of_storage == NULL);
+		assert(vec->old_begin == NULL);
+		return;
+	}
+
+	assert(vec->end && vec->end_of_storage);
+	assert(vec->begin <= vec->end && vec->end <= vec->end_of_storage);
+
+	if (vec->old_begin) {
+		assert(vec->migrated < vec->old_size);
+		assert(vec->old_size <= VECTOR_SIZE(vec));
+	}
+}
+
+/* Frees the buffer a completed or abandoned migration copied from */
+static void incremental_vector_release_old(struct IncrementalVector *vec,
+					   const char *function)
+{
+	(void)function;
+	if (vec->old_begin) {
+		VECTOR_TRACE_EVENT(incremental_vector_trace_counters,
+				   VECTOR_TRACE_FREE, "IncrementalVector",
+				   function,
+				   VECTOR_CAPACITY(vec) / VECTOR_GROWTH_FACTOR,
+				   0,
+				   VECTOR_CAPACITY(vec) / VECTOR_GROWTH_FACTOR
+					   * sizeof(SampleType));
+	}
+
+	VECTOR_FREE(vec->old_begin);
+	vec->old_begin = NULL;
+	vec->old_size = 0;
+	vec->migrated = 0;
+}
+
+void incremental_vector_free(struct IncrementalVector *vec)
+{
+	if (VECTOR_CHECK(vec == NULL)) {
+		if (VECTOR_NO_PANIC_ON_NULL) {
+			return;
+		}
+		incremental_vector_panic(
+			"Null passed to incremental_vector_free but non-null argument expected.");
+	}
+	incremental_vector_assert(vec);
 
+	incremental_vector_release_old(vec, "incremental_vector_free");
+	if (vec->begin) {
+		VECTOR_TRACE_EVENT(incremental_vector_trace_counters,
+				   VECTOR_TRACE_FREE, "IncrementalVector",
+				   "incremental_vector_free",
+				   VECTOR_CAPACITY(vec), 0,
+				   VECTOR_CAPACITY(vec) * sizeof(SampleType));
+	}
 	VECTOR_FREE(vec->begin);
 	vec->begin = NULL;
 	vec->end = NULL;
 	vec->end_of_storage = NULL;
 }
 
-void vector_init(struct Vector *vec, size_t element_count)
+void incremental_vector_init(struct IncrementalVector *vec,
+			     size_t element_count)
 {
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
 			return;
 		}
-		vector_panic(
-			"Null passed to vector_init but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_init but non-null argument expected.");
 	}
 
+	vec->old_begin = NULL;
+	vec->old_size = 0;
+	vec->migrated = 0;
+
 	if (element_count == 0) {
 		return;
 	}
 
-	if (sizeof(SampleType) > ((size_t)-1) / element_count) {
+	if (VECTOR_UNLIKELY(sizeof(SampleType)
+			    > ((size_t)-1) / element_count)) {
 		if (VECTOR_NO_PANIC_ON_OVERFLOW) {
 			return;
 		}
-		vector_panic("Requested element_count would cause size overflow.");
+		incremental_vector_panic(
+			"Requested element_count would cause size overflow.");
+	}
+
+	if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+		incremental_vector_panic("Allocation inside a no-alloc region.");
 	}
 
 	vec->begin = VECTOR_REALLOC(NULL, element_count * sizeof(SampleType));
-	if (vec->begin == NULL) {
-		vector_panic("Out of memory. Panic.");
+	if (VECTOR_UNLIKELY(vec->begin == NULL)) {
+		incremental_vector_panic("Out of memory. Panic.");
 	}
+	VECTOR_TRACE_EVENT(incremental_vector_trace_counters,
+			   VECTOR_TRACE_REALLOC, "IncrementalVector",
+			   "incremental_vector_init", 0, element_count,
+			   element_count * sizeof(SampleType));
 
 	vec->end = vec->begin;
 	vec->end_of_storage = vec->begin + element_count;
 
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 }
 
-void vector_push(struct Vector *vec, SampleType value)
+int incremental_vector_migrate(struct IncrementalVector *vec)
 {
-	if (vec == NULL) {
+	size_t count = VECTOR_INCREMENTAL_STEP_BYTES / sizeof(SampleType);
+
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
-			return;
+			return 0;
 		}
-		vector_panic(
-			"Null passed to vector_push but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_migrate but non-null argument expected.");
 	}
+	incremental_vector_assert(vec);
 
-	vector_assert(vec);
+	if (vec->old_begin == NULL) {
+		return 0;
+	}
 
-	if (vec->begin == NULL) {
-		vector_init(vec, VECTOR_DEFAULT_CAPACITY);
+	/* Always make progress, even for elements larger than a step */
+	count |= (count == 0);
+	if (count > vec->old_size - vec->migrated) {
+		count = vec->old_size - vec->migrated;
 	}
 
-	if (VECTOR_SIZE(vec) >= VECTOR_CAPACITY(vec)) {
-		vector_grow(vec, VECTOR_CAPACITY(vec) * VECTOR_GROWTH_FACTOR);
+	VECTOR_TRACE_EVENT(incremental_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "IncrementalVector", "incremental_vector_migrate",
+			   VECTOR_CAPACITY(vec), VECTOR_CAPACITY(vec),
+			   count * sizeof(SampleType));
+	memcpy(vec->begin + vec->migrated, vec->old_begin + vec->migrated,
+	       count * sizeof(SampleType));
+	vec->migrated += count;
+
+	if (vec->migrated == vec->old_size) {
+		incremental_vector_release_old(vec,
+					       "incremental_vector_migrate");
+		return 0;
 	}
 
-	vec->end[0] = value;
-	vec->end++;
+	return 1;
 }
 
-SampleType vector_pop(struct Vector *vec)
+void incremental_vector_finish_migration(struct IncrementalVector *vec)
 {
-	SampleType nothing = { 0 };
-	SampleType ret = { 0 };
-
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
-			return nothing;
+			return;
 		}
-		vector_panic(
-			"Null passed to vector_pop but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_finish_migration but non-null argument expected.");
 	}
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 
-	if (VECTOR_IS_SIZE_ZERO(vec)) {
-		vector_panic("Cannot pop from empty vector.");
+	if (vec->old_begin == NULL) {
+		return;
 	}
 
-	ret = vec->end[-1];
-	vec->end--;
-
-	return ret;
+	VECTOR_TRACE_EVENT(incremental_vector_trace_counters, VECTOR_TRACE_COPY,
+			   "IncrementalVector",
+			   "incremental_vector_finish_migration",
+			   VECTOR_CAPACITY(vec), VECTOR_CAPACITY(vec),
+			   (vec->old_size - vec->migrated)
+				   * sizeof(SampleType));
+	memcpy(vec->begin + vec->migrated, vec->old_begin + vec->migrated,
+	       (vec->old_size - vec->migrated) * sizeof(SampleType));
+	incremental_vector_release_old(vec,
+				       "incremental_vector_finish_migration");
 }
 
-SampleType vector_get(const struct Vector *vec, size_t idx)
+void incremental_vector_push(struct IncrementalVector *vec, SampleType value)
 {
-	SampleType nothing = { 0 };
+	SampleType *new_begin = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
 
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
-			return nothing;
+			return;
 		}
-		vector_panic(
-			"Null passed to vector_get but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_push but non-null argument expected.");
 	}
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 
-	if (idx >= VECTOR_SIZE(vec)) {
-		if (VECTOR_NO_PANIC_ON_OOB) {
-			return nothing;
-		}
-		vector_panic("Out of range.");
+	if (vec->begin == NULL) {
+		incremental_vector_init(vec, VECTOR_DEFAULT_CAPACITY);
 	}
 
-	return vec->begin[idx];
-}
+	if (vec->end == vec->end_of_storage) {
+		/* Only reachable mid-migration if the step could not keep up */
+		incremental_vector_finish_migration(vec);
 
-void vector_set(struct Vector *vec, size_t idx, SampleType value)
-{
-	if (vec == NULL) {
-		if (VECTOR_NO_PANIC_ON_NULL) {
-			return;
+		size = VECTOR_SIZE(vec);
+		capacity = VECTOR_CAPACITY(vec);
+		if (VECTOR_UNLIKELY(sizeof(SampleType) * VECTOR_GROWTH_FACTOR
+				    > ((size_t)-1) / capacity)) {
+			if (VECTOR_NO_PANIC_ON_OVERFLOW) {
+				return;
+			}
+			incremental_vector_panic(
+				"Requested capacity would cause size overflow.");
 		}
-		vector_panic(
-			"Null passed to vector_set but non-null argument expected.");
-	}
-	vector_assert(vec);
 
-	if (idx >= VECTOR_SIZE(vec)) {
-		if (VECTOR_NO_PANIC_ON_OOB) {
-			return;
+		if (VECTOR_IS_ALLOC_FORBIDDEN()) {
+			incremental_vector_panic(
+				"Allocation inside a no-alloc region.");
 		}
-		vector_panic("Out of range.");
+
+		new_begin = VECTOR_REALLOC(NULL, capacity * VECTOR_GROWTH_FACTOR
+						       * sizeof(SampleType));
+		if (VECTOR_UNLIKELY(new_begin == NULL)) {
+			incremental_vector_panic("Out of memory. Panic.");
+		}
+		VECTOR_TRACE_EVENT(incremental_vector_trace_counters,
+				   VECTOR_TRACE_REALLOC, "IncrementalVector",
+				   "incremental_vector_push", capacity,
+				   capacity * VECTOR_GROWTH_FACTOR,
+				   capacity * VECTOR_GROWTH_FACTOR
+					   * sizeof(SampleType));
+
+		vec->old_begin = vec->begin;
+		vec->old_size = size;
+		vec->migrated = 0;
+		vec->begin = new_begin;
+		vec->end = new_begin + size;
+		vec->end_of_storage = new_begin + capacity * VECTOR_GROWTH_FACTOR;
 	}
 
-	vec->begin[idx] = value;
+	incremental_vector_migrate(vec);
+
+	vec->end[0] = value;
+	vec->end++;
 }
 
-void vector_insert(struct Vector *vec, size_t idx, SampleType value)
+SampleType incremental_vector_pop(struct IncrementalVector *vec)
 {
-	SampleType *middle = NULL;
-	size_t delete_size = 0;
-	size_t capacity = 0;
+	SampleType nothing = { 0 };
+	SampleType ret = { 0 };
+	size_t idx = 0;
 
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
-			return;
+			return nothing;
 		}
-		vector_panic(
-			"Null passed to vector_insert but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_pop but non-null argument expected.");
 	}
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 
-	if (idx > VECTOR_SIZE(vec)) {
-		if (VECTOR_NO_PANIC_ON_OOB) {
-			return;
-		}
-		vector_panic("Out of range.");
+	if (VECTOR_CHECK(VECTOR_IS_SIZE_ZERO(vec))) {
+		incremental_vector_panic("Cannot pop from empty vector.");
 	}
 
-	capacity = VECTOR_CAPACITY(vec);
-	if (VECTOR_SIZE(vec) >= capacity) {
-		/* Set a minimum multiplicand of 1 */
-		vector_grow(vec, (capacity | (capacity == 0)) *
-					 VECTOR_GROWTH_FACTOR);
-	}
+	idx = VECTOR_SIZE(vec) - 1;
+	ret = incremental_vector_get(vec, idx);
+	vec->end--;
 
-	if (vec->begin + idx == vec->end) {
-		vec->end[0] = value;
-		vec->end++;
-		return;
+	if (vec->old_begin && idx < vec->old_size) {
+		vec->old_size = idx;
+		if (vec->old_size <= vec->migrated) {
+			incremental_vector_release_old(
+				vec, "incremental_vector_pop");
+		}
 	}
 
-	middle = vec->begin + idx;
-	delete_size = (vec->end - middle) * sizeof(SampleType);
-	memmove(middle + 1, middle, delete_size);
-	vec->end++;
-	middle[0] = value;
+	return ret;
 }
 
-void vector_delete(struct Vector *vec, size_t idx)
+SampleType incremental_vector_get(const struct IncrementalVector *vec,
+				  size_t idx)
 {
-	SampleType *middle = NULL;
-	size_t delete_size = 0;
+	SampleType nothing = { 0 };
 
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
-			return;
+			return nothing;
 		}
-		vector_panic(
-			"Null passed to vector_delete but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_get but non-null argument expected.");
 	}
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 
-	if (idx >= VECTOR_SIZE(vec)) {
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
 		if (VECTOR_NO_PANIC_ON_OOB) {
-			return;
+			return nothing;
 		}
-		vector_panic("Out of range.");
+		incremental_vector_panic("Out of range.");
 	}
 
-	/* Delete last element */
-	if (idx == VECTOR_SIZE(vec) - 1) {
-		vec->end--;
-		return;
+	if (vec->old_begin && idx >= vec->migrated && idx < vec->old_size) {
+		return vec->old_begin[idx];
 	}
 
-	middle = vec->begin + idx;
-	delete_size = (vec->end - middle - 1) * sizeof(SampleType);
-	memmove(middle, middle + 1, delete_size);
-	vec->end--;
+	return vec->begin[idx];
 }
 
-void vector_duplicate(struct Vector *RESTRICT dest,
-		      const struct Vector *RESTRICT src)
+void incremental_vector_set(struct IncrementalVector *vec, size_t idx,
+			    SampleType value)
 {
-	if (dest == NULL || src == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
 			return;
 		}
-		vector_panic(
-			"Null passed to vector_duplicate but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_set but non-null argument expected.");
 	}
-	vector_assert(src);
+	incremental_vector_assert(vec);
 
-	if (VECTOR_CAPACITY(src) == 0) {
-		dest->begin = NULL;
-		dest->end = NULL;
-		dest->end_of_storage = NULL;
-		return;
+	if (VECTOR_CHECK(idx >= VECTOR_SIZE(vec))) {
+		if (VECTOR_NO_PANIC_ON_OOB) {
+			return;
+		}
+		incremental_vector_panic("Out of range.");
 	}
 
-	dest->begin =
-		VECTOR_REALLOC(NULL, VECTOR_CAPACITY(src) * sizeof(SampleType));
-	if (dest->begin == NULL) {
-		vector_panic("Out of memory.");
+	if (vec->old_begin && idx >= vec->migrated && idx < vec->old_size) {
+		vec->old_begin[idx] = value;
+		return;
 	}
 
-	dest->end = dest->begin + VECTOR_SIZE(src);
-	dest->end_of_storage = dest->begin + VECTOR_CAPACITY(src);
-
-	memcpy(dest->begin, src->begin, VECTOR_SIZE(src) * sizeof(SampleType));
-
-	vector_assert(dest);
+	vec->begin[idx] = value;
 }
 
-void vector_clear(struct Vector *vec)
+void incremental_vector_clear(struct IncrementalVector *vec)
 {
-	if (vec == NULL) {
+	if (VECTOR_CHECK(vec == NULL)) {
 		if (VECTOR_NO_PANIC_ON_NULL) {
 			return;
 		}
-		vector_panic(
-			"Null passed to vector_clear but non-null argument expected.");
+		incremental_vector_panic(
+			"Null passed to incremental_vector_clear but non-null argument expected.");
 	}
-	vector_assert(vec);
+	incremental_vector_assert(vec);
 
+	incremental_vector_release_old(vec, "incremental_vector_clear");
 	vec->end = vec->begin;
 }
-/* Definitions stop here */
+/* Macro VECTOR_DEFINE_INCREMENTAL_BASE stop here */
+
+#define VECTOR_DEFINE_INCREMENTAL(Struct_Name_, Functions_Prefix_,            \
+				  Custom_Type_)                               \
+	VECTOR_DEFINE_TRACE(Struct_Name_, Functions_Prefix_, VECTOR_EXTERN)   \
+	VECTOR_DEFINE_INCREMENTAL_BASE(Struct_Name_, Functions_Prefix_,       \
+				       Custom_Type_)
 
 /****************************************************************************
  * Copyright (C) 2025 by Roland Marchand <roland.marchand@protonmail.com>   *